@@ -8,7 +8,10 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkTileMode.h"
 #include "tools/ToolUtils.h"
 
 class BilerpBench : public Benchmark {
@@ -53,3 +56,62 @@ DEF_BENCH( return new BilerpBench(0.99f); )
 DEF_BENCH( return new BilerpBench(0.75f); )
 DEF_BENCH( return new BilerpBench(0.50f); )
 DEF_BENCH( return new BilerpBench(0.33f); )
+
+// Filters the same 4K image through an image shader instead, so that non-clamp tiling, rotation
+// and bicubic sampling can be compared against the scaled clamp case above.
+class BilerpTileBench : public Benchmark {
+public:
+    BilerpTileBench(SkTileMode tile, float degrees, bool cubic)
+            : fTile(tile), fDegrees(degrees), fCubic(cubic) {
+        static const char* kTileNames[] = {"clamp", "repeat", "mirror", "decal"};
+        fName.printf("%s_4k_tile_%s_rotate_%g", cubic ? "bicubic" : "bilerp",
+                     kTileNames[(int)tile], degrees);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fImage = ToolUtils::create_checkerboard_image(3840, 2160, SK_ColorGRAY, SK_ColorDKGRAY, 16);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkSamplingOptions sampling = fCubic ? SkSamplingOptions(SkCubicResampler::Mitchell())
+                                            : SkSamplingOptions(SkFilterMode::kLinear);
+        // Scale down a little so that every sample lands between texels, and offset by a
+        // fraction of the image so that the non-clamp tile modes wrap at the edges.
+        SkMatrix local = SkMatrix::Scale(0.99f, 0.99f);
+        local.postTranslate(-960.5f, -540.5f);
+        local.postRotate(fDegrees);
+
+        SkPaint paint;
+        paint.setShader(fImage->makeShader(fTile, fTile, sampling, &local));
+        const SkRect dst = SkRect::MakeWH(1920, 1080);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawRect(dst, paint);
+        }
+    }
+
+private:
+    SkString fName;
+    sk_sp<SkImage> fImage;
+    SkTileMode fTile;
+    float fDegrees;
+    bool fCubic;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kClamp,   0, false); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kRepeat,  0, false); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kMirror,  0, false); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kDecal,   0, false); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kClamp,  30, false); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kRepeat, 30, false); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kMirror, 30, false); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kClamp,   0, true); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kRepeat,  0, true); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kClamp,  30, true); )
+DEF_BENCH( return new BilerpTileBench(SkTileMode::kMirror, 30, true); )
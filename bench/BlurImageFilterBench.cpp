@@ -11,8 +11,12 @@
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
 #include "include/effects/SkImageFilters.h"
+#include "src/core/SkBlurEngine.h"
 #include "src/core/SkRandom.h"
+#include "src/core/SkSpecialImage.h"
 
 #define FILTER_WIDTH_SMALL  32
 #define FILTER_HEIGHT_SMALL 32
@@ -149,6 +153,14 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, fa
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, false);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, false);)
 
+// Sigma sweep over the range where the raster blur switches to a downscaled evaluation. Compare
+// with the full resolution blur_engine_box_8888_* benches below for the cost of the exact result.
+DEF_BENCH(return new BlurImageFilterBench(25.f, 25.f, false, false, false);)
+DEF_BENCH(return new BlurImageFilterBench(50.f, 50.f, false, false, false);)
+DEF_BENCH(return new BlurImageFilterBench(100.f, 100.f, false, false, false);)
+DEF_BENCH(return new BlurImageFilterBench(150.f, 150.f, false, false, false);)
+DEF_BENCH(return new BlurImageFilterBench(200.f, 200.f, false, false, false);)
+
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, 0, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_SMALL, 0, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(0, BLUR_SIGMA_LARGE, false, true, true);)
@@ -161,3 +173,76 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+// Calls a raster blur engine's algorithm directly, to compare the separable box blur that
+// GetRasterBlurEngine() picks for large sigmas with the per-scanline passes (8888, A8) and the
+// shader blur (F16) that GetRasterScanlineBlurEngine() still uses.
+class BlurEngineBench : public Benchmark {
+public:
+    BlurEngineBench(bool box, SkColorType colorType, SkScalar sigma, SkTileMode tileMode)
+            : fEngine(box ? SkBlurEngine::GetRasterBlurEngine()
+                          : SkBlurEngine::GetRasterScanlineBlurEngine())
+            , fColorType(colorType)
+            , fSigma(sigma)
+            , fTileMode(tileMode) {
+        static const char* kTileModeNames[] = {"clamp", "repeat", "mirror", "decal"};
+        fName.printf("blur_engine_%s_%s_%.2f_%s",
+                     box ? "box" : "scanline",
+                     colorType == kAlpha_8_SkColorType ? "a8" :
+                     colorType == kRGBA_F16_SkColorType ? "f16" : "8888",
+                     sigma,
+                     kTileModeNames[(int)tileMode]);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImage> checkerboard = make_checkerboard(1024, 1024);
+        SkBitmap src;
+        src.allocPixels(SkImageInfo::Make(checkerboard->dimensions(), fColorType,
+                                          kPremul_SkAlphaType));
+        SkAssertResult(checkerboard->readPixels(nullptr, src.pixmap(), 0, 0));
+        fSrc = SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(src.dimensions()), src, {});
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkSize sigma = {fSigma, fSigma};
+        const SkBlurEngine::Algorithm* algorithm = fEngine->findAlgorithm(sigma, fColorType);
+        const SkIRect srcRect = SkIRect::MakeSize(fSrc->dimensions());
+        const SkIRect dstRect = srcRect.makeOutset(SkBlurEngine::SigmaToRadius(fSigma),
+                                                   SkBlurEngine::SigmaToRadius(fSigma));
+        for (int i = 0; i < loops; i++) {
+            algorithm->blur(sigma, fSrc, srcRect, fTileMode, dstRect);
+        }
+    }
+
+private:
+    const SkBlurEngine* fEngine;
+    SkColorType fColorType;
+    SkScalar fSigma;
+    SkTileMode fTileMode;
+    SkString fName;
+    sk_sp<SkSpecialImage> fSrc;
+};
+
+#define BLUR_ENGINE_BENCHES(colorType, sigma)                                                    \
+    DEF_BENCH(return new BlurEngineBench(true,  colorType, sigma, SkTileMode::kDecal);)          \
+    DEF_BENCH(return new BlurEngineBench(false, colorType, sigma, SkTileMode::kDecal);)
+
+BLUR_ENGINE_BENCHES(kN32_SkColorType, BLUR_SIGMA_LARGE)
+BLUR_ENGINE_BENCHES(kN32_SkColorType, BLUR_SIGMA_HUGE)
+BLUR_ENGINE_BENCHES(kN32_SkColorType, 50.f)
+BLUR_ENGINE_BENCHES(kN32_SkColorType, 130.f)
+BLUR_ENGINE_BENCHES(kAlpha_8_SkColorType, BLUR_SIGMA_LARGE)
+BLUR_ENGINE_BENCHES(kAlpha_8_SkColorType, BLUR_SIGMA_HUGE)
+// The shader blur that F16 otherwise uses only supports sigmas up to 4 without rescaling.
+BLUR_ENGINE_BENCHES(kRGBA_F16_SkColorType, 4.0f)
+
+// The per-scanline passes only support decal tiling, so only the box blur runs the others.
+DEF_BENCH(return new BlurEngineBench(true, kN32_SkColorType, BLUR_SIGMA_LARGE,
+                                     SkTileMode::kClamp);)
+DEF_BENCH(return new BlurEngineBench(true, kN32_SkColorType, BLUR_SIGMA_LARGE,
+                                     SkTileMode::kMirror);)
@@ -6,15 +6,26 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
 #include "modules/skottie/include/Skottie.h"
 #include "tools/DecodeUtils.h"
+#include "tools/ProcStats.h"
 #include "tools/Resources.h"
+#include "tools/flags/CommandLineFlags.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
+
+static DEFINE_bool(decodeMemoryStats, false,
+                   "Print how much the resident set grew in the mapped decode benches.");
+
 class DecodeBench : public Benchmark {
 protected:
     DecodeBench(const char* name, const char* source)
@@ -59,6 +70,181 @@ private:
 };
 
 
+// Produces a 1/sampleSize thumbnail of an encoded image. kBoxFilter averages pixels while
+// decoding, so (unlike kDecodeThenScale) it never allocates the full size image; compare the
+// max_rss reported by nanobench when running each variant on its own.
+class ThumbnailDecodeBench final : public DecodeBench {
+public:
+    enum class Mode {
+        kSample,
+        kBoxFilter,
+        kDecodeThenScale,
+    };
+
+    ThumbnailDecodeBench(const char* name, const char* source, int sampleSize, Mode mode)
+        : INHERITED(SkStringPrintf("thumbnail_%s_%d_%s", name, sampleSize,
+                                   mode == Mode::kSample    ? "sample" :
+                                   mode == Mode::kBoxFilter ? "box" : "full").c_str(),
+                    source)
+        , fSampleSize(sampleSize)
+        , fMode(mode)
+    {}
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            auto codec = SkAndroidCodec::MakeFromData(fData);
+            SkASSERT(codec);
+            const SkISize dims = codec->getSampledDimensions(fSampleSize);
+            const SkImageInfo info = codec->getInfo().makeDimensions(dims)
+                                                     .makeColorType(kN32_SkColorType)
+                                                     .makeAlphaType(kPremul_SkAlphaType);
+            SkBitmap thumbnail;
+            thumbnail.allocPixels(info);
+
+            if (fMode == Mode::kDecodeThenScale) {
+                SkBitmap full;
+                full.allocPixels(info.makeDimensions(codec->getInfo().dimensions()));
+                codec->getAndroidPixels(full.info(), full.getPixels(), full.rowBytes());
+                full.pixmap().scalePixels(thumbnail.pixmap(),
+                                          SkSamplingOptions(SkFilterMode::kLinear,
+                                                            SkMipmapMode::kLinear));
+                continue;
+            }
+
+            SkAndroidCodec::AndroidOptions options;
+            options.fSampleSize = fSampleSize;
+            options.fBoxFilter = fMode == Mode::kBoxFilter;
+            codec->getAndroidPixels(info, thumbnail.getPixels(), thumbnail.rowBytes(), &options);
+        }
+    }
+
+private:
+    const int  fSampleSize;
+    const Mode fMode;
+
+    using INHERITED = DecodeBench;
+};
+
+DEF_BENCH(return new ThumbnailDecodeBench("png_1600", "images/mandrill_1600.png", 5,
+                                          ThumbnailDecodeBench::Mode::kSample);)
+DEF_BENCH(return new ThumbnailDecodeBench("png_1600", "images/mandrill_1600.png", 5,
+                                          ThumbnailDecodeBench::Mode::kBoxFilter);)
+DEF_BENCH(return new ThumbnailDecodeBench("png_1600", "images/mandrill_1600.png", 5,
+                                          ThumbnailDecodeBench::Mode::kDecodeThenScale);)
+DEF_BENCH(return new ThumbnailDecodeBench("png_512", "images/mandrill_512.png", 3,
+                                          ThumbnailDecodeBench::Mode::kSample);)
+DEF_BENCH(return new ThumbnailDecodeBench("png_512", "images/mandrill_512.png", 3,
+                                          ThumbnailDecodeBench::Mode::kBoxFilter);)
+DEF_BENCH(return new ThumbnailDecodeBench("png_512", "images/mandrill_512.png", 3,
+                                          ThumbnailDecodeBench::Mode::kDecodeThenScale);)
+DEF_BENCH(return new ThumbnailDecodeBench("bmp_320", "images/32bpp-topdown-320x240.bmp", 3,
+                                          ThumbnailDecodeBench::Mode::kSample);)
+DEF_BENCH(return new ThumbnailDecodeBench("bmp_320", "images/32bpp-topdown-320x240.bmp", 3,
+                                          ThumbnailDecodeBench::Mode::kBoxFilter);)
+DEF_BENCH(return new ThumbnailDecodeBench("bmp_320", "images/32bpp-topdown-320x240.bmp", 3,
+                                          ThumbnailDecodeBench::Mode::kDecodeThenScale);)
+DEF_BENCH(return new ThumbnailDecodeBench("jpg_512", "images/mandrill_512_q075.jpg", 3,
+                                          ThumbnailDecodeBench::Mode::kSample);)
+DEF_BENCH(return new ThumbnailDecodeBench("jpg_512", "images/mandrill_512_q075.jpg", 3,
+                                          ThumbnailDecodeBench::Mode::kBoxFilter);)
+DEF_BENCH(return new ThumbnailDecodeBench("jpg_512", "images/mandrill_512_q075.jpg", 3,
+                                          ThumbnailDecodeBench::Mode::kDecodeThenScale);)
+
+// Decodes a large file either in place from its mapping (GetResourceAsData mmaps the file) or
+// through an SkFILEStream. With --decodeMemoryStats, reports how much the resident set grew while
+// the codec was alive. The destination is allocated (and touched) up front, so reading in place
+// should grow it by at most the mapped pages of the file, never by a second copy of the encoded
+// bytes.
+class MappedDecodeBench final : public DecodeBench {
+public:
+    MappedDecodeBench(const char* name, const char* source, bool mapped)
+        : INHERITED(SkStringPrintf("%s_%s", name, mapped ? "mapped" : "filestream").c_str(),
+                    source)
+        , fResource(source)
+        , fMapped(mapped)
+    {}
+
+    void onDelayedSetup() override {
+        INHERITED::onDelayedSetup();
+        auto codec = SkCodec::MakeFromData(fData);
+        SkASSERT(codec);
+        fBitmap.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+        fBitmap.eraseColor(SK_ColorTRANSPARENT);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            const int64_t before = sk_tools::getCurrResidentSetSizeBytes();
+            auto codec = fMapped ? SkCodec::MakeFromData(fData)
+                                 : SkCodec::MakeFromStream(GetResourceAsStream(fResource, true));
+            SkASSERT(codec);
+            codec->getPixels(fBitmap.pixmap());
+            fMaxGrowth = std::max(fMaxGrowth, sk_tools::getCurrResidentSetSizeBytes() - before);
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (!FLAGS_decodeMemoryStats) {
+            return;
+        }
+        SkDebugf("%s: resident set grew by up to %lldKB decoding %zuKB\n", this->getName(),
+                 (long long)(fMaxGrowth >> 10), fData->size() >> 10);
+    }
+
+private:
+    const char* fResource;
+    const bool  fMapped;
+    SkBitmap    fBitmap;
+    int64_t     fMaxGrowth = 0;
+
+    using INHERITED = DecodeBench;
+};
+
+DEF_BENCH(return new MappedDecodeBench("png_1600", "images/mandrill_1600.png", true);)
+DEF_BENCH(return new MappedDecodeBench("png_1600", "images/mandrill_1600.png", false);)
+DEF_BENCH(return new MappedDecodeBench("gif_flight", "images/flightAnim.gif", true);)
+DEF_BENCH(return new MappedDecodeBench("gif_flight", "images/flightAnim.gif", false);)
+DEF_BENCH(return new MappedDecodeBench("jpg_cmyk", "images/mandrill_cmyk.jpg", true);)
+DEF_BENCH(return new MappedDecodeBench("jpg_cmyk", "images/mandrill_cmyk.jpg", false);)
+
+// Decodes every frame of an animated image, optionally spreading independent frames (and
+// siblings that depend on the same frame) across a thread pool.
+class AllFramesDecodeBench final : public DecodeBench {
+public:
+    AllFramesDecodeBench(const char* name, const char* source, int threads)
+        : INHERITED(SkStringPrintf("all_frames_%s_%dthreads", name, threads).c_str(), source)
+        , fThreads(threads)
+    {}
+
+    void onDelayedSetup() override {
+        INHERITED::onDelayedSetup();
+        if (fThreads > 1) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            std::vector<SkBitmap> frames;
+            SkCodecs::DecodeAllFrames(fData, kN32_SkColorType, kPremul_SkAlphaType,
+                                      fExecutor.get(), &frames);
+        }
+    }
+
+private:
+    const int                   fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = DecodeBench;
+};
+
+DEF_BENCH(return new AllFramesDecodeBench("gif_alphabet", "images/alphabetAnim.gif", 1);)
+DEF_BENCH(return new AllFramesDecodeBench("gif_alphabet", "images/alphabetAnim.gif", 4);)
+DEF_BENCH(return new AllFramesDecodeBench("gif_flight", "images/flightAnim.gif", 1);)
+DEF_BENCH(return new AllFramesDecodeBench("gif_flight", "images/flightAnim.gif", 4);)
+DEF_BENCH(return new AllFramesDecodeBench("webp_required", "images/required.webp", 1);)
+DEF_BENCH(return new AllFramesDecodeBench("webp_required", "images/required.webp", 4);)
+
 class SkottieDecodeBench final : public DecodeBench {
 public:
     SkottieDecodeBench(const char* name, const char* source)
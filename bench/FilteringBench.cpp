@@ -20,6 +20,17 @@ public:
         fName.printf("samplingoptions_filter_%d_mipmap_%d", (int)fm, (int)mm);
     }
 
+    // Samples without mipmaps, with the given tile mode and an extra rotation.
+    FilteringBench(const SkSamplingOptions& sampling, SkTileMode tile, float degrees)
+            : fSampling(sampling), fTile(tile), fDegrees(degrees) {
+        if (sampling.useCubic) {
+            fName.printf("samplingoptions_cubic_%g_%g", sampling.cubic.B, sampling.cubic.C);
+        } else {
+            fName.printf("samplingoptions_filter_%d", (int)sampling.filter);
+        }
+        fName.appendf("_tile_%d_rotate_%g", (int)tile, degrees);
+    }
+
 protected:
     const char* onGetName() override {
         return fName.c_str();
@@ -31,12 +42,13 @@ protected:
         img = img->makeRasterImage(nullptr);
 
         fRect = SkRect::MakeIWH(img->width(), img->height());
-        fShader = img->makeShader(SkTileMode::kClamp, SkTileMode::kClamp, fSampling);
+        fShader = img->makeShader(fTile, fTile, fSampling);
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
         // scale so we will trigger lerping between levels if we mipmapping
         canvas->scale(0.75f, 0.75f);
+        canvas->rotate(fDegrees);
 
         SkPaint paint;
         paint.setShader(fShader);
@@ -52,6 +64,8 @@ private:
     SkRect          fRect;
     sk_sp<SkShader> fShader;
     SkSamplingOptions fSampling;
+    SkTileMode      fTile = SkTileMode::kClamp;
+    float           fDegrees = 0;
 
     using INHERITED = Benchmark;
 };
@@ -63,3 +77,18 @@ DEF_BENCH( return new FilteringBench(SkFilterMode::kLinear,  SkMipmapMode::kNone
 DEF_BENCH( return new FilteringBench(SkFilterMode::kNearest, SkMipmapMode::kLinear); )
 DEF_BENCH( return new FilteringBench(SkFilterMode::kNearest, SkMipmapMode::kNearest); )
 DEF_BENCH( return new FilteringBench(SkFilterMode::kNearest, SkMipmapMode::kNone); )
+
+DEF_BENCH( return new FilteringBench(SkSamplingOptions(SkFilterMode::kLinear),
+                                     SkTileMode::kRepeat, 0); )
+DEF_BENCH( return new FilteringBench(SkSamplingOptions(SkFilterMode::kLinear),
+                                     SkTileMode::kMirror, 0); )
+DEF_BENCH( return new FilteringBench(SkSamplingOptions(SkFilterMode::kLinear),
+                                     SkTileMode::kClamp, 15); )
+DEF_BENCH( return new FilteringBench(SkSamplingOptions(SkFilterMode::kLinear),
+                                     SkTileMode::kRepeat, 15); )
+DEF_BENCH( return new FilteringBench(SkSamplingOptions(SkCubicResampler::Mitchell()),
+                                     SkTileMode::kClamp, 0); )
+DEF_BENCH( return new FilteringBench(SkSamplingOptions(SkCubicResampler::Mitchell()),
+                                     SkTileMode::kRepeat, 15); )
+DEF_BENCH( return new FilteringBench(SkSamplingOptions(SkCubicResampler::CatmullRom()),
+                                     SkTileMode::kMirror, 15); )
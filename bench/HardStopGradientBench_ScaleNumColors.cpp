@@ -16,14 +16,17 @@
 
 #include "tools/ToolUtils.h"
 
+#include <cmath>
+
 class HardStopGradientBench_ScaleNumColors : public Benchmark {
 public:
-    HardStopGradientBench_ScaleNumColors(SkTileMode tilemode, int count) {
-        fName.printf("hardstop_scale_num_colors_%s_%03d_colors",
+    HardStopGradientBench_ScaleNumColors(SkTileMode tilemode, int count, bool smooth = false) {
+        fName.printf("%s_scale_num_colors_%s_%03d_colors", smooth ? "smooth" : "hardstop",
                      ToolUtils::tilemode_name(tilemode), count);
 
         fTileMode   = tilemode;
         fColorCount = count;
+        fSmooth     = smooth;
     }
 
     const char* onGetName() override {
@@ -62,6 +65,18 @@ public:
             colors[i] = color_choices[i % kNumColorChoices];
         }
 
+        if (fSmooth) {
+            // Follow a smooth curve instead, with evenly spaced stops and no hard stop. The
+            // raster backend can draw these from a lookup table.
+            for (int i = 0; i < fColorCount; i++) {
+                const float t = i / (fColorCount - 1.0f);
+                colors[i] = {0.5f + 0.5f * sinf(6 * t), 0.5f + 0.5f * cosf(4 * t), t, 1};
+            }
+            fPaint.setShader(SkShaders::LinearGradient(
+                    points, {{{colors, fColorCount}, fTileMode}, {}}));
+            return;
+        }
+
         // Create a hard stop
         float positions[100];
         positions[0] = 0.0f;
@@ -90,6 +105,7 @@ private:
     SkTileMode  fTileMode;
     SkString    fName;
     int         fColorCount;
+    bool        fSmooth;
     SkPaint     fPaint;
 
     using INHERITED = Benchmark;
@@ -121,3 +137,12 @@ DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror,
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror,  25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror,  50);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror, 100);)
+
+// Smooth, for comparison with the hard stop gradients above
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,   5, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,  10, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,  25, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,  50, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp, 100, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kRepeat, 25, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror, 25, true);)
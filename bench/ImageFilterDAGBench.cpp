@@ -7,10 +7,14 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkString.h"
 #include "include/effects/SkImageFilters.h"
+#include "src/core/SkImageFilterCache.h"
 #include "tools/DecodeUtils.h"
 #include "tools/Resources.h"
+#include "tools/flags/CommandLineFlags.h"
 
 #if defined(SK_GANESH)
 #include "include/gpu/ganesh/GrRecordingContext.h"
@@ -21,6 +25,11 @@
 #include "include/gpu/graphite/Image.h"
 #endif
 
+#include <memory>
+
+static DEFINE_bool(imageFilterCacheStats, false,
+                   "Print the hit rate and evictions of the image filter cache replay benches.");
+
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
 // This bench shows an improvement in performance once cacheing of re-used
 // nodes is implemented, since the DAG is no longer flattened to a tree.
@@ -119,6 +128,140 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Evaluates a DAG with independent branches and per-pixel lighting, displacement and blend stages
+// with the raster MakeWithFilter, optionally on a thread pool. The filters are rebuilt each loop so
+// that the global image filter cache does not serve the results of the previous loop.
+class ImageMakeWithFilterThreadedBench : public Benchmark {
+public:
+    explicit ImageMakeWithFilterThreadedBench(int threads) : fThreads(threads) {
+        fName.printf("image_make_with_filter_threaded_%d", threads);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fImage = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect subset = SkIRect::MakeSize(fImage->dimensions());
+        SkIRect discardSubset;
+        SkIPoint offset;
+
+        for (int j = 0; j < loops; j++) {
+            sk_sp<SkImageFilter> blur = SkImageFilters::Blur(4.0f, 4.0f, nullptr);
+            sk_sp<SkImageFilter> lit = SkImageFilters::SpotLitSpecular(
+                    {256, 256, 100}, {256, 256, 0}, 2, 30, SK_ColorWHITE, 2, 2, 8, blur);
+            sk_sp<SkImageFilter> displaced = SkImageFilters::DisplacementMap(
+                    SkColorChannel::kR, SkColorChannel::kB, 16, lit, nullptr);
+            sk_sp<SkImageFilter> eroded = SkImageFilters::Erode(3, 3, nullptr);
+            sk_sp<SkImageFilter> blended = SkImageFilters::Arithmetic(
+                    0, 0.5f, 0.5f, 0, true, displaced, eroded);
+            sk_sp<SkImageFilter> filter = SkImageFilters::Merge(
+                    blended, SkImageFilters::DistantLitDiffuse({1, 1, 1}, SK_ColorWHITE, 2, 1,
+                                                               nullptr));
+
+            SkImages::MakeWithFilter(fImage, filter.get(), subset, subset, &discardSubset, &offset,
+                                     fExecutor.get());
+        }
+    }
+
+private:
+    const int fThreads;
+    SkString fName;
+    sk_sp<SkImage> fImage;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
+// Replays the frames of an animated UI through the global image filter cache: a set of static
+// layers whose filters are reused every frame, plus one animated layer whose filter is rebuilt each
+// frame and so only inserts. The cache budget is set to 'budgetMB' for the run, which shows how
+// much the one-off results push the static ones out (see --imageFilterCacheStats).
+class ImageFilterCacheReplayBench : public Benchmark {
+public:
+    explicit ImageFilterCacheReplayBench(int budgetMB) : fBudgetMB(budgetMB) {
+        fName.printf("image_filter_cache_replay_%dMB", budgetMB);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fImage = ToolUtils::GetResourceAsImage("images/mandrill_512.png");
+        for (int i = 0; i < kStaticLayers; ++i) {
+            fStaticLayers[i] = make_layer_filter(2.f + i);
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fCache = SkImageFilterCache::Get();
+        fOriginalBudget = fCache->stats().fMaxBytes;
+        fCache->purge();
+        fCache->setMaxBytes((size_t)fBudgetMB << 20);
+        fCache->resetStats();
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (FLAGS_imageFilterCacheStats) {
+            const SkImageFilterCache::Stats stats = fCache->stats();
+            const uint64_t lookups = stats.fTotal.fHits + stats.fMisses;
+            SkDebugf("%s: %.1f%% hits, %llu evictions, %zuKB cached\n", fName.c_str(),
+                     lookups ? 100.0 * stats.fTotal.fHits / lookups : 0.0,
+                     (unsigned long long)stats.fTotal.fEvictions, stats.fTotal.fBytes >> 10);
+        }
+        fCache->setMaxBytes(fOriginalBudget);
+        fCache->purge();
+        fCache = nullptr;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect subset = SkIRect::MakeSize(fImage->dimensions());
+        SkIRect discardSubset;
+        SkIPoint offset;
+
+        for (int j = 0; j < loops; j++) {
+            for (const sk_sp<SkImageFilter>& filter : fStaticLayers) {
+                SkImages::MakeWithFilter(fImage, filter.get(), subset, subset, &discardSubset,
+                                         &offset);
+            }
+            sk_sp<SkImageFilter> animated = make_layer_filter(1.f + (j % 8));
+            SkImages::MakeWithFilter(fImage, animated.get(), subset, subset, &discardSubset,
+                                     &offset);
+            fCache->newFrame();
+        }
+    }
+
+private:
+    static constexpr int kStaticLayers = 6;
+
+    // A drop shadow and glow merged over the content, i.e. three cached results per layer.
+    static sk_sp<SkImageFilter> make_layer_filter(float sigma) {
+        sk_sp<SkImageFilter> shadow =
+                SkImageFilters::DropShadow(4, 4, sigma, sigma, SK_ColorBLACK, nullptr);
+        sk_sp<SkImageFilter> glow = SkImageFilters::Blur(sigma * 2, sigma * 2, nullptr);
+        return SkImageFilters::Merge(std::move(glow), std::move(shadow));
+    }
+
+    const int fBudgetMB;
+    SkString fName;
+    sk_sp<SkImage> fImage;
+    sk_sp<SkImageFilter> fStaticLayers[kStaticLayers];
+    sk_sp<SkImageFilterCache> fCache;
+    size_t fOriginalBudget = 0;
+
+    using INHERITED = Benchmark;
+};
+
 // Exercise a blur filter connected to both inputs of an SkDisplacementMapEffect.
 
 class ImageFilterDisplacedBlur : public Benchmark {
@@ -182,5 +325,12 @@ private:
 
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
+DEF_BENCH(return new ImageMakeWithFilterThreadedBench(0);)
+DEF_BENCH(return new ImageMakeWithFilterThreadedBench(2);)
+DEF_BENCH(return new ImageMakeWithFilterThreadedBench(4);)
+DEF_BENCH(return new ImageMakeWithFilterThreadedBench(8);)
+DEF_BENCH(return new ImageFilterCacheReplayBench(8);)
+DEF_BENCH(return new ImageFilterCacheReplayBench(32);)
+DEF_BENCH(return new ImageFilterCacheReplayBench(128);)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
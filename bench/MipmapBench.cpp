@@ -8,22 +8,31 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkRect.h"
 #include "src/core/SkMipmap.h"
 
+#include <memory>
+
 class MipmapBench: public Benchmark {
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, bool halfFloat = false, int threads = 0)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fThreads(threads)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (threads > 0) {
+            fName.appendf("_threads_%d", threads);
+        }
     }
 
 protected:
@@ -39,11 +48,14 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            SkMipmap::Build(fBitmap, nullptr, fExecutor.get())->unref();
         }
     }
 
@@ -66,3 +78,57 @@ DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// 8k images, built on the calling thread and in bands of rows on a thread pool.
+DEF_BENCH( return new MipmapBench(8192, 8192); )
+DEF_BENCH( return new MipmapBench(8192, 8192, false, 4); )
+DEF_BENCH( return new MipmapBench(8192, 8192, false, 8); )
+DEF_BENCH( return new MipmapBench(8191, 8191); )
+DEF_BENCH( return new MipmapBench(8191, 8191, false, 8); )
+DEF_BENCH( return new MipmapBench(8192, 4096, true); )
+DEF_BENCH( return new MipmapBench(8192, 4096, true, 8); )
+
+// Updates the levels of a large atlas after one tile of it changes, as a map viewer streaming in
+// tiles would. Compare with mipmap_build_8192x8192, the cost of rebuilding from scratch.
+class MipmapUpdateBench : public Benchmark {
+    SkBitmap fBitmap;
+    sk_sp<SkMipmap> fMipmap;
+    SkString fName;
+    const int fSize, fTile;
+
+public:
+    MipmapUpdateBench(int size, int tile) : fSize(size), fTile(tile) {
+        fName.printf("mipmap_update_%dx%d_tile_%d", size, size, tile);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return Backend::kNonRendering == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(fSize, fSize);
+        fBitmap.eraseColor(SK_ColorWHITE);
+        fMipmap.reset(SkMipmap::Build(fBitmap, nullptr));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const int tilesPerRow = fSize / fTile;
+        for (int i = 0; i < loops; i++) {
+            // Walk the tiles, offset by a pixel so the footprint straddles tile boundaries.
+            const int tile = i % (tilesPerRow * tilesPerRow);
+            const SkIRect dirty = SkIRect::MakeXYWH((tile % tilesPerRow) * fTile + 1,
+                                                    (tile / tilesPerRow) * fTile + 1,
+                                                    fTile, fTile);
+            fMipmap->rebuildRegion(fBitmap.pixmap(), dirty);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new MipmapUpdateBench(8192, 256); )
+DEF_BENCH( return new MipmapUpdateBench(8192, 1024); )
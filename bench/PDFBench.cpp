@@ -6,15 +6,23 @@
  */
 
 #include "bench/Benchmark.h"
+#include "gm/gm.h"
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathBuilder.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
+#include "include/docs/SkPDFDocument.h"
 #include "include/docs/SkPDFJpegHelpers.h"
 #include "include/effects/SkGradient.h"
 #include "include/private/SkTo.h"
@@ -23,9 +31,19 @@
 #include "src/pdf/SkPDFUnion.h"
 #include "src/utils/SkFloatToDecimal.h"
 #include "tools/DecodeUtils.h"
+#include "tools/ProcStats.h"
 #include "tools/Resources.h"
+#include "tools/flags/CommandLineFlags.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+static DEFINE_bool(pdfStats, false,
+                   "Print the memory growth and output size measured by some PDF benches.");
+
 namespace {
 struct WStreamWriteTextBenchmark : public Benchmark {
     std::unique_ptr<SkWStream> fWStream;
@@ -159,6 +177,49 @@ private:
     sk_sp<SkImage> fImage;
 };
 
+// Draws a JPEG that SkPDF can embed as is, compared against re-encoding it, which is what
+// happens without a JPEG decoder to inspect it with.
+class PDFJpegPassThroughBench : public Benchmark {
+public:
+    PDFJpegPassThroughBench(const char* name, const char* resource, SkRect src, bool passThrough)
+            : fResource(resource), fSrc(src), fPassThrough(passThrough) {
+        fName.printf("PDFJpegPassThrough_%s%s", name, passThrough ? "" : "_reencode");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override { fEncoded = GetResourceAsData(fResource); }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fEncoded) {
+            return;
+        }
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.jpegDecoder = fPassThrough ? SkPDF::JPEG::Decode : nullptr;
+            metadata.jpegEncoder = SkPDF::JPEG::Encode;
+            metadata.fEncodingQuality = 90;
+            sk_sp<SkDocument> doc = SkPDF::MakeDocument(&wStream, metadata);
+            sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(fEncoded);
+            SkRect src = fSrc.isEmpty() ? SkRect::Make(image->bounds()) : fSrc;
+            doc->beginPage(612, 792)->drawImageRect(image, src, SkRect::MakeWH(512, 512),
+                                                    SkSamplingOptions(), nullptr,
+                                                    SkCanvas::kFast_SrcRectConstraint);
+            doc->close();
+        }
+    }
+
+private:
+    const char* fResource;
+    const SkRect fSrc;
+    const bool fPassThrough;
+    SkString fName;
+    sk_sp<SkData> fEncoded;
+};
+
 /** Test calling DEFLATE on a 78k PDF command stream. Used for measuring
     alternate zlib settings, usage, and library versions. */
 class PDFCompressionBench : public Benchmark {
@@ -307,14 +368,298 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+// Each page draws a block of text, which SkPDF::DrawPictures draws and compresses for several
+// pages at once, and its own lazily decoded image, which it still writes one page at a time.
+class PDFDrawPicturesBench : public Benchmark {
+public:
+    explicit PDFDrawPicturesBench(int threads) : fThreads(threads) {
+        fName.printf("PDFDrawPictures_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        sk_sp<SkData> encoded = GetResourceAsData("images/color_wheel.png");
+        if (!encoded) {
+            return;
+        }
+        SkFont font = ToolUtils::DefaultFont();
+        for (int page = 0; page < 16; ++page) {
+            SkPictureRecorder recorder;
+            SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(612, 792));
+            // A new image per page, so that each is serialized and decoded separately.
+            canvas->drawImage(SkImages::DeferredFromEncodedData(encoded), 36, 36);
+            for (int line = 0; line < 40; ++line) {
+                SkString text = SkStringPrintf("Page %d, line %d: the quick brown fox", page, line);
+                canvas->drawString(text, 36, 320 + 11.0f * line, font, SkPaint());
+            }
+            fPictures.push_back(recorder.finishRecordingAsPicture());
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            // Start every document with cold caches, as a new batch job would.
+            SkGraphics::PurgeResourceCache();
+            SkGraphics::PurgeFontCache();
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.jpegDecoder = SkPDF::JPEG::Decode;
+            metadata.jpegEncoder = SkPDF::JPEG::Encode;
+            sk_sp<SkDocument> doc = SkPDF::MakeDocument(&wStream, metadata);
+            SkPDF::DrawPictures(doc.get(), fPictures, fExecutor.get());
+            doc->close();
+        }
+    }
+
+private:
+    const int fThreads;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::vector<sk_sp<SkPicture>> fPictures;
+};
+
+// A long text-only document, as statement runs produce. With --pdfStats, reports how much the
+// resident set grows while writing it, which should stay flat in low memory mode.
+class PDFLongDocBench : public Benchmark {
+public:
+    explicit PDFLongDocBench(bool lowMemory) : fLowMemory(lowMemory) {}
+
+protected:
+    const char* onGetName() override {
+        return fLowMemory ? "PDFLongDoc_lowMemory" : "PDFLongDoc";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkFont font = ToolUtils::DefaultFont();
+        while (loops-- > 0) {
+            const int64_t before = sk_tools::getCurrResidentSetSizeBytes();
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.jpegDecoder = SkPDF::JPEG::Decode;
+            metadata.jpegEncoder = SkPDF::JPEG::Encode;
+            metadata.fLowMemory = fLowMemory;
+            sk_sp<SkDocument> doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (int page = 0; page < 2000; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                for (int line = 0; line < 10; ++line) {
+                    SkString text = SkStringPrintf("Account %d, entry %d: 0.00", page, line);
+                    canvas->drawString(text, 36, 36 + 14.0f * line, font, SkPaint());
+                }
+                doc->endPage();
+            }
+            fMaxGrowth = std::max(fMaxGrowth, sk_tools::getCurrResidentSetSizeBytes() - before);
+            doc->close();
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (!FLAGS_pdfStats) {
+            return;
+        }
+        SkDebugf("%s: resident set grew by up to %lldKB\n", this->getName(),
+                 (long long)(fMaxGrowth >> 10));
+    }
+
+private:
+    const bool fLowMemory;
+    int64_t fMaxGrowth = 0;
+};
+
+// The per-document cost of embedding the same fonts and glyphs a batch service sees over and
+// over, with and without sharing subsets between documents.
+class PDFFontEmbeddingBench : public Benchmark {
+public:
+    explicit PDFFontEmbeddingBench(bool cache) : fCache(cache) {}
+
+protected:
+    const char* onGetName() override {
+        return fCache ? "PDFFontEmbedding_cached" : "PDFFontEmbedding";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        for (const char* resource : {"fonts/Roboto-Regular.ttf", "fonts/DejaVuSans.subset.ttf"}) {
+            if (sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource(resource)) {
+                fFonts.push_back(SkFont(std::move(typeface), 12));
+            }
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.jpegDecoder = SkPDF::JPEG::Decode;
+            metadata.jpegEncoder = SkPDF::JPEG::Encode;
+            metadata.fCacheFontSubsets = fCache;
+            sk_sp<SkDocument> doc = SkPDF::MakeDocument(&wStream, metadata);
+            SkCanvas* canvas = doc->beginPage(612, 792);
+            float y = 36;
+            for (const SkFont& font : fFonts) {
+                canvas->drawString("Statement of account: 0123456789", 36, y, font, SkPaint());
+                y += 24;
+            }
+            doc->close();
+        }
+    }
+
+private:
+    const bool fCache;
+    std::vector<SkFont> fFonts;
+};
+
+// A templating layer that reloads the same logo on every page, with and without content-based
+// image de-duplication. With --pdfStats, reports the size of the output.
+class PDFImageContentDedupBench : public Benchmark {
+public:
+    explicit PDFImageContentDedupBench(bool dedup) : fDedup(dedup) {}
+
+protected:
+    const char* onGetName() override {
+        return fDedup ? "PDFImageContentDedup" : "PDFImageContentDedup_off";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override { fEncoded = GetResourceAsData("images/mandrill_128.png"); }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fEncoded) {
+            return;
+        }
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.jpegDecoder = SkPDF::JPEG::Decode;
+            metadata.jpegEncoder = SkPDF::JPEG::Encode;
+            metadata.fDeduplicateImageContent = fDedup;
+            sk_sp<SkDocument> doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (int i = 0; i < 20; ++i) {
+                doc->beginPage(612, 792)->drawImage(SkImages::DeferredFromEncodedData(fEncoded),
+                                                    36, 36);
+                doc->endPage();
+            }
+            doc->close();
+            fBytes = wStream.bytesWritten();
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (!FLAGS_pdfStats) {
+            return;
+        }
+        SkDebugf("%s: %zu bytes\n", this->getName(), fBytes);
+    }
+
+private:
+    const bool fDedup;
+    sk_sp<SkData> fEncoded;
+    size_t fBytes = 0;
+};
+
+// Compresses a document made of the first GMs at different per-stream compression levels. With
+// --pdfStats, reports output size alongside time so the size/speed trade-off can be compared.
+class PDFDeflateGMBench : public Benchmark {
+public:
+    using Level = SkPDF::Metadata::CompressionLevel;
+
+    PDFDeflateGMBench(const char* name, Level content, Level font, Level image)
+            : fContent(content), fFont(font), fImage(image) {
+        fName.printf("PDFDeflateGM_%s", name);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        constexpr size_t kMaxGMs = 64;
+        for (const skiagm::GMFactory& factory : skiagm::GMRegistry::Range()) {
+            if (fPictures.size() == kMaxGMs) {
+                break;
+            }
+            std::unique_ptr<skiagm::GM> gm = factory();
+            const SkISize size = gm->getISize();
+            SkPictureRecorder recorder;
+            gm->draw(recorder.beginRecording(SkRect::Make(size)));
+            fPictures.push_back(recorder.finishRecordingAsPicture());
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.jpegDecoder = SkPDF::JPEG::Decode;
+            metadata.jpegEncoder = SkPDF::JPEG::Encode;
+            metadata.fContentCompressionLevel = fContent;
+            metadata.fFontCompressionLevel = fFont;
+            metadata.fImageCompressionLevel = fImage;
+            sk_sp<SkDocument> doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (const sk_sp<SkPicture>& picture : fPictures) {
+                const SkRect cull = picture->cullRect();
+                doc->beginPage(cull.width(), cull.height())->drawPicture(picture);
+                doc->endPage();
+            }
+            doc->close();
+            fBytes = wStream.bytesWritten();
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (!FLAGS_pdfStats) {
+            return;
+        }
+        SkDebugf("%s: %zu pages, %zu bytes\n", fName.c_str(), fPictures.size(), fBytes);
+    }
+
+private:
+    SkString fName;
+    const Level fContent, fFont, fImage;
+    std::vector<sk_sp<SkPicture>> fPictures;
+    size_t fBytes = 0;
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
+DEF_BENCH(return new PDFJpegPassThroughBench("cmyk", "images/CMYK.jpg", SkRect(), true);)
+DEF_BENCH(return new PDFJpegPassThroughBench("cmyk", "images/CMYK.jpg", SkRect(), false);)
+DEF_BENCH(return new PDFJpegPassThroughBench("oriented", "images/orientation/6_420.jpg",
+                                             SkRect(), true);)
+DEF_BENCH(return new PDFJpegPassThroughBench("oriented", "images/orientation/6_420.jpg",
+                                             SkRect(), false);)
+DEF_BENCH(return new PDFJpegPassThroughBench("subset", "images/mandrill_512_q075.jpg",
+                                             SkRect::MakeLTRB(0, 0, 512, 384), true);)
+DEF_BENCH(return new PDFJpegPassThroughBench("subset", "images/mandrill_512_q075.jpg",
+                                             SkRect::MakeLTRB(0, 0, 512, 384), false);)
 DEF_BENCH(return new PDFCompressionBench;)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFDrawPicturesBench(0);)
+DEF_BENCH(return new PDFDrawPicturesBench(2);)
+DEF_BENCH(return new PDFDrawPicturesBench(4);)
+DEF_BENCH(return new PDFLongDocBench(false);)
+DEF_BENCH(return new PDFLongDocBench(true);)
+DEF_BENCH(return new PDFFontEmbeddingBench(false);)
+DEF_BENCH(return new PDFFontEmbeddingBench(true);)
+DEF_BENCH(return new PDFImageContentDedupBench(false);)
+DEF_BENCH(return new PDFImageContentDedupBench(true);)
+DEF_BENCH(return new PDFDeflateGMBench("default", PDFDeflateGMBench::Level::Default,
+                                       PDFDeflateGMBench::Level::Default,
+                                       PDFDeflateGMBench::Level::Default);)
+DEF_BENCH(return new PDFDeflateGMBench("fastContent", PDFDeflateGMBench::Level::LowButFast,
+                                       PDFDeflateGMBench::Level::HighButSlow,
+                                       PDFDeflateGMBench::Level::HighButSlow);)
+DEF_BENCH(return new PDFDeflateGMBench("fast", PDFDeflateGMBench::Level::LowButFast,
+                                       PDFDeflateGMBench::Level::LowButFast,
+                                       PDFDeflateGMBench::Level::LowButFast);)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
@@ -6,10 +6,30 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPathBuilder.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkString.h"
+#include "src/core/SkRandom.h"
+#include "tools/ProcStats.h"
+#include "tools/Resources.h"
+#include "tools/flags/CommandLineFlags.h"
+#include "tools/fonts/FontToolUtils.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+static DEFINE_bool(pictureLoadStats, false,
+                   "Print the serialized size and memory growth of the picture load benches.");
 
 class ClipOverheadRecordingBench : public Benchmark {
 public:
@@ -41,3 +61,108 @@ private:
     }
 };
 DEF_BENCH( return new ClipOverheadRecordingBench; )
+
+// Loading a large serialized picture per request, as a tile server does, either by copying and
+// re-recording it (MakeFromData), by playing it back in place (MakeFromMappedData), or by only
+// decoding the chunks a tile needs (serializeChunked). With drawTile, this is the time to the
+// first tile. With --pictureLoadStats, reports how much the resident set grows while a loaded
+// picture is alive.
+class PictureLoadBench : public Benchmark {
+public:
+    enum class Format { kCopy, kMapped, kChunked };
+
+    PictureLoadBench(Format format, bool drawTile) : fFormat(format), fDrawTile(drawTile) {
+        static constexpr const char* kNames[] = {"copy", "mapped", "chunked"};
+        fName.printf("picture_load%s_%s", fDrawTile ? "_draw_tile" : "",
+                     kNames[static_cast<int>(fFormat)]);
+    }
+
+private:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        std::vector<sk_sp<SkImage>> images;
+        for (const char* resource : {"images/mandrill_512_q075.jpg", "images/color_wheel.png",
+                                     "images/example_1.png", "images/brickwork-texture.jpg"}) {
+            if (auto image = SkImages::DeferredFromEncodedData(GetResourceAsData(resource))) {
+                images.push_back(std::move(image));
+            }
+        }
+
+        // A 2048x2048 page of 64x64 cells, each with some geometry, text and an image.
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording({0, 0, 2048, 2048});
+        SkFont font = ToolUtils::DefaultPortableFont();
+        SkRandom random;
+        for (int y = 0; y < 2048; y += 64) {
+            for (int x = 0; x < 2048; x += 64) {
+                SkPaint paint(SkColor4f::FromColor(random.nextU() | 0xff000000));
+                canvas->save();
+                canvas->translate(x, y);
+                canvas->clipRect({0, 0, 64, 64});
+                canvas->drawRRect(SkRRect::MakeRectXY({2, 2, 62, 62}, 8, 8), paint);
+                SkPath path = SkPathBuilder().moveTo(4, 60)
+                                             .quadTo(random.nextRangeF(0, 64), 0, 60, 60)
+                                             .detach();
+                paint.setStyle(SkPaint::kStroke_Style);
+                canvas->drawPath(path, paint);
+                canvas->drawString(SkStringPrintf("%d,%d", x, y), 4, 16, font, SkPaint());
+                if (!images.empty()) {
+                    canvas->drawImageRect(images[random.nextULessThan(images.size())],
+                                          {16, 16, 48, 48}, SkSamplingOptions());
+                }
+                canvas->restore();
+            }
+        }
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+        switch (fFormat) {
+            case Format::kCopy:    fData = picture->serialize();            break;
+            case Format::kMapped:  fData = picture->serializeForMapping();  break;
+            case Format::kChunked: fData = picture->serializeChunked(256);  break;
+        }
+
+        fProcs.fImageDataProc = [](sk_sp<SkData> data, std::optional<SkAlphaType>, void*) {
+            return SkImages::DeferredFromEncodedData(std::move(data));
+        };
+        fTile.allocN32Pixels(256, 256);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int loop = 0; loop < loops; loop++) {
+            const int64_t before = sk_tools::getCurrResidentSetSizeBytes();
+            sk_sp<SkPicture> picture = fFormat == Format::kCopy
+                                               ? SkPicture::MakeFromData(fData.get(), &fProcs)
+                                               : SkPicture::MakeFromMappedData(fData, &fProcs);
+            SkASSERT_RELEASE(picture);
+            if (fDrawTile) {
+                SkCanvas canvas(fTile);
+                canvas.translate(-768, -768);
+                canvas.drawPicture(picture);
+            }
+            fMaxGrowth = std::max(fMaxGrowth, sk_tools::getCurrResidentSetSizeBytes() - before);
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (!FLAGS_pictureLoadStats) {
+            return;
+        }
+        SkDebugf("%s: %zuKB serialized, resident set grew by up to %lldKB\n", this->getName(),
+                 fData->size() >> 10, (long long)(fMaxGrowth >> 10));
+    }
+
+    const Format    fFormat;
+    const bool      fDrawTile;
+    SkString        fName;
+    sk_sp<SkData>   fData;
+    SkDeserialProcs fProcs;
+    SkBitmap        fTile;
+    int64_t         fMaxGrowth = 0;
+};
+DEF_BENCH( return new PictureLoadBench(PictureLoadBench::Format::kCopy,    false); )
+DEF_BENCH( return new PictureLoadBench(PictureLoadBench::Format::kMapped,  false); )
+DEF_BENCH( return new PictureLoadBench(PictureLoadBench::Format::kChunked, false); )
+DEF_BENCH( return new PictureLoadBench(PictureLoadBench::Format::kCopy,    true); )
+DEF_BENCH( return new PictureLoadBench(PictureLoadBench::Format::kMapped,  true); )
+DEF_BENCH( return new PictureLoadBench(PictureLoadBench::Format::kChunked, true); )
@@ -10,13 +10,21 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkString.h"
 #include "src/core/SkRandom.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordCanvas.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "tools/ToolUtils.h"
 
 // This is designed to emulate about 4 screens of textual content
 
@@ -98,3 +106,86 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Compares the default SkRecordOptimize() passes to the extended ones on a frame shaped like a UI:
+// stale content under a full-screen clear, then rows of image tiles under nested clips.
+// The _recording variants measure recording plus optimizing, the _playback variants drawing.
+class RecordOptsBench : public Benchmark {
+public:
+    enum class Passes { kDefault, kExtended };
+    enum class Phase  { kRecording, kPlayback };
+
+    RecordOptsBench(Passes passes, Phase phase) : fPasses(passes), fPhase(phase) {
+        fName.printf("record_opts_%s_%s",
+                     fPasses == Passes::kDefault ? "default" : "extended",
+                     fPhase  == Phase::kRecording ? "recording" : "playback");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkISize onGetSize() override { return SkISize::Make(1024, 1024); }
+
+    void onDelayedSetup() override {
+        fTile = ToolUtils::create_checkerboard_image(64, 64, SK_ColorWHITE, SK_ColorGRAY, 8);
+        fRecord = std::make_unique<SkRecord>();
+        this->record(fRecord.get());
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            if (fPhase == Phase::kRecording) {
+                SkRecord record;
+                this->record(&record);
+            } else {
+                SkRecordDraw(*fRecord, canvas, nullptr, nullptr, 0, nullptr, nullptr);
+            }
+        }
+    }
+
+private:
+    void record(SkRecord* record) const {
+        SkRecordCanvas canvas(record, 1024, 1024);
+
+        SkRandom rand;
+        for (int i = 0; i < 1000; i++) {
+            SkPaint paint;
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas.drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 1024),
+                                             rand.nextRangeScalar(0, 1024), 64, 64), paint);
+        }
+        canvas.drawColor(SK_ColorWHITE);
+
+        const SkSamplingOptions sampling(SkFilterMode::kLinear);
+        for (int y = 0; y < 16; y++) {
+            canvas.save();
+            canvas.clipRect(SkRect::MakeWH(1024, 1024));
+            canvas.clipRect(SkRect::MakeXYWH(0, y * 64, 1024, 64));
+            canvas.translate(0, y * 64);
+            canvas.setMatrix(SkMatrix::Translate(0, y * 64));
+            for (int x = 0; x < 16; x++) {
+                canvas.drawImageRect(fTile, SkRect::MakeWH(64, 64),
+                                     SkRect::MakeXYWH(x * 64, 0, 64, 64), sampling, nullptr,
+                                     SkCanvas::kFast_SrcRectConstraint);
+            }
+            canvas.restore();
+        }
+
+        SkRecordOptimize(record, fPasses == Passes::kDefault
+                                         ? SkRecordDefaultOptimizationPasses()
+                                         : SkRecordExtendedOptimizationPasses());
+    }
+
+    Passes                    fPasses;
+    Phase                     fPhase;
+    SkString                  fName;
+    sk_sp<SkImage>            fTile;
+    std::unique_ptr<SkRecord> fRecord;
+};
+
+DEF_BENCH( return new RecordOptsBench(RecordOptsBench::Passes::kDefault,
+                                      RecordOptsBench::Phase::kRecording); )
+DEF_BENCH( return new RecordOptsBench(RecordOptsBench::Passes::kExtended,
+                                      RecordOptsBench::Phase::kRecording); )
+DEF_BENCH( return new RecordOptsBench(RecordOptsBench::Passes::kDefault,
+                                      RecordOptsBench::Phase::kPlayback); )
+DEF_BENCH( return new RecordOptsBench(RecordOptsBench::Passes::kExtended,
+                                      RecordOptsBench::Phase::kPlayback); )
@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkString.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkRTree.h"
@@ -18,15 +19,34 @@ using namespace skia_private;
 static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
+// Roughly the op count of the largest SKPs we see.
+static const int NUM_LARGE_RECTS = 500000;
 static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+static void append_variant(SkString* name, SkRTree::BulkLoad bulkLoad, int numRects,
+                           int defaultNumRects) {
+    switch (bulkLoad) {
+        case SkRTree::BulkLoad::kInsertionOrder:                         break;
+        case SkRTree::BulkLoad::kSTR:            name->append("_str");     break;
+        case SkRTree::BulkLoad::kHilbert:        name->append("_hilbert"); break;
+    }
+    if (numRects != defaultNumRects) {
+        name->appendf("_%dk", numRects / 1000);
+    }
+}
+
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* name, MakeRectProc proc,
+                    SkRTree::BulkLoad bulkLoad = SkRTree::BulkLoad::kInsertionOrder,
+                    int numRects = NUM_BUILD_RECTS)
+            : fProc(proc), fBulkLoad(bulkLoad), fNumRects(numRects) {
+        fName.printf("rtree_%s", name);
+        append_variant(&fName, fBulkLoad, fNumRects, NUM_BUILD_RECTS);
+        fName.append("_build");
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -39,27 +59,37 @@ protected:
     }
     void onDraw(int loops, SkCanvas* canvas) override {
         SkRandom rand;
-        AutoTArray<SkRect> rects(NUM_BUILD_RECTS);
-        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        AutoTArray<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.data(), NUM_BUILD_RECTS);
+            SkRTree tree(fBulkLoad);
+            tree.insert(rects.data(), fNumRects);
         }
     }
 private:
     MakeRectProc fProc;
+    SkRTree::BulkLoad fBulkLoad;
+    int fNumRects;
     SkString fName;
     using INHERITED = Benchmark;
 };
 
-// Time how long it takes to perform queries on an R-Tree.
+// Time how long it takes to perform queries on an R-Tree, collecting the hits either into a new
+// std::vector or into a reused span.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    enum class Results { kVector, kSpan };
+
+    RTreeQueryBench(const char* name, MakeRectProc proc,
+                    SkRTree::BulkLoad bulkLoad = SkRTree::BulkLoad::kInsertionOrder,
+                    int numRects = NUM_QUERY_RECTS, Results results = Results::kVector)
+            : fTree(bulkLoad), fProc(proc), fNumRects(numRects), fResults(results) {
+        fName.printf("rtree_%s", name);
+        append_variant(&fName, bulkLoad, fNumRects, NUM_QUERY_RECTS);
+        fName.append(fResults == Results::kSpan ? "_query_span" : "_query");
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -71,28 +101,36 @@ protected:
     }
     void onDelayedSetup() override {
         SkRandom rand;
-        AutoTArray<SkRect> rects(NUM_QUERY_RECTS);
-        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        AutoTArray<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
-        fTree.insert(rects.data(), NUM_QUERY_RECTS);
+        fTree.insert(rects.data(), fNumRects);
+        fHits.reset(fNumRects);
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
         SkRandom rand;
         for (int i = 0; i < loops; ++i) {
-            std::vector<int> hits;
             SkRect query;
             query.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
             query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
             query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
             query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
-            fTree.search(query, &hits);
+            if (fResults == Results::kSpan) {
+                fTree.search(query, SkSpan(fHits.data(), fNumRects));
+            } else {
+                std::vector<int> hits;
+                fTree.search(query, &hits);
+            }
         }
     }
 private:
     SkRTree fTree;
     MakeRectProc fProc;
+    int fNumRects;
+    Results fResults;
+    AutoTArray<int> fHits;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -138,3 +176,26 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects))
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects))
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects))
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects))
+
+DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects, SkRTree::BulkLoad::kSTR))
+DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects, SkRTree::BulkLoad::kHilbert))
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, SkRTree::BulkLoad::kSTR))
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, SkRTree::BulkLoad::kHilbert))
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects,
+                                     SkRTree::BulkLoad::kInsertionOrder, NUM_QUERY_RECTS,
+                                     RTreeQueryBench::Results::kSpan))
+
+// Large, as in an SKP with hundreds of thousands of ops.
+#define LARGE_RTREE_BENCHES(bulkLoad)                                                            \
+    DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects, bulkLoad,                 \
+                                         NUM_LARGE_RECTS))                                       \
+    DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects, bulkLoad,                \
+                                         NUM_LARGE_RECTS))                                       \
+    DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects, bulkLoad,                 \
+                                         NUM_LARGE_RECTS, RTreeQueryBench::Results::kSpan))      \
+    DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, bulkLoad,                \
+                                         NUM_LARGE_RECTS, RTreeQueryBench::Results::kSpan))
+
+LARGE_RTREE_BENCHES(SkRTree::BulkLoad::kInsertionOrder)
+LARGE_RTREE_BENCHES(SkRTree::BulkLoad::kSTR)
+LARGE_RTREE_BENCHES(SkRTree::BulkLoad::kHilbert)
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTileMode.h"
+#include "src/core/SkRandom.h"
+#include "src/core/SkResampler.h"
+
+#include <memory>
+
+// Downscales a large photo-sized bitmap to a thumbnail.
+class ScalePixelsBench : public Benchmark {
+public:
+    enum class Path {
+        kResampler,  // SkResampler::Scale(), which is what scalePixels() does for these.
+        kShader,     // Draws through the raster pipeline, as scalePixels() used to.
+    };
+
+    ScalePixelsBench(const char* filterName, SkResampler::Kernel kernel,
+                     Path path = Path::kResampler, int threads = 0)
+        : fKernel(kernel), fPath(path), fThreads(threads) {
+        fName.printf("scalepixels_6000x4000_to_1200x800_%s", filterName);
+        if (path == Path::kShader) {
+            fName.append("_shader");
+        }
+        if (threads > 0) {
+            fName.appendf("_threads_%d", threads);
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return Backend::kNonRendering == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc.allocN32Pixels(6000, 4000, true);
+        SkRandom rand;
+        for (int y = 0; y < fSrc.height(); ++y) {
+            for (int x = 0; x < fSrc.width(); ++x) {
+                *fSrc.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+            }
+        }
+        fSrc.setImmutable();
+        fDst.allocPixels(fSrc.info().makeWH(1200, 800));
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fPath == Path::kResampler) {
+                SkResampler::Scale(fDst.pixmap(), fSrc.pixmap(), fKernel, fExecutor.get());
+                continue;
+            }
+            const SkSamplingOptions sampling =
+                    fKernel.fFilter == SkResampler::Filter::kCubic
+                            ? SkSamplingOptions(fKernel.fCubic)
+                            : SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kLinear);
+            SkPaint paint;
+            paint.setBlendMode(SkBlendMode::kSrc);
+            paint.setShader(fSrc.makeShader(SkTileMode::kClamp, SkTileMode::kClamp, sampling,
+                                            SkMatrix::Scale(0.2f, 0.2f)));
+            SkCanvas(fDst).drawPaint(paint);
+        }
+    }
+
+private:
+    SkBitmap fSrc, fDst;
+    SkString fName;
+    const SkResampler::Kernel fKernel;
+    const Path fPath;
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
+using Filter = SkResampler::Filter;
+using Path = ScalePixelsBench::Path;
+
+DEF_BENCH( return new ScalePixelsBench("box", {Filter::kBox}); )
+DEF_BENCH( return new ScalePixelsBench("box", {Filter::kBox}, Path::kResampler, 8); )
+DEF_BENCH( return new ScalePixelsBench("triangle", {Filter::kTriangle}); )
+DEF_BENCH( return new ScalePixelsBench("triangle", {Filter::kTriangle}, Path::kResampler, 8); )
+DEF_BENCH( return new ScalePixelsBench("triangle", {Filter::kTriangle}, Path::kShader); )
+DEF_BENCH( return new ScalePixelsBench("mitchell", {Filter::kCubic}); )
+DEF_BENCH( return new ScalePixelsBench("mitchell", {Filter::kCubic}, Path::kResampler, 4); )
+DEF_BENCH( return new ScalePixelsBench("mitchell", {Filter::kCubic}, Path::kResampler, 8); )
+DEF_BENCH( return new ScalePixelsBench("mitchell", {Filter::kCubic}, Path::kShader); )
+DEF_BENCH( return new ScalePixelsBench("lanczos3", {Filter::kLanczos3}); )
+DEF_BENCH( return new ScalePixelsBench("lanczos3", {Filter::kLanczos3}, Path::kResampler, 8); )
@@ -207,6 +207,7 @@ public:
         AndroidOptions()
             : SkCodec::Options()
             , fSampleSize(1)
+            , fBoxFilter(false)
         {}
 
         /**
@@ -217,6 +218,20 @@ public:
          *  The default is 1, representing no downscaling.
          */
         int fSampleSize;
+
+        /**
+         *  If true, a downscale that would be implemented by sampling instead
+         *  averages each block of source pixels into its output pixel. The
+         *  averaging happens row by row as the image is decoded, so the full
+         *  size image is never allocated.
+         *
+         *  This is only supported for 8-bit per channel outputs of codecs that
+         *  sample with SkSwizzler (PNG, BMP, ICO, WBMP and non-native JPEG
+         *  scales).  Other decodes ignore it.
+         *
+         *  The default is false, representing point sampling.
+         */
+        bool fBoxFilter;
     };
 
     /**
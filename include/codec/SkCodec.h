@@ -30,7 +30,9 @@
 #include <tuple>
 #include <vector>
 
+class SkBitmap;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -204,6 +206,10 @@ public:
      *  If this data represents an encoded image that we know how to decode,
      *  return an SkCodec that can decode it. Otherwise return NULL.
      *
+     *  The SkCodec refs the data and reads the encoded bytes directly from its
+     *  memory, so e.g. a file mapped with SkData::MakeFromFileName() or
+     *  SkData::MakeFromFD() is decoded without copying it into the heap.
+     *
      *  If the SkPngChunkReader is not NULL then:
      *      If the image is not a PNG, the SkPngChunkReader will be ignored.
      *      If the image is a PNG, the SkPngChunkReader will be reffed.
@@ -1172,6 +1178,32 @@ void SK_API Register(Decoder d);
  */
 SK_API sk_sp<SkImage> DeferredImage(std::unique_ptr<SkCodec> codec,
                                     std::optional<SkAlphaType> alphaType = std::nullopt);
+
+/**
+ *  Decode every frame of the (possibly animated) image in data. On return, frames holds one
+ *  bitmap per frame, in order, matching what getPixels() returns for each fFrameIndex.
+ *
+ *  If executor is non-null, frames that do not depend on an earlier frame (fRequiredFrame is
+ *  kNoFrame), as well as frames that depend on the same earlier frame, are decoded concurrently,
+ *  each task using its own SkCodec. A frame that depends on an earlier frame starts from a copy
+ *  of that frame's pixels instead of decoding it again. The pixels do not depend on executor.
+ *
+ *  A frame that fails to decode does not stop the frames that depend on it: each is still
+ *  decoded (from scratch, if need be) and reports its own result.
+ *
+ *  @param data       Encoded image.
+ *  @param colorType  Color type of the decoded frames.
+ *  @param alphaType  Alpha type of the decoded frames. Ignored for opaque images.
+ *  @param executor   Optional; if null, frames are decoded in order on the calling thread.
+ *  @param frames     Output. Resized to the frame count.
+ *  @return kSuccess if every frame was fully decoded. Otherwise the result for the first frame
+ *          that was not, or kInvalidInput if data could not be decoded (frames is then empty).
+ */
+SK_API SkCodec::Result DecodeAllFrames(sk_sp<const SkData> data,
+                                       SkColorType colorType,
+                                       SkAlphaType alphaType,
+                                       SkExecutor* executor,
+                                       std::vector<SkBitmap>* frames);
 }
 
 #endif // SkCodec_DEFINED
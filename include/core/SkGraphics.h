@@ -126,6 +126,31 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Statistics for the cache of CPU image filter results. Hit, miss, insert and eviction counts
+     *  accumulate until ResetImageFilterCacheStats() is called.
+     */
+    struct ImageFilterCacheStats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+        // Hits on results last used before the most recent NotifyImageFilterCacheNewFrame().
+        uint64_t fCrossFrameHits = 0;
+        uint64_t fInserts = 0;
+        // Results removed to stay within the byte limit.
+        uint64_t fEvictions = 0;
+        size_t   fBytesUsed = 0;
+        size_t   fByteLimit = 0;
+        int      fEntryCount = 0;
+    };
+    static ImageFilterCacheStats GetImageFilterCacheStats();
+    static void ResetImageFilterCacheStats();
+
+    /**
+     *  Marks a frame boundary, so that GetImageFilterCacheStats() can count the hits on results
+     *  that were carried over from an earlier frame.
+     */
+    static void NotifyImageFilterCacheNewFrame();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
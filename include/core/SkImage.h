@@ -24,6 +24,7 @@ class GrDirectContext;
 class SkBitmap;
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageGenerator;
@@ -235,6 +236,8 @@ SK_API sk_sp<SkImage> RasterFromData(const SkImageInfo& info,
     @param clipBounds  expected bounds of filtered SkImage
     @param outSubset   storage for returned SkImage bounds
     @param offset      storage for returned SkImage translation
+    @param executor    optional executor used to evaluate independent filter inputs and large
+                       per-pixel filter stages concurrently; the result does not depend on it
     @return            filtered SkImage, or nullptr
 */
 SK_API sk_sp<SkImage> MakeWithFilter(sk_sp<SkImage> src,
@@ -242,7 +245,8 @@ SK_API sk_sp<SkImage> MakeWithFilter(sk_sp<SkImage> src,
                                      const SkIRect& subset,
                                      const SkIRect& clipBounds,
                                      SkIRect* outSubset,
-                                     SkIPoint* offset);
+                                     SkIPoint* offset,
+                                     SkExecutor* executor = nullptr);
 
 }  // namespace SkImages
 
@@ -10,6 +10,7 @@
 
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"  // IWYU pragma: keep
 #include "include/core/SkTypes.h"
 
@@ -54,6 +55,10 @@ public:
         may be used to provide user context to procs->fPictureProc; procs->fPictureProc
         is called with a pointer to data, data byte length, and user context.
 
+        If the stream was written by serializeChunked(), chunks are decoded lazily when first
+        drawn, using a copy of procs: every context in procs must remain valid for as long as
+        the returned SkPicture is played back.
+
         @param stream  container for serial data
         @param procs   custom serial data decoders; may be nullptr
         @return        SkPicture constructed from stream data
@@ -70,6 +75,10 @@ public:
         may be used to provide user context to procs->fPictureProc; procs->fPictureProc
         is called with a pointer to data, data byte length, and user context.
 
+        If data was written by serializeChunked(), chunks are decoded lazily when first
+        drawn, using a copy of procs: every context in procs must remain valid for as long as
+        the returned SkPicture is played back.
+
         @param data   container for serial data
         @param procs  custom serial data decoders; may be nullptr
         @return       SkPicture constructed from data
@@ -87,6 +96,27 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized by serializeForMapping(), without copying data
+        or decoding its drawing commands up front. Drawing commands and encoded images are read
+        in place from data, and commands are decoded each time the SkPicture is played back.
+        data may be memory mapped, e.g. by SkData::MakeFromFileName(); the returned SkPicture,
+        and images drawn by it, keep a reference to it.
+
+        If data was written by serialize() instead, falls back to MakeFromData(). If it was
+        written by serializeChunked(), every context in procs must remain valid for as long as
+        the returned SkPicture is played back, as for MakeFromData().
+
+        Because every playback decodes the drawing commands again, and there is no bounding box
+        hierarchy to cull them with, this suits pictures that are drawn a few times after
+        loading, rather than many times.
+
+        @param data   serial data from serializeForMapping(), aligned to 4 bytes
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromMappedData(sk_sp<const SkData> data,
+                                               const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -191,6 +221,37 @@ public:
     */
     void serialize(SkWStream* stream, const SkSerialProcs* procs = nullptr) const;
 
+    /** Returns storage containing SkData describing SkPicture, laid out so that
+        MakeFromMappedData() can play it back in place: every section is padded to 4 bytes.
+        The result is a few bytes larger than serialize()'s and can also be read by
+        MakeFromData() and MakeFromStream(), but not by versions of Skia without
+        MakeFromMappedData().
+
+        @param procs  custom serial data encoders; may be nullptr
+        @return       storage containing serialized SkPicture
+    */
+    sk_sp<SkData> serializeForMapping(const SkSerialProcs* procs = nullptr) const;
+
+    /** Returns storage containing SkData describing SkPicture, split into square chunks of
+        chunkSize by chunkSize picture units across cullRect(). Each chunk holds the drawing
+        commands that touch it, stored as by serializeForMapping(), and the chunk bounds are
+        indexed, so that a SkPicture read back by MakeFromData(), MakeFromStream() or
+        MakeFromMappedData() only deserializes the chunks that intersect the clip the first
+        time it is played back with that clip. This suits very large pictures that are only
+        ever drawn a viewport at a time.
+
+        Drawing commands that touch several chunks are stored once per chunk. There are at
+        most 128 chunks across each side of cullRect(); chunkSize is increased to keep to that.
+        The SkDeserialProcs passed when reading the result are also used, and their contexts
+        must remain valid, while the SkPicture is played back. The result cannot be read by
+        versions of Skia without this function.
+
+        @param chunkSize  width and height of each chunk; if not positive, only one chunk
+        @param procs      custom serial data encoders; may be nullptr
+        @return           storage containing serialized SkPicture
+    */
+    sk_sp<SkData> serializeChunked(SkScalar chunkSize, const SkSerialProcs* procs = nullptr) const;
+
     /** Returns a placeholder SkPicture. Result does not draw, and contains only
         cull SkRect, a hint of its bounds. Result is immutable; it cannot be changed
         later. Result identifier is unique.
@@ -251,14 +312,17 @@ private:
     // Allowed subclasses.
     SkPicture();
     friend class SkBigPicture;
+    friend class SkChunkedPicture;
     friend class SkEmptyPicture;
+    friend class SkMappedPicture;
     friend class SkPicturePriv;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces,
-        bool textBlobsOnly=false) const;
+        bool textBlobsOnly=false, bool padded=false) const;
     static sk_sp<SkPicture> MakeFromStreamPriv(SkStream*, const SkDeserialProcs*,
                                                class SkTypefacePlayback*,
-                                               int recursionLimit);
+                                               int recursionLimit,
+                                               const SkData* mapped = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
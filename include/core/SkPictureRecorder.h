@@ -50,6 +50,15 @@ public:
         return this->beginRecording(SkRect::MakeWH(width, height), bbhFactory);
     }
 
+    /** Enables record optimizations beyond the default ones when recording finishes: draws
+        hidden by a later opaque drawColor() or drawPaint() are dropped, runs of rect clips are
+        collapsed, overwritten matrices are dropped and runs of drawImageRect() are merged into
+        one image set. These are only exact if the picture is played back through pixel-aligned
+        clips that are axis-aligned with its clips. Off by default; applies to every following
+        recording.
+    */
+    void setExtendedOptimizations(bool enabled) { fExtendedOptimizations = enabled; }
+
     /** Returns the recording canvas if one is active, or NULL if recording is
         not active. This does not alter the refcnt on the canvas (if present).
     */
@@ -92,6 +101,7 @@ public:
 
 private:
     void reset();
+    void optimize();
 
     /** Replay the current (partially recorded) operation stream into
         canvas. This call doesn't close the current recording.
@@ -107,6 +117,7 @@ private:
     sk_sp<SkRecord> fRecord;
     SkRect fCullRect;
     bool fActivelyRecording;
+    bool fExtendedOptimizations = false;
 
     SkPictureRecorder(SkPictureRecorder&&) = delete;
     SkPictureRecorder& operator=(SkPictureRecorder&&) = delete;
@@ -22,6 +22,7 @@
 #include <cstdint>
 
 class SkColorSpace;
+class SkExecutor;
 enum SkAlphaType : int;
 struct SkMask;
 
@@ -688,12 +689,19 @@ public:
 
         Returns false if SkBitmap width() or height() is zero or negative.
 
+        Cubic sampling, and linear sampling with mipmaps, of 32-bit RGBA or BGRA pixels into
+        the same color type and color space are done with a separable filter whose support
+        grows with the downscale factor. If executor is not nullptr, those scales are split
+        into bands of rows that run on it; the pixels written are the same either way.
+
         @param dst            SkImageInfo and pixel address to write to
+        @param executor       optional executor to scale bands of dst rows on
         @return               true if pixels are scaled to fit dst
 
         example: https://fiddle.skia.org/c/@Pixmap_scalePixels
     */
-    bool scalePixels(const SkPixmap& dst, const SkSamplingOptions&) const;
+    bool scalePixels(const SkPixmap& dst, const SkSamplingOptions&,
+                     SkExecutor* executor = nullptr) const;
 
     /** Writes color to pixels bounded by subset; returns true on success.
         Returns false if colorType() is kUnknown_SkColorType, or if subset does
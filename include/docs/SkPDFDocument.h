@@ -13,6 +13,7 @@
 #include "include/private/SkMacros.h"
 #include "include/private/SkNoncopyable.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -23,6 +24,7 @@ class SkData;
 class SkExecutor;
 class SkPDFArray;
 class SkPDFStructTree;
+class SkPicture;
 class SkPixmap;
 class SkWStream;
 
@@ -89,6 +91,7 @@ struct DateTime {
 
 using DecodeJpegCallback = std::unique_ptr<SkCodec> (*)(sk_sp<const SkData>);
 using EncodeJpegCallback = bool (*)(SkWStream* dst, const SkPixmap& src, int quality);
+using DeflateCallback = bool (*)(SkWStream* dst, SkSpan<const uint8_t> src, int compressionLevel);
 
 /** Optional metadata to be passed into the PDF factory function.
 */
@@ -188,6 +191,20 @@ struct Metadata {
     */
     SkExecutor* fExecutor = nullptr;
 
+    /** If fExecutor is set, the most bytes of page content and image pixels that may be
+        waiting on it at once. Work that would go over this limit is done on the calling
+        thread instead, so a fast producer cannot queue up unbounded memory. A single item
+        larger than the limit is still queued if nothing else is. Zero means no limit.
+    */
+    size_t fMaxQueuedJobBytes = 0;
+
+    /** If true, write each page object as soon as its page ends instead of holding every
+        page until close(), so that memory use stays flat for documents with many thousands
+        of pages. The page tree is built in a different order, so the output differs from
+        the default mode (though it renders the same).
+    */
+    bool fLowMemory = false;
+
     /** PDF streams may be compressed to save space.
         Use this to specify the desired compression vs time tradeoff.
     */
@@ -199,11 +216,47 @@ struct Metadata {
         HighButSlow = 9,
     } fCompressionLevel = CompressionLevel::Default;
 
+    /** Compression levels for particular kinds of stream. Each one left at Default uses
+        fCompressionLevel. Page and form content is usually the bulk of the work and is
+        often worth compressing fast, while fonts and images are written once and shared
+        across pages, so a slower level can pay off.
+    */
+    CompressionLevel fContentCompressionLevel = CompressionLevel::Default;
+    CompressionLevel fFontCompressionLevel = CompressionLevel::Default;
+    CompressionLevel fImageCompressionLevel = CompressionLevel::Default;
+
+    /** Clients can provide their own Deflate implementation, such as libdeflate, to
+        compress streams as one buffer. It is given every stream that is compressed, which
+        may mean copying a stream that is not already contiguous in memory. It must write
+        zlib format (RFC 1950) data to dst and return true, or return false without writing
+        anything to fall back to zlib.
+        compressionLevel is 1 through 9, or -1 for the compressor's default.
+
+        Without a callback, zlib also compresses streams as one buffer, copying those up to
+        16MB (64KB with fLowMemory) that are not contiguous. Larger streams are compressed
+        incrementally. Both produce the same output.
+    */
+    SkPDF::DeflateCallback deflate = nullptr;
+
     /** Preferred Subsetter. */
     enum Subsetter {
         kHarfbuzz_Subsetter,
     } fSubsetter = kHarfbuzz_Subsetter;
 
+    /** If true, font subsets and the parsed fonts they are made from are kept in a
+        process-wide cache shared with every other document that sets this, so that
+        documents using the same fonts and glyphs skip repeating the subsetting work.
+        The cache holds at most 8MB of subsets, evicting the least recently used first.
+        Output is unchanged.
+    */
+    bool fCacheFontSubsets = false;
+
+    /** If true, images are also de-duplicated by content: distinct SkImages with the same
+        encoded data, or the same pixels, are embedded once. This costs a hash of each new
+        image's encoded data or pixels.
+    */
+    bool fDeduplicateImageContent = false;
+
     /** Clients can provide a way to decode jpeg. To use Skia's JPEG decoder, pass in
         SkJpegDecoder::Decode. If not supplied, all images will need to be re-encoded
         as jpegs or deflated images before embedding. If supplied, Skia may be able to
@@ -266,6 +319,38 @@ SK_API void SetNodeId(SkCanvas* dst, int nodeID);
 */
 SK_API sk_sp<SkDocument> MakeDocument(SkWStream* stream, const Metadata& metadata);
 
+/** Add one page per picture to a document made by MakeDocument(), each sized to the
+    picture's cull rect with the cull rect's top left at the page origin. Pictures with an
+    empty cull rect add no page. The output is byte-for-byte what calling beginPage(),
+    drawPicture() and endPage() for each picture in order would produce.
+
+    If executor is not null, up to 8 pages are drawn and compressed at once on the executor
+    and the calling thread, each into its own device. Pages still number their objects and
+    add fonts, images and other resources to the document in page order, each waiting for the
+    page before it to be written first, so only the drawing that does not depend on earlier
+    pages runs concurrently.
+
+    @param document  A PDF document. A page that is still open is ended first.
+    @param pictures  The pages to add, in order.
+    @param executor  Optional executor to draw pages on. Unrelated to Metadata::fExecutor.
+*/
+SK_API void DrawPictures(SkDocument* document,
+                         SkSpan<const sk_sp<SkPicture>> pictures,
+                         SkExecutor* executor = nullptr);
+
+/** What a document made by MakeDocument() has written so far. */
+struct Stats {
+    /** Image XObjects written, including those made for images drawn through shaders and
+        for color glyphs. */
+    int fImageCount = 0;
+    /** Images that were not written because an image with the same content already was.
+        Always zero unless Metadata::fDeduplicateImageContent is set. */
+    int fImageContentDuplicateCount = 0;
+};
+
+/** Return the Stats of a document made by MakeDocument(). */
+SK_API Stats GetStats(SkDocument* document);
+
 #if !defined(SK_DISABLE_LEGACY_PDF_JPEG)
 static inline sk_sp<SkDocument> MakeDocument(SkWStream* stream) {
     return MakeDocument(stream, Metadata());
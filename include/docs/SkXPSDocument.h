@@ -33,6 +33,11 @@ struct Options {
      *  set `allowNoPngs` to true to acknowledge this.
      */
     bool allowNoPngs = false;
+
+    /** If true, images whose encoded pngs are identical share one image resource in the
+     *  document instead of each being written as its own part.
+     */
+    bool deduplicateImages = false;
 };
 
 SK_API sk_sp<SkDocument> MakeDocument(SkWStream* stream,
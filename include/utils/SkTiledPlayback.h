@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTiledPlayback_DEFINED
+#define SkTiledPlayback_DEFINED
+
+#include "include/core/SkMatrix.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkTypes.h"
+
+class SkExecutor;
+class SkPicture;
+class SkSurface;
+
+namespace SkTiledPlayback {
+
+struct Options {
+    /** Size of the tiles the surface is split into. Each tile is one task. */
+    SkISize fTileSize = {256, 256};
+
+    /** Executor to play tiles back on. If null, tiles are played back one at a time on the
+        calling thread.
+    */
+    SkExecutor* fExecutor = nullptr;
+};
+
+/**
+ *  Draws picture into surface, transformed by matrix, by splitting the surface into tiles and
+ *  playing the picture back into each tile separately, concurrently when there is an executor.
+ *  Each tile only replays the ops that its bounds query from the picture's bounding box
+ *  hierarchy, so pictures should be recorded with an SkRTreeFactory.
+ *
+ *  Raster surfaces are drawn into in place. Other surfaces are read back into a raster copy,
+ *  drawn into, and written back, all of which happens on the calling thread.
+ *
+ *  The result is the same whatever the executor, and for tile sizes that are multiples of 16
+ *  matches drawing the picture serially, except where an effect reads pixels from beyond the
+ *  tile it is drawn in, such as a backdrop filter.
+ *
+ *  The surface's canvas state (matrix and clip) is ignored. Returns false if the surface could
+ *  not be drawn into, in which case some tiles may have been drawn.
+ */
+SK_API bool Draw(SkSurface* surface,
+                 const SkPicture* picture,
+                 const SkMatrix& matrix = SkMatrix::I(),
+                 const Options& options = Options());
+
+}  // namespace SkTiledPlayback
+
+#endif  // SkTiledPlayback_DEFINED
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkAssert.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Frames form a forest: each frame depends on at most one earlier frame (its required frame).
+// Roots are decoded from scratch; every other frame starts from a copy of its parent.
+class AllFramesDecoder {
+public:
+    AllFramesDecoder(sk_sp<const SkData> data,
+                     const SkImageInfo& info,
+                     const std::vector<SkCodec::FrameInfo>& frameInfos,
+                     std::vector<SkBitmap>* frames)
+            : fData(std::move(data))
+            , fInfo(info)
+            , fChildren(frameInfos.size())
+            , fResults(frameInfos.size(), SkCodec::kInternalError)
+            , fFrames(frames) {
+        for (size_t i = 0; i < frameInfos.size(); i++) {
+            fRequiredFrame.push_back(frameInfos[i].fRequiredFrame);
+            if (frameInfos[i].fRequiredFrame != SkCodec::kNoFrame) {
+                fChildren[frameInfos[i].fRequiredFrame].push_back(SkToInt(i));
+            }
+        }
+    }
+
+    // Decodes all frames in order with one codec.
+    void decodeSerially(SkCodec* codec) {
+        for (int i = 0; i < SkToInt(fFrames->size()); i++) {
+            this->decodeFrame(codec, i);
+        }
+    }
+
+    // Decodes each tree of frames on executor, branching into a new task wherever more than
+    // one frame depends on the same frame.
+    void decodeConcurrently(SkExecutor* executor) {
+        SkTaskGroup group(*executor);
+        for (int i = 0; i < SkToInt(fFrames->size()); i++) {
+            if (fRequiredFrame[i] == SkCodec::kNoFrame) {
+                group.add([this, &group, i] { this->decodeTree(&group, i); });
+            }
+        }
+        group.wait();
+    }
+
+    SkCodec::Result result() const {
+        for (SkCodec::Result result : fResults) {
+            if (result != SkCodec::kSuccess) {
+                return result;
+            }
+        }
+        return SkCodec::kSuccess;
+    }
+
+private:
+    void decodeTree(SkTaskGroup* group, int index) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+        while (true) {
+            if (!codec) {
+                // Report this frame, but still try each dependent frame with a codec of its own;
+                // decodeFrame() has them decode their required frame themselves.
+                fResults[index] = SkCodec::kInternalError;
+                for (int child : fChildren[index]) {
+                    group->add([this, group, child] { this->decodeTree(group, child); });
+                }
+                return;
+            }
+            this->decodeFrame(codec.get(), index);
+
+            const std::vector<int>& children = fChildren[index];
+            if (children.empty()) {
+                return;
+            }
+            // Continue with the first dependent frame on this thread and codec.
+            for (size_t i = 1; i < children.size(); i++) {
+                const int child = children[i];
+                group->add([this, group, child] { this->decodeTree(group, child); });
+            }
+            index = children[0];
+        }
+    }
+
+    void decodeFrame(SkCodec* codec, int index) {
+        SkBitmap& frame = (*fFrames)[index];
+        if (!frame.tryAllocPixels(fInfo)) {
+            fResults[index] = SkCodec::kInternalError;
+            return;
+        }
+
+        SkCodec::Options options;
+        options.fFrameIndex = index;
+        // The parent is always decoded before its dependents, so if it succeeded we can start
+        // from its pixels. Otherwise the codec decodes the required frame itself.
+        const int required = fRequiredFrame[index];
+        if (required != SkCodec::kNoFrame && fResults[required] == SkCodec::kSuccess) {
+            SkAssertResult(frame.writePixels((*fFrames)[required].pixmap()));
+            options.fPriorFrame = required;
+        }
+        fResults[index] = codec->getPixels(frame.pixmap(), &options);
+    }
+
+    const sk_sp<const SkData>     fData;
+    const SkImageInfo             fInfo;
+    std::vector<int>              fRequiredFrame;
+    std::vector<std::vector<int>> fChildren;
+    std::vector<SkCodec::Result>  fResults;
+    std::vector<SkBitmap>*        fFrames;
+};
+
+}  // namespace
+
+namespace SkCodecs {
+
+SkCodec::Result DecodeAllFrames(sk_sp<const SkData> data,
+                                SkColorType colorType,
+                                SkAlphaType alphaType,
+                                SkExecutor* executor,
+                                std::vector<SkBitmap>* frames) {
+    SkASSERT(frames);
+    frames->clear();
+
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        return SkCodec::kInvalidInput;
+    }
+
+    SkImageInfo info = codec->getInfo().makeColorType(colorType);
+    if (info.alphaType() != kOpaque_SkAlphaType) {
+        info = info.makeAlphaType(alphaType);
+    }
+
+    std::vector<SkCodec::FrameInfo> frameInfos = codec->getFrameInfo();
+    if (frameInfos.empty()) {
+        // Still images report no frame info; treat them as a single independent frame.
+        SkCodec::FrameInfo frameInfo;
+        frameInfo.fRequiredFrame = SkCodec::kNoFrame;
+        frameInfos.push_back(frameInfo);
+    }
+    frames->resize(frameInfos.size());
+
+    AllFramesDecoder decoder(std::move(data), info, frameInfos, frames);
+    if (executor && frameInfos.size() > 1) {
+        decoder.decodeConcurrently(executor);
+    } else {
+        decoder.decodeSerially(codec.get());
+    }
+    return decoder.result();
+}
+
+}  // namespace SkCodecs
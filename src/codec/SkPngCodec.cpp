@@ -149,6 +149,20 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
 
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
+    if (const void* base = stream->getMemoryBase();
+            base && stream->hasPosition() && stream->hasLength()) {
+        // Hand libpng the bytes in place rather than copying them through buffer. Skip first,
+        // so the stream is positioned as if read() had been called if libpng longjmps out.
+        const size_t position = stream->getPosition();
+        const size_t bytesToProcess = std::min(stream->getLength() - position, length);
+        stream->skip(bytesToProcess);
+        // libpng does not write to the input, but its API is not const.
+        png_process_data(png_ptr, info_ptr,
+                         const_cast<png_bytep>(static_cast<const png_byte*>(base) + position),
+                         bytesToProcess);
+        return bytesToProcess == length;
+    }
+
     while (length > 0) {
         const size_t bytesToProcess = std::min(bufferSize, length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
@@ -505,6 +519,8 @@ private:
             this->applyXformRow(fDst, row);
             fDst = SkTAddOffset<void>(fDst, fRowBytes);
             fRowsWrittenToOutput++;
+        } else if (this->swizzler()->boxFilter()) {
+            this->accumulateRow(row);
         }
 
         if (fRowsWrittenToOutput == fRowsNeeded) {
@@ -648,22 +664,29 @@ private:
 
         const int sampleY = this->swizzler() ? this->swizzler()->sampleY() : 1;
         const int rowsNeeded = SkCodecPriv::GetSampledDimension(fLastRow - fFirstRow + 1, sampleY);
+        const bool boxFilter = this->swizzler() && this->swizzler()->boxFilter();
 
         // FIXME: For resuming interlace, we may swizzle a row that hasn't changed. But it
         // may be too tricky/expensive to handle that correctly.
 
         // Offset srcRow by SkCodecPriv::GetStartCoord rows. We do not need to account for
         // fFirstRow, since the first row in fInterlaceBuffer corresponds to fFirstRow.
-        int srcRow = SkCodecPriv::GetStartCoord(sampleY);
+        // When box filtering, every row of each block contributes to the output.
+        int srcRow = boxFilter ? 0 : SkCodecPriv::GetStartCoord(sampleY);
         void* dst = fDst;
         int rowsWrittenToOutput = 0;
         while (rowsWrittenToOutput < rowsNeeded && srcRow < fLinesDecoded) {
             png_bytep src = SkTAddOffset<png_byte>(fInterlaceBuffer.get(), fPng_rowbytes * srcRow);
+            if (boxFilter && !this->swizzler()->rowNeeded(srcRow)) {
+                this->accumulateRow(src);
+                srcRow++;
+                continue;
+            }
             this->applyXformRow(dst, src);
             dst = SkTAddOffset<void>(dst, fRowBytes);
 
             rowsWrittenToOutput++;
-            srcRow += sampleY;
+            srcRow += boxFilter ? 1 : sampleY;
         }
 
         if (success && fInterlacedComplete) {
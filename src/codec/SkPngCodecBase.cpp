@@ -311,6 +311,11 @@ void SkPngCodecBase::applyXformRow(void* dstRow, const uint8_t* srcRow) {
     }
 }
 
+void SkPngCodecBase::accumulateRow(const uint8_t* srcRow) {
+    SkASSERT_RELEASE(fSwizzler && fSwizzler->boxFilter());
+    fSwizzler->accumulateRow(srcRow);
+}
+
 // Note: SkColorPalette claims to store SkPMColors, which is not necessarily the case here.
 bool SkPngCodecBase::createColorTable(const SkImageInfo& dstInfo) {
     if (fDstInfoOfPreviousColorTableCreation.has_value() &&
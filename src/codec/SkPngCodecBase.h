@@ -72,6 +72,11 @@ protected:
     void applyXformRow(SkSpan<uint8_t> dstRow, SkSpan<const uint8_t> srcRow);
     void applyXformRow(void* dstRow, const uint8_t* srcRow);
 
+    // When the swizzler box filters (see `SkSampler::setBoxFilter`), decoded rows
+    // that are not needed in the output still contribute to the next output row,
+    // and must be passed here instead of being skipped.
+    void accumulateRow(const uint8_t* srcRow);
+
     size_t getEncodedRowBytes() const { return fEncodedRowBytes; }
     size_t getDstRowBytes() const { return fDstRowBytes; }
     const SkSwizzler* swizzler() const { return fSwizzler.get(); }
@@ -922,6 +922,9 @@ SkCodec::Result SkPngRustCodec::incrementalDecodeXForm(DecodingState& decodingSt
                 continue;
             }
             if (this->swizzler() && !this->swizzler()->rowNeeded(y)) {
+                if (this->swizzler()->boxFilter()) {
+                    this->accumulateRow(decodedRow.data());
+                }
                 continue;
             }
 
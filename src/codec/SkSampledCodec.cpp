@@ -240,6 +240,7 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             }
 
             sampler->setSampleY(sampleY);
+            sampler->setBoxFilter(options.fBoxFilter);
 
             int rowsDecoded = 0;
             const SkCodec::Result incResult = this->codec()->incrementalDecode(&rowsDecoded);
@@ -285,15 +286,35 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
         return SkCodec::kInvalidScale;
     }
 
+    // When box filtering, every source row of a block is passed to the sampler, which only
+    // writes to the destination row once the block is complete. Point sampled decodes skip rows
+    // here instead, so their sampler never needs to know sampleY.
+    bool boxFilter = false;
+    if (options.fBoxFilter) {
+        sampler->setSampleY(sampleY);
+        boxFilter = sampler->setBoxFilter(true);
+    }
+
     switch(this->codec()->getScanlineOrder()) {
         case SkCodec::kTopDown_SkScanlineOrder: {
-            if (!this->codec()->skipScanlines(startY)) {
+            if (!this->codec()->skipScanlines(boxFilter ? subsetY : startY)) {
                 this->codec()->fillIncompleteImage(info, pixels, rowBytes, options.fZeroInitialized,
                         dstHeight, 0);
                 return SkCodec::kIncompleteInput;
             }
             void* pixelPtr = pixels;
             for (int y = 0; y < dstHeight; y++) {
+                if (boxFilter) {
+                    for (int i = 0; i < sampleY; i++) {
+                        if (1 != this->codec()->getScanlines(pixelPtr, 1, rowBytes)) {
+                            this->codec()->fillIncompleteImage(info, pixels, rowBytes,
+                                    options.fZeroInitialized, dstHeight, y);
+                            return SkCodec::kIncompleteInput;
+                        }
+                    }
+                    pixelPtr = SkTAddOffset<void>(pixelPtr, rowBytes);
+                    continue;
+                }
                 if (1 != this->codec()->getScanlines(pixelPtr, 1, rowBytes)) {
                     this->codec()->fillIncompleteImage(info, pixels, rowBytes,
                             options.fZeroInitialized, dstHeight, y + 1);
@@ -313,12 +334,20 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
         case SkCodec::kBottomUp_SkScanlineOrder: {
             // Note that these modes do not support subsetting.
             SkASSERT(0 == subsetY && nativeSize.height() == subsetHeight);
+            // Rows arrive bottom to top, but the rows of each block are still contiguous.
+            // Source rows below the last complete block are dropped when box filtering.
+            auto isCoordNecessary = [&](int srcY) {
+                return boxFilter ? srcY < dstHeight * sampleY
+                                 : SkCodecPriv::IsCoordNecessary(srcY, sampleY, dstHeight);
+            };
+            auto getDstCoord = [&](int srcY) {
+                return boxFilter ? srcY / sampleY : SkCodecPriv::GetDstCoord(srcY, sampleY);
+            };
             int y;
             for (y = 0; y < nativeSize.height(); y++) {
                 int srcY = this->codec()->nextScanline();
-                if (SkCodecPriv::IsCoordNecessary(srcY, sampleY, dstHeight)) {
-                    void* pixelPtr = SkTAddOffset<void>(
-                            pixels, rowBytes * SkCodecPriv::GetDstCoord(srcY, sampleY));
+                if (isCoordNecessary(srcY)) {
+                    void* pixelPtr = SkTAddOffset<void>(pixels, rowBytes * getDstCoord(srcY));
                     if (1 != this->codec()->getScanlines(pixelPtr, 1, rowBytes)) {
                         break;
                     }
@@ -338,12 +367,11 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             const SkImageInfo fillInfo = info.makeWH(info.width(), 1);
             for (; y < nativeSize.height(); y++) {
                 int srcY = this->codec()->outputScanline(y);
-                if (!SkCodecPriv::IsCoordNecessary(srcY, sampleY, dstHeight)) {
+                if (!isCoordNecessary(srcY)) {
                     continue;
                 }
 
-                void* rowPtr = SkTAddOffset<void>(
-                        pixels, rowBytes * SkCodecPriv::GetDstCoord(srcY, sampleY));
+                void* rowPtr = SkTAddOffset<void>(pixels, rowBytes * getDstCoord(srcY));
                 SkSampler::Fill(fillInfo, rowPtr, rowBytes, options.fZeroInitialized);
             }
             return SkCodec::kIncompleteInput;
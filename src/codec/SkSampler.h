@@ -40,13 +40,35 @@ public:
         return fSampleY;
     }
 
+    /**
+     *  Request that the sampler average each sampleX x sampleY block of source pixels into
+     *  one output pixel, rather than picking a single pixel from the block. Must be called
+     *  after setSampleX() and setSampleY().
+     *
+     *  Returns whether box filtering is enabled. Not all samplers (or destination formats)
+     *  support it, in which case the sampler continues to point sample.
+     *
+     *  When box filtering, rowNeeded() returns true for the last row of each block, and every
+     *  other row of the block must be passed to the sampler before it (see
+     *  SkSwizzler::accumulateRow()).
+     */
+    bool setBoxFilter(bool boxFilter) {
+        fBoxFilter = boxFilter && this->onSetBoxFilter();
+        return fBoxFilter;
+    }
+
+    bool boxFilter() const {
+        return fBoxFilter;
+    }
+
     /**
      *  Based on fSampleY, return whether this row belongs in the output.
      *
      *  @param row Row of the image, starting with the first row in the subset.
      */
     bool rowNeeded(int row) const {
-        return (row - SkCodecPriv::GetStartCoord(fSampleY)) % fSampleY == 0;
+        const int startY = fBoxFilter ? fSampleY - 1 : SkCodecPriv::GetStartCoord(fSampleY);
+        return (row - startY) % fSampleY == 0;
     }
 
     /**
@@ -77,13 +99,18 @@ public:
 
     SkSampler()
         : fSampleY(1)
+        , fBoxFilter(false)
     {}
 
     virtual ~SkSampler() {}
 private:
-    int fSampleY;
+    int  fSampleY;
+    bool fBoxFilter;
 
     virtual int onSetSampleX(int) = 0;
+
+    // Returns true if box filtering is supported for the current sampling rates.
+    virtual bool onSetBoxFilter() { return false; }
 };
 
 #endif // SkSampler_DEFINED
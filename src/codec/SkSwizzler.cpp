@@ -14,8 +14,10 @@
 #include "include/private/SkAlign.h"
 #include "include/private/SkCPUTypes.h"
 #include "include/private/SkEncodedInfo.h"
+#include "include/private/SkMalloc.h"
 #include "include/private/SkMath.h"
 #include "include/private/SkTemplates.h"
+#include "include/private/SkTo.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/core/SkColorData.h"
 #include "src/core/SkColorPriv.h"
@@ -26,6 +28,7 @@
     #include "include/android/SkAndroidFrameworkUtils.h"
 #endif
 
+#include <algorithm>
 #include <cstring>
 
 static void copy(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
@@ -561,6 +564,28 @@ static void swizzle_rgb16_to_bgra(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_565(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -591,6 +616,17 @@ static void swizzle_rgba16_to_rgba_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_rgba_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -606,6 +642,17 @@ static void swizzle_rgba16_to_rgba_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_rgbA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_unpremul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -621,6 +668,17 @@ static void swizzle_rgba16_to_bgra_unpremul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_bgra_premul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -636,6 +694,17 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_bgrA((uint32_t*) dst, src + offset, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -969,6 +1038,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kRGBA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_rgba;
+                        fastProc = &fast_swizzle_rgb16_to_rgba;
                         break;
                     }
 
@@ -979,6 +1049,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kBGRA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_bgra;
+                        fastProc = &fast_swizzle_rgb16_to_bgra;
                         break;
                     }
 
@@ -1004,6 +1075,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
                                              &swizzle_rgba16_to_rgba_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_rgba_premul :
+                                                 &fast_swizzle_rgba16_to_rgba_unpremul;
                         break;
                     }
 
@@ -1031,6 +1104,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
                                              &swizzle_rgba16_to_bgra_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_bgra_premul :
+                                                 &fast_swizzle_rgba16_to_bgra_unpremul;
                         break;
                     }
 
@@ -1186,11 +1261,13 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkImageInfo& dstInfo,
     }
 
     return std::unique_ptr<SkSwizzler>(new SkSwizzler(fastProc, proc, ctable, srcOffset, srcWidth,
-                                                      dstOffset, dstWidth, srcBPP, dstBPP));
+                                                      dstOffset, dstWidth, srcBPP, dstBPP,
+                                                      dstInfo.colorType(), dstInfo.alphaType()));
 }
 
 SkSwizzler::SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable, int srcOffset,
-        int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP)
+        int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP,
+        SkColorType dstColorType, SkAlphaType dstAlphaType)
     : fFastProc(fastProc)
     , fSlowProc(proc)
     , fActualProc(fFastProc ? fFastProc : fSlowProc)
@@ -1206,6 +1283,9 @@ SkSwizzler::SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable,
     , fSampleX(1)
     , fSrcBPP(srcBPP)
     , fDstBPP(dstBPP)
+    , fDstColorType(dstColorType)
+    , fDstAlphaType(dstAlphaType)
+    , fFilterRowCount(0)
 {}
 
 int SkSwizzler::onSetSampleX(int sampleX) {
@@ -1252,8 +1332,134 @@ int SkSwizzler::onSetSampleX(int sampleX) {
     return fAllocatedWidth;
 }
 
+bool SkSwizzler::onSetBoxFilter() {
+    fFilterRowCount = 0;
+
+    // Only 8-bit channels are averaged, and only when the swizzler writes every destination
+    // pixel (i.e. not for frames that are a subset of the image).
+    const bool eightBitChannels =
+            (4 == fDstBPP && (kRGBA_8888_SkColorType == fDstColorType ||
+                              kBGRA_8888_SkColorType == fDstColorType)) ||
+            (1 == fDstBPP && (kGray_8_SkColorType == fDstColorType ||
+                              kAlpha_8_SkColorType == fDstColorType));
+    if (!eightBitChannels || fDstOffset != 0 || fSrcWidth != fDstWidth) {
+        return false;
+    }
+    if (1 == fSampleX && 1 == this->sampleY()) {
+        return false;
+    }
+
+    // The sum of alpha-weighted channels must fit in 32 bits.
+    constexpr int kMaxBoxArea = 1 << 16;
+    if (fSampleX * this->sampleY() > kMaxBoxArea) {
+        return false;
+    }
+
+    fFilterRow.reset(SkToSizeT(fSrcWidth) * fDstBPP);
+    fFilterSums.reset(SkToSizeT(fSwizzleWidth) * fDstBPP);
+    sk_bzero(fFilterSums.get(), SkToSizeT(fSwizzleWidth) * fDstBPP * sizeof(uint32_t));
+    return true;
+}
+
+template <int kChannels, bool kAlphaWeighted>
+static void box_accumulate(uint32_t* SK_RESTRICT sums, const uint8_t* SK_RESTRICT row,
+                           int dstWidth, int srcWidth, int sampleX) {
+    for (int x = 0; x < dstWidth; x++) {
+        const int srcEnd = std::min((x + 1) * sampleX, srcWidth);
+        for (int srcX = x * sampleX; srcX < srcEnd; srcX++) {
+            const uint8_t* px = row + srcX * kChannels;
+            if (kAlphaWeighted) {
+                const uint32_t a = px[3];
+                sums[0] += px[0] * a;
+                sums[1] += px[1] * a;
+                sums[2] += px[2] * a;
+                sums[3] += a;
+            } else {
+                for (int c = 0; c < kChannels; c++) {
+                    sums[c] += px[c];
+                }
+            }
+        }
+        sums += kChannels;
+    }
+}
+
+template <int kChannels, bool kAlphaWeighted>
+static void box_resolve(uint8_t* SK_RESTRICT dst, uint32_t* SK_RESTRICT sums,
+                        int dstWidth, int srcWidth, int sampleX, int rows) {
+    for (int x = 0; x < dstWidth; x++) {
+        const uint32_t count = (std::min((x + 1) * sampleX, srcWidth) - x * sampleX) * rows;
+        if (kAlphaWeighted) {
+            const uint32_t a = sums[3];
+            if (0 == a) {
+                dst[0] = dst[1] = dst[2] = dst[3] = 0;
+            } else {
+                dst[0] = (sums[0] + a / 2) / a;
+                dst[1] = (sums[1] + a / 2) / a;
+                dst[2] = (sums[2] + a / 2) / a;
+                dst[3] = (a + count / 2) / count;
+            }
+        } else {
+            for (int c = 0; c < kChannels; c++) {
+                dst[c] = (sums[c] + count / 2) / count;
+            }
+        }
+        for (int c = 0; c < kChannels; c++) {
+            sums[c] = 0;
+        }
+        dst += kChannels;
+        sums += kChannels;
+    }
+}
+
+void SkSwizzler::accumulateRow(const uint8_t* SK_RESTRICT src) {
+    SkASSERT(this->boxFilter() && nullptr != src);
+    if (fFilterRowCount >= this->sampleY()) {
+        return;
+    }
+
+    // Procs that skip leading transparent pixels rely on zero-initialized memory.
+    sk_bzero(fFilterRow.get(), SkToSizeT(fSrcWidth) * fDstBPP);
+    const RowProc proc = fFastProc ? fFastProc : fSlowProc;
+    proc(fFilterRow.get(), src, fSrcWidth, fSrcBPP, fSrcBPP, fSrcOffset * fSrcBPP, fColorTable);
+
+    if (1 == fDstBPP) {
+        box_accumulate<1, false>(fFilterSums.get(), fFilterRow.get(), fSwizzleWidth, fSrcWidth,
+                                 fSampleX);
+    } else if (kUnpremul_SkAlphaType == fDstAlphaType) {
+        box_accumulate<4, true>(fFilterSums.get(), fFilterRow.get(), fSwizzleWidth, fSrcWidth,
+                                fSampleX);
+    } else {
+        box_accumulate<4, false>(fFilterSums.get(), fFilterRow.get(), fSwizzleWidth, fSrcWidth,
+                                 fSampleX);
+    }
+    fFilterRowCount++;
+}
+
+void SkSwizzler::writeFilteredRow(void* dst) {
+    uint8_t* dstRow = static_cast<uint8_t*>(dst);
+    if (1 == fDstBPP) {
+        box_resolve<1, false>(dstRow, fFilterSums.get(), fSwizzleWidth, fSrcWidth, fSampleX,
+                              fFilterRowCount);
+    } else if (kUnpremul_SkAlphaType == fDstAlphaType) {
+        box_resolve<4, true>(dstRow, fFilterSums.get(), fSwizzleWidth, fSrcWidth, fSampleX,
+                             fFilterRowCount);
+    } else {
+        box_resolve<4, false>(dstRow, fFilterSums.get(), fSwizzleWidth, fSrcWidth, fSampleX,
+                              fFilterRowCount);
+    }
+    fFilterRowCount = 0;
+}
+
 void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
+    if (this->boxFilter()) {
+        this->accumulateRow(src);
+        if (fFilterRowCount == this->sampleY()) {
+            this->writeFilteredRow(SkTAddOffset<void>(dst, fDstOffsetBytes));
+        }
+        return;
+    }
     fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
             fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
 }
@@ -9,8 +9,11 @@
 #define SkSwizzler_DEFINED
 
 #include "include/codec/SkCodec.h"
+#include "include/core/SkAlphaType.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkTypes.h"
+#include "include/private/SkTemplates.h"
 #include "src/codec/SkSampler.h"
 
 #include <cstddef>
@@ -73,9 +76,20 @@ public:
      *  subset decodes.
      *  @param dst Where we write the output.
      *  @param src The next row of the source data.
+     *
+     *  When box filtering (see SkSampler::setBoxFilter()), this adds src to the rows
+     *  accumulated so far and, once sampleY() rows have been accumulated, writes their
+     *  average to dst. Otherwise dst is left untouched.
      */
     void swizzle(void* dst, const uint8_t* SK_RESTRICT src);
 
+    /**
+     *  When box filtering, add a row that is not needed in the output (i.e. rowNeeded() is
+     *  false) to the block of rows that will be averaged by the next call to swizzle().
+     *  Rows beyond the last complete block are ignored.
+     */
+    void accumulateRow(const uint8_t* SK_RESTRICT src);
+
     int fillWidth() const override {
         return fAllocatedWidth;
     }
@@ -224,15 +238,28 @@ private:
                                           // else
                                           //     fBPP is bitsPerPixel
     const int           fDstBPP;          // Bytes per pixel for the destination color type
+    const SkColorType   fDstColorType;
+    const SkAlphaType   fDstAlphaType;
+
+    // Box filtering
+    // When enabled, each source row is swizzled without sampling into fFilterRow and summed
+    // per channel into fFilterSums (fSwizzleWidth pixels wide).  Unpremul colors are weighted
+    // by alpha so that transparent pixels do not bleed into their neighbors.
+    skia_private::AutoTMalloc<uint8_t>  fFilterRow;
+    skia_private::AutoTMalloc<uint32_t> fFilterSums;
+    int                                 fFilterRowCount;
 
     SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable, int srcOffset,
-            int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP);
+            int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP,
+            SkColorType dstColorType, SkAlphaType dstAlphaType);
     static std::unique_ptr<SkSwizzler> Make(const SkImageInfo& dstInfo, RowProc fastProc,
             RowProc proc, const SkPMColor* ctable, int srcBPP, int dstBPP,
             const SkCodec::Options& options, const SkIRect* frame);
 
     int onSetSampleX(int) override;
+    bool onSetBoxFilter() override;
 
+    void writeFilteredRow(void* dst);
 };
 
 #endif // SkSwizzler_DEFINED
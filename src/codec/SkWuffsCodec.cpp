@@ -83,7 +83,32 @@
 #define SK_WUFFS_INITIALIZE_FLAGS WUFFS_INITIALIZE__DEFAULT_OPTIONS
 #endif
 
+// Returns whether b reads the encoded bytes in place from s's memory (see
+// alias_stream_memory), rather than from a staging buffer filled by s->read.
+static bool is_stream_memory(const wuffs_base__io_buffer* b, SkStream* s) {
+    return b->data.ptr && (b->data.ptr == s->getMemoryBase());
+}
+
+// If s is backed by memory (e.g. an SkMemoryStream wrapping a mapped file),
+// point b at all of it instead of at a staging buffer, so that Wuffs decodes
+// directly from that memory and no encoded bytes are copied.
+static bool alias_stream_memory(wuffs_base__io_buffer* b, SkStream* s) {
+    const void* base = s->getMemoryBase();
+    if (!base || !s->hasLength() || !s->hasPosition() || (s->getLength() == 0)) {
+        return false;
+    }
+    // Wuffs only reads through b, but its slice type is not const.
+    b->data = wuffs_base__make_slice_u8(static_cast<uint8_t*>(const_cast<void*>(base)),
+                                        s->getLength());
+    b->meta = wuffs_base__make_io_buffer_meta(s->getLength(), s->getPosition(), 0, false);
+    return true;
+}
+
 static bool fill_buffer(wuffs_base__io_buffer* b, SkStream* s) {
+    if (is_stream_memory(b, s)) {
+        // All of the stream is already in b.
+        return false;
+    }
     b->compact();
     size_t num_read = s->read(b->data.ptr + b->meta.wi, b->data.len - b->meta.wi);
     b->meta.wi += num_read;
@@ -119,8 +144,9 @@ static bool seek_buffer(wuffs_base__io_buffer* b, SkStream* s, uint64_t pos) {
         b->meta.ri = pos - b->meta.pos;
         return true;
     }
-    // Seek in the backing SkStream.
-    if ((pos > SIZE_MAX) || (!s->seek(pos))) {
+    // Seek in the backing SkStream. When reading from its memory, b already
+    // holds all of it, so there is nothing further to seek to.
+    if ((pos > SIZE_MAX) || is_stream_memory(b, s) || (!s->seek(pos))) {
         return false;
     }
     b->meta.wi = 0;
@@ -420,6 +446,13 @@ SkWuffsCodec::SkWuffsCodec(SkEncodedInfo&& encodedInfo,
         , fCanSeek(canSeek) {
     fFrameHolder.init(this, imgcfg.pixcfg.width(), imgcfg.pixcfg.height());
 
+    // An iobuf that reads in place from the stream's memory stays valid for as
+    // long as we own the stream.
+    if (is_stream_memory(&iobuf, fPrivStream.get())) {
+        fIOBuffer = iobuf;
+        return;
+    }
+
     // Initialize fIOBuffer's fields, copying any outstanding data from iobuf to
     // fIOBuffer, as iobuf's backing array may not be valid for the lifetime of
     // this SkWuffsCodec object, but fIOBuffer's backing array (fBuffer) is.
@@ -942,7 +975,11 @@ SkCodec::Result SkWuffsCodec::resetDecoder() {
     if (!fPrivStream->rewind()) {
         return SkCodec::kInternalError;
     }
-    fIOBuffer.meta = wuffs_base__empty_io_buffer_meta();
+    if (is_stream_memory(&fIOBuffer, fPrivStream.get())) {
+        SkAssertResult(alias_stream_memory(&fIOBuffer, fPrivStream.get()));
+    } else {
+        fIOBuffer.meta = wuffs_base__empty_io_buffer_meta();
+    }
 
     SkCodec::Result result =
         reset_and_decode_image_config(fDecoder.get(), nullptr, &fIOBuffer, fPrivStream.get());
@@ -1046,6 +1083,7 @@ std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream> stream,
     wuffs_base__io_buffer iobuf =
         wuffs_base__make_io_buffer(wuffs_base__make_slice_u8(buffer, SK_WUFFS_CODEC_BUFFER_SIZE),
                                    wuffs_base__empty_io_buffer_meta());
+    alias_stream_memory(&iobuf, stream.get());
     wuffs_base__image_config imgcfg = wuffs_base__null_image_config();
 
     // Wuffs is primarily a C library, not a C++ one. Furthermore, outside of
@@ -29,6 +29,7 @@
 #include "include/private/SkFeatures.h"
 #include "include/private/SkMalloc.h"
 #include "include/private/SkMath.h"
+#include "include/private/SkTPin.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBitmapDevice.h"
@@ -1270,6 +1271,295 @@ public:
 
 };
 
+// Converts the triple box sums back to pixels. The 8-bit formats keep exact integer sums and
+// round them the same way ThreeBoxApproxPass does, so the two produce identical results. A
+// divisor of 1 (an identity window) passes the sums through.
+class BoxScale8 {
+public:
+    explicit BoxScale8(uint32_t divisor)
+            : fFactor((uint64_t)std::round((1.0 / divisor) * (1ull << 32)))
+            , fHalf(divisor > 1 ? (divisor + 1) >> 1 : 0) {}
+
+    skvx::Vec<16, uint8_t> operator()(const skvx::Vec<16, uint32_t>& sum) const {
+        return skvx::cast<uint8_t>((skvx::cast<uint64_t>(sum + fHalf) * fFactor) >> 32);
+    }
+
+private:
+    const uint64_t fFactor;
+    const uint32_t fHalf;
+};
+
+class BoxScaleF16 {
+public:
+    explicit BoxScaleF16(uint32_t divisor) : fScale(1.f / divisor) {}
+
+    skvx::Vec<16, uint16_t> operator()(const skvx::Vec<16, float>& sum) const {
+        return skvx::to_half(sum * fScale);
+    }
+
+private:
+    const float fScale;
+};
+
+// Traits for RasterBoxBlurAlgorithm. Each describes how kLines pixels, one from each of kLines
+// adjacent lines, are widened into a single vector of running sums and narrowed back again.
+struct Box8888 {
+    using Pixel = uint32_t;
+    using Sum = skvx::Vec<16, uint32_t>;
+    using Scale = BoxScale8;
+    static constexpr int kLines = 4;
+
+    static Sum Load(const Pixel* const lines[kLines], int i) {
+        skvx::Vec<4, uint32_t> pixels = {lines[0][i], lines[1][i], lines[2][i], lines[3][i]};
+        return skvx::cast<uint32_t>(sk_bit_cast<skvx::Vec<16, uint8_t>>(pixels));
+    }
+};
+
+struct BoxA8 {
+    using Pixel = uint8_t;
+    using Sum = skvx::Vec<16, uint32_t>;
+    using Scale = BoxScale8;
+    static constexpr int kLines = 16;
+
+    static Sum Load(const Pixel* const lines[kLines], int i) {
+        return {lines[ 0][i], lines[ 1][i], lines[ 2][i], lines[ 3][i],
+                lines[ 4][i], lines[ 5][i], lines[ 6][i], lines[ 7][i],
+                lines[ 8][i], lines[ 9][i], lines[10][i], lines[11][i],
+                lines[12][i], lines[13][i], lines[14][i], lines[15][i]};
+    }
+};
+
+struct BoxF16 {
+    using Pixel = uint64_t;
+    using Sum = skvx::Vec<16, float>;
+    using Scale = BoxScaleF16;
+    static constexpr int kLines = 4;
+
+    static Sum Load(const Pixel* const lines[kLines], int i) {
+        skvx::Vec<4, uint64_t> pixels = {lines[0][i], lines[1][i], lines[2][i], lines[3][i]};
+        return skvx::from_half(sk_bit_cast<skvx::Vec<16, uint16_t>>(pixels));
+    }
+};
+
+// How many lines box_blur_lines_transposed() blurs before writing them out: enough to fill a
+// 64-byte cache line of each dst row, and at least kLines.
+template <typename Traits>
+constexpr int box_block_lines() {
+    return std::max(Traits::kLines, 64 / (int)sizeof(typename Traits::Pixel));
+}
+
+// Maps 'i' into [0, n) according to 'tileMode', or returns -1 if it reads transparent black.
+int box_tile(int i, int n, SkTileMode tileMode) {
+    switch (tileMode) {
+        case SkTileMode::kDecal:  return -1;
+        case SkTileMode::kClamp:  return SkTPin(i, 0, n - 1);
+        case SkTileMode::kRepeat: return ((i % n) + n) % n;
+        case SkTileMode::kMirror: {
+            int m = ((i % (2 * n)) + 2 * n) % (2 * n);
+            return m < n ? m : 2 * n - 1 - m;
+        }
+    }
+    SkUNREACHABLE;
+}
+
+// The distance from an output pixel to the furthest source pixel that contributes to it, for
+// the three box passes of the given window. See ThreeBoxApproxPass for the derivation.
+int box_border(int window) {
+    return (window & 1) == 1 ? 3 * ((window - 1) / 2) : 3 * (window / 2) - 1;
+}
+
+// Replaces sums[0, n - window] with the sums of each run of 'window' consecutive values.
+template <typename Sum>
+void box_sum_in_place(Sum* sums, int n, int window) {
+    Sum sum = 0;
+    for (int i = 0; i < window - 1; ++i) {
+        sum += sums[i];
+    }
+    for (int i = 0; i + window <= n; ++i) {
+        sum += sums[i + window - 1];
+        Sum trailing = sums[i];
+        sums[i] = sum;
+        sum -= trailing;
+    }
+}
+
+// Blurs 'lineCount' lines of 'srcLength' pixels, each 'srcLineStride' pixels apart, with the
+// triple box approximation of the given window, and writes the result transposed: the output
+// for position j of line l is dst[j * dstStride + l]. Output position j samples the source
+// at 'dstOffset' + j, with 'tileMode' applied beyond [0, srcLength).
+//
+// Blurring kLines lines at once lets the running sums fill a full vector, and since the output
+// is transposed, calling this twice blurs both axes while only ever reading along rows. Lines
+// are blurred a cache line's worth at a time into 'block', which holds dstLength x
+// kBlockLines pixels, so that each dst row is then written a whole cache line at a time rather
+// than kLines pixels at a time.
+template <typename Traits>
+void box_blur_lines_transposed(const typename Traits::Pixel* src, size_t srcLineStride,
+                               int lineCount, int srcLength, SkTileMode tileMode,
+                               int window, int dstOffset, int dstLength,
+                               typename Traits::Pixel* dst, size_t dstStride,
+                               typename Traits::Sum* sums, typename Traits::Pixel* block) {
+    using Pixel = typename Traits::Pixel;
+    using Sum = typename Traits::Sum;
+    static constexpr int kLines = Traits::kLines;
+    static constexpr int kBlockLines = box_block_lines<Traits>();
+
+    // See ThreeBoxApproxPass for the divisor of odd and even windows.
+    const bool odd = (window & 1) == 1;
+    const int border = box_border(window);
+    const uint32_t divisor = odd ? window * window * window
+                                 : window * window * (window + 1);
+    const typename Traits::Scale scale(divisor);
+    const int sumCount = dstLength + 2 * border;
+    const int srcStart = dstOffset - border;
+
+    for (int blockStart = 0; blockStart < lineCount; blockStart += kBlockLines) {
+        const int blockLines = std::min(kBlockLines, lineCount - blockStart);
+        for (int group = 0; group < blockLines; group += kLines) {
+            const int line = blockStart + group;
+            const int lines = std::min(kLines, lineCount - line);
+            const Pixel* srcLines[kLines];
+            for (int l = 0; l < kLines; ++l) {
+                // Past the last line, re-read it; those lanes are never copied to dst.
+                srcLines[l] = src + (line + std::min(l, lines - 1)) * srcLineStride;
+            }
+
+            for (int i = 0; i < sumCount; ++i) {
+                int s = srcStart + i;
+                if (s < 0 || s >= srcLength) {
+                    s = box_tile(s, srcLength, tileMode);
+                }
+                sums[i] = s < 0 ? Sum(0) : Traits::Load(srcLines, s);
+            }
+
+            if (window > 1) {
+                box_sum_in_place(sums, sumCount, window);
+                box_sum_in_place(sums, sumCount - (window - 1), window);
+                box_sum_in_place(sums, sumCount - 2 * (window - 1), odd ? window : window + 1);
+            }
+
+            Pixel* blockCursor = block + group;
+            for (int j = 0; j < dstLength; ++j, blockCursor += kBlockLines) {
+                scale(sums[j]).store(blockCursor);
+            }
+        }
+
+        const Pixel* blockCursor = block;
+        Pixel* dstCursor = dst + blockStart;
+        for (int j = 0; j < dstLength; ++j, blockCursor += kBlockLines, dstCursor += dstStride) {
+            memcpy(dstCursor, blockCursor, blockLines * sizeof(Pixel));
+        }
+    }
+}
+
+// A separable triple box blur for 8888, A8 and F16 images that handles every tile mode. Each axis
+// is blurred by box_blur_lines_transposed(), vectorized across adjacent lines; the X pass writes
+// its result transposed into a scratch image, so the Y pass reads it along rows as well and
+// transposes it back into the destination.
+class RasterBoxBlurAlgorithm : public SkBlurEngine::Algorithm {
+public:
+    // The successive box approximation is too inaccurate below this, see BoxBlurWindow().
+    static constexpr float kMinSigma = 2.f;
+
+    static bool Supports(SkSize sigma, SkColorType colorType) {
+        auto boxable = [](float s) {
+            return SkBlurEngine::IsEffectivelyIdentity(s) || s >= kMinSigma;
+        };
+        return boxable(sigma.width()) && boxable(sigma.height()) &&
+               (colorType == kRGBA_8888_SkColorType || colorType == kBGRA_8888_SkColorType ||
+                colorType == kAlpha_8_SkColorType || colorType == kRGBA_F16_SkColorType ||
+                colorType == kRGBA_F16Norm_SkColorType);
+    }
+
+    // Keeps the window below 255 so the 8-bit sums fit in 32 bits; see ThreeBoxApproxPass.
+    float maxSigma() const override {
+        static constexpr float kMaxSigma = 135.f;
+        SkASSERT(SkBlurEngine::BoxBlurWindow(kMaxSigma) <= 255);
+        return kMaxSigma;
+    }
+
+    // The running sums cost the same for any window, so a large blur is only faster by touching
+    // fewer pixels. Downscaling to this sigma keeps the error within a couple of 8-bit steps of
+    // the full resolution blur (the window rounds to an integer either way) while doing a small
+    // fraction of the work for the sigma 50-200 blurs typical of drop shadows.
+    float maxFullResolutionSigma() const override { return 24.f; }
+
+    bool supportsOnlyDecalTiling() const override { return false; }
+
+    sk_sp<SkSpecialImage> blur(SkSize sigma,
+                               sk_sp<SkSpecialImage> input,
+                               const SkIRect& srcRect,
+                               SkTileMode tileMode,
+                               const SkIRect& dstRect) const override {
+        SkASSERT(!srcRect.isEmpty());
+        SkASSERT(SkIRect::MakeSize(input->dimensions()).contains(srcRect));
+
+        SkBitmap src;
+        if (!SkSpecialImages::AsBitmap(input.get(), &src)) {
+            return nullptr; // Should only have been called by CPU-backed images
+        }
+
+        switch (src.colorType()) {
+            case kRGBA_8888_SkColorType:
+            case kBGRA_8888_SkColorType:
+                return Blur<Box8888>(sigma, src, srcRect, tileMode, dstRect);
+            case kAlpha_8_SkColorType:
+                return Blur<BoxA8>(sigma, src, srcRect, tileMode, dstRect);
+            case kRGBA_F16_SkColorType:
+            case kRGBA_F16Norm_SkColorType:
+                return Blur<BoxF16>(sigma, src, srcRect, tileMode, dstRect);
+            default:
+                SkDEBUGFAIL("The blur engine should not have picked this algorithm.");
+                return nullptr;
+        }
+    }
+
+private:
+    template <typename Traits>
+    static sk_sp<SkSpecialImage> Blur(SkSize sigma,
+                                      const SkBitmap& src,
+                                      const SkIRect& srcRect,
+                                      SkTileMode tileMode,
+                                      const SkIRect& dstRect) {
+        using Pixel = typename Traits::Pixel;
+        using Sum = typename Traits::Sum;
+        SkASSERT(src.bytesPerPixel() == sizeof(Pixel));
+
+        const int windowX = SkBlurEngine::BoxBlurWindow(sigma.width());
+        const int windowY = SkBlurEngine::BoxBlurWindow(sigma.height());
+
+        // The X pass output, transposed: row x holds dst column x for every source row.
+        SkBitmap columns;
+        SkBitmap dst;
+        if (!columns.tryAllocPixels(src.info().makeWH(srcRect.height(), dstRect.width())) ||
+            !dst.tryAllocPixels(src.info().makeWH(dstRect.width(), dstRect.height()))) {
+            return nullptr;
+        }
+
+        SkArenaAlloc alloc(0);
+        Sum* sums = alloc.makeArrayDefault<Sum>(
+                std::max(dstRect.width()  + 2 * box_border(windowX),
+                         dstRect.height() + 2 * box_border(windowY)));
+        Pixel* block = alloc.makeArrayDefault<Pixel>(
+                std::max(dstRect.width(), dstRect.height()) * box_block_lines<Traits>());
+
+        box_blur_lines_transposed<Traits>(
+                static_cast<const Pixel*>(src.getAddr(srcRect.left(), srcRect.top())),
+                src.rowBytesAsPixels(), srcRect.height(), srcRect.width(), tileMode,
+                windowX, dstRect.left() - srcRect.left(), dstRect.width(),
+                static_cast<Pixel*>(columns.getPixels()), columns.rowBytesAsPixels(),
+                sums, block);
+        box_blur_lines_transposed<Traits>(
+                static_cast<const Pixel*>(columns.getPixels()),
+                columns.rowBytesAsPixels(), dstRect.width(), srcRect.height(), tileMode,
+                windowY, dstRect.top() - srcRect.top(), dstRect.height(),
+                static_cast<Pixel*>(dst.getPixels()), dst.rowBytesAsPixels(), sums, block);
+
+        return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()), dst,
+                                               SkSurfaceProps{});
+    }
+};
+
 class RasterShaderBlurAlgorithm : public SkShaderBlurAlgorithm {
 public:
     sk_sp<SkDevice> makeDevice(const SkImageInfo& imageInfo) const override {
@@ -1282,7 +1572,15 @@ public:
 
 class RasterBlurEngine : public SkBlurEngine {
 public:
+    explicit RasterBlurEngine(bool useBoxBlur) : fUseBoxBlur(useBoxBlur) {}
+
     const Algorithm* findAlgorithm(SkSize sigma,  SkColorType colorType) const override {
+        // Blurs large enough for the box approximation on both axes use the separable box blur,
+        // which also applies the tile mode itself.
+        if (fUseBoxBlur && RasterBoxBlurAlgorithm::Supports(sigma, colorType)) {
+            return &fBoxBlurAlgorithm;
+        }
+
         // The box blur doesn't actually care about channel order as long as it's 4 8-bit channels.
         const bool rgba8Blur = colorType == kRGBA_8888_SkColorType ||
                                colorType == kBGRA_8888_SkColorType;
@@ -1300,6 +1598,9 @@ public:
     }
 
 private:
+    const bool fUseBoxBlur;
+    // For 8888, A8 and F16 blurs with sigma >= 2 (or identity) on both axes
+    RasterBoxBlurAlgorithm fBoxBlurAlgorithm;
     // For non-A8 or non-8888, use the shader algorithm
     RasterShaderBlurAlgorithm fShaderBlurAlgorithm;
     // For large blurs with RGBA8 or BGRA8, use consecutive box blurs,
@@ -1313,7 +1614,12 @@ private:
 } // anonymous namespace
 
 const SkBlurEngine* SkBlurEngine::GetRasterBlurEngine() {
-    static const RasterBlurEngine kInstance;
+    static const RasterBlurEngine kInstance{/*useBoxBlur=*/true};
+    return &kInstance;
+}
+
+const SkBlurEngine* SkBlurEngine::GetRasterScanlineBlurEngine() {
+    static const RasterBlurEngine kInstance{/*useBoxBlur=*/false};
     return &kInstance;
 }
 
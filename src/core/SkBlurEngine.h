@@ -71,11 +71,17 @@ public:
         return IsEffectivelyIdentity(sigma) ? 0 : sk_float_ceil2int(3.f * sigma);
     }
 
-    // Get the default CPU-backed SkBlurEngine. This has specialized algorithms for 32-bit RGBA
-    // and BGRA colors, and A8 alpha-only images when the sigma is large enough. For small blurs
-    // and other color types, it uses SkShaderBlurAlgorithm backed by the raster pipeline.
+    // Get the default CPU-backed SkBlurEngine. When the sigma is large enough on both axes, it uses
+    // a separable, vectorized triple box blur for 32-bit RGBA and BGRA, A8 and F16 images that
+    // handles all tile modes. Smaller 8-bit blurs use per-scanline passes, and the remaining
+    // cases use SkShaderBlurAlgorithm backed by the raster pipeline.
     static const SkBlurEngine* GetRasterBlurEngine();
 
+    // The raster engine without the separable box blur, i.e. per-scanline passes for all 8-bit
+    // blurs and SkShaderBlurAlgorithm otherwise. Exposed for tests and benchmarks that compare
+    // the two.
+    static const SkBlurEngine* GetRasterScanlineBlurEngine();
+
     // TODO: These are internal functions of the raster blur engine but need to be public for legacy
     // code paths to invoke them directly.
 
@@ -100,6 +106,12 @@ public:
     // requested sigmas must manually downscale the input image and upscale the output image.
     virtual float maxSigma() const = 0;
 
+    // The largest sigma that is worth blurring at full resolution. Larger sigmas, up to maxSigma(),
+    // are still supported, but callers that can rescale (e.g. skif::FilterResult::Builder::blur())
+    // should blur them at a reduced resolution and upscale the result, which is much faster and
+    // whose error is hidden by the blur.
+    virtual float maxFullResolutionSigma() const { return this->maxSigma(); }
+
     // Whether or not the SkTileMode can be passed to blur() must be SkTileMode::kDecal, or if any
     // tile mode is supported. If only kDecal is supported, then callers must manually apply the
     // tilemode and account for that in the src and dst bounds passed into blur(). If this returns
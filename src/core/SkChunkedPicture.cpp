@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkChunkedPicture.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkStream.h"
+#include "include/private/SkAssert.h"
+#include "include/private/SkDebug.h"
+
+#include <utility>
+
+SkChunkedPicture::SkChunkedPicture(const SkRect& cull,
+                                   int opCount,
+                                   int nestedOpCount,
+                                   std::unique_ptr<Chunk[]> chunks,
+                                   int chunkCount,
+                                   sk_sp<const SkData> chunkData,
+                                   const SkDeserialProcs& procs,
+                                   int recursionLimit)
+    : fCullRect(cull)
+    , fOpCount(opCount)
+    , fNestedOpCount(nestedOpCount)
+    , fChunks(std::move(chunks))
+    , fChunkCount(chunkCount)
+    , fDecoded(new Decoded[chunkCount])
+    , fChunkData(std::move(chunkData))
+    , fProcs(procs)
+    , fRecursionLimit(recursionLimit) {}
+
+SkChunkedPicture::~SkChunkedPicture() = default;
+
+const SkPicture* SkChunkedPicture::chunkPicture(int index) const {
+    Decoded& decoded = fDecoded[index];
+    decoded.fOnce([&] {
+        const Chunk& chunk = fChunks[index];
+        SkMemoryStream stream(fChunkData->bytes() + chunk.fOffset, chunk.fSize);
+        decoded.fPicture = MakeFromStreamPriv(&stream, &fProcs, nullptr, fRecursionLimit,
+                                              fChunkData.get());
+        if (!decoded.fPicture) {
+            SkDEBUGF("SkChunkedPicture: chunk %d of %d failed to deserialize\n",
+                     index, fChunkCount);
+        }
+    });
+    return decoded.fPicture.get();
+}
+
+void SkChunkedPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+
+    const SkRect clip = canvas->getLocalClipBounds();
+    for (int i = 0; i < fChunkCount; i++) {
+        if (callback && callback->abort()) {
+            return;
+        }
+        if (!SkRect::Intersects(fChunks[i].fBounds, clip)) {
+            continue;
+        }
+        // Each chunk saves, clips to its bounds and restores.
+        if (const SkPicture* picture = this->chunkPicture(i)) {
+            picture->playback(canvas, callback);
+        }
+    }
+}
+
+SkRect SkChunkedPicture::cullRect() const { return fCullRect; }
+int SkChunkedPicture::approximateOpCount(bool nested) const {
+    return nested ? fNestedOpCount : fOpCount;
+}
+size_t SkChunkedPicture::approximateBytesUsed() const {
+    // Chunks are held as serialized data, which is not counted.
+    return sizeof(*this) + fChunkCount * (sizeof(Chunk) + sizeof(Decoded));
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkChunkedPicture_DEFINED
+#define SkChunkedPicture_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/private/SkOnce.h"
+
+#include <cstddef>
+#include <memory>
+
+class SkCanvas;
+
+// An SkPicture read from data written by SkPicture::serializeChunked(). Each chunk is a complete
+// serialized picture covering part of the cull rect; a chunk is only deserialized the first time
+// a playback's clip intersects its bounds.
+class SkChunkedPicture final : public SkPicture {
+public:
+    struct Chunk {
+        SkRect fBounds;
+        size_t fOffset;  // into the chunk data
+        size_t fSize;
+    };
+
+    // procs are kept to deserialize chunks during playback.
+    SkChunkedPicture(const SkRect& cull,
+                     int opCount,
+                     int nestedOpCount,
+                     std::unique_ptr<Chunk[]> chunks,
+                     int chunkCount,
+                     sk_sp<const SkData> chunkData,
+                     const SkDeserialProcs& procs,
+                     int recursionLimit);
+    ~SkChunkedPicture() override;
+
+    void playback(SkCanvas*, AbortCallback*) const override;
+
+    SkRect cullRect()                         const override;
+    int    approximateOpCount(bool nested)    const override;
+    size_t approximateBytesUsed()             const override;
+
+private:
+    const SkPicture* chunkPicture(int index) const;
+
+    struct Decoded {
+        SkOnce           fOnce;
+        sk_sp<SkPicture> fPicture;
+    };
+
+    const SkRect                      fCullRect;
+    const int                         fOpCount;
+    const int                         fNestedOpCount;
+    const std::unique_ptr<Chunk[]>    fChunks;
+    const int                         fChunkCount;
+    const std::unique_ptr<Decoded[]>  fDecoded;
+    const sk_sp<const SkData>         fChunkData;
+    const SkDeserialProcs             fProcs;
+    const int                         fRecursionLimit;
+};
+
+#endif
@@ -11,6 +11,7 @@
 #include "src/core/SkBlitMask.h"
 #include "src/core/SkBlitRow.h"
 #include "src/core/SkCpu.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkOpts.h"
@@ -99,6 +100,36 @@ void SkGraphics::PurgeResourceCache() {
     return SkResourceCache::PurgeAll();
 }
 
+SkGraphics::ImageFilterCacheStats SkGraphics::GetImageFilterCacheStats() {
+    ImageFilterCacheStats stats;
+    auto cache = SkImageFilterCache::Get(SkImageFilterCache::CreateIfNecessary::kNo);
+    if (!cache) {
+        return stats;
+    }
+    const SkImageFilterCache::Stats cacheStats = cache->stats();
+    stats.fHits = cacheStats.fTotal.fHits;
+    stats.fMisses = cacheStats.fMisses;
+    stats.fCrossFrameHits = cacheStats.fCrossFrameHits;
+    stats.fInserts = cacheStats.fTotal.fInserts;
+    stats.fEvictions = cacheStats.fTotal.fEvictions;
+    stats.fBytesUsed = cacheStats.fTotal.fBytes;
+    stats.fByteLimit = cacheStats.fMaxBytes;
+    stats.fEntryCount = cacheStats.fTotal.fEntries;
+    return stats;
+}
+
+void SkGraphics::ResetImageFilterCacheStats() {
+    if (auto cache = SkImageFilterCache::Get(SkImageFilterCache::CreateIfNecessary::kNo)) {
+        cache->resetStats();
+    }
+}
+
+void SkGraphics::NotifyImageFilterCacheNewFrame() {
+    if (auto cache = SkImageFilterCache::Get(SkImageFilterCache::CreateIfNecessary::kNo)) {
+        cache->newFrame();
+    }
+}
+
 static int gTypefaceCacheCountLimit = 1024; // historical default value
 
 int SkGraphics::GetTypefaceCacheCountLimit() {
@@ -24,6 +24,7 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTHash.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
@@ -33,6 +34,7 @@
 #include <cstdint>
 #include <optional>
 #include <utility>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // SkImageFilter - A number of the public APIs on SkImageFilter downcast to SkImageFilter_Base
@@ -228,7 +230,43 @@ void SkImageFilter_Base::flatten(SkWriteBuffer& buffer) const {
     }
 }
 
+// Returns the sorted unique IDs of the filters that are an input more than once in the DAG rooted
+// at 'root', whether to one filter or to several.
+static std::vector<uint32_t> shared_filter_ids(const SkImageFilter* root) {
+    skia_private::THashMap<uint32_t, int> consumers;
+    std::vector<uint32_t> shared;
+    std::vector<const SkImageFilter*> pending = {root};
+    while (!pending.empty()) {
+        const SkImageFilter* filter = pending.back();
+        pending.pop_back();
+        for (int i = 0; i < filter->countInputs(); ++i) {
+            const SkImageFilter* input = filter->getInput(i);
+            if (!input) {
+                continue;
+            }
+            const uint32_t id = as_IFB(input)->uniqueID();
+            int* count = consumers.find(id);
+            if (!count) {
+                consumers.set(id, 1);
+                pending.push_back(input);
+            } else if (++*count == 2) {
+                shared.push_back(id);
+            }
+        }
+    }
+    std::sort(shared.begin(), shared.end());
+    return shared;
+}
+
 skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context) const {
+    // The root of the DAG finds the filters whose results are consumed more than once, so that
+    // they are cached as likely to be reused: their other consumers may not get to them until a
+    // run of one-off results has gone through the cache.
+    if (!context.sharedFilterIDs() && context.backend()->cache() && this->countInputs() > 0) {
+        const std::vector<uint32_t> shared = shared_filter_ids(this);
+        return this->filterImage(context.withSharedFilterIDs(&shared));
+    }
+
     context.markVisitedImageFilter();
 
     skif::FilterResult result;
@@ -256,7 +294,10 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
     result = this->onFilterImage(context);
 
     if (context.backend()->cache()) {
-        context.backend()->cache()->set(key, this, result);
+        context.backend()->cache()->set(key, this, result,
+                                        context.isSharedFilter(fUniqueID)
+                                                ? SkImageFilterCache::Retention::kLikelyReused
+                                                : SkImageFilterCache::Retention::kDefault);
     }
 
     return result;
@@ -385,6 +426,17 @@ skif::FilterResult SkImageFilter_Base::getChildOutput(int index, const skif::Con
     return input ? as_IFB(input)->filterImage(ctx) : ctx.source();
 }
 
+skia_private::TArray<skif::FilterResult> SkImageFilter_Base::getChildOutputs(
+        const skif::Context& ctx) const {
+    const int inputCount = this->countInputs();
+    skia_private::TArray<skif::FilterResult> outputs;
+    outputs.push_back_n(inputCount);
+    ctx.parallelFor(inputCount, [&](int i, const skif::Context& inputCtx) {
+        outputs[i] = this->getChildOutput(i, inputCtx);
+    });
+    return outputs;
+}
+
 void SkImageFilter_Base::PurgeCache() {
     auto cache = SkImageFilterCache::Get(SkImageFilterCache::CreateIfNecessary::kNo);
     if (cache) {
@@ -7,6 +7,7 @@
 
 #include "src/core/SkImageFilterCache.h"
 
+#include "include/core/SkImageFilter.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkOnce.h"
 #include "src/core/SkChecksum.h"
@@ -16,6 +17,9 @@
 #include "src/core/SkTHash.h"
 #include "src/core/SkTInternalLList.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <vector>
 
 using namespace skia_private;
@@ -28,21 +32,52 @@ using namespace skia_private;
 
 namespace {
 
+// Small caches keep a single, exact LRU. Larger ones get one shard per 4MB of budget, up to 16.
+static constexpr size_t kMinBytesPerShard = 4 * 1024 * 1024;
+static constexpr int kMaxShards = 16;
+
+int shard_count(size_t maxBytes) {
+    int count = 1;
+    while (count < kMaxShards && (count * 2) * kMinBytesPerShard <= maxBytes) {
+        count *= 2;
+    }
+    return count;
+}
+
+size_t result_size(const skif::FilterResult& result) {
+    return result.image() ? result.image()->getSize() : 0;
+}
+
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes)
+            : fShardCount(shard_count(maxBytes))
+            , fMaxBytes(maxBytes)
+            , fCurrentBytes(0)
+            , fFrame(0) {}
     ~CacheImpl() override {
-        fLookup.foreach([&](Value* v) { delete v; });
+        for (int i = 0; i < fShardCount; ++i) {
+            fShards[i].fLookup.foreach([&](Value* v) { delete v; });
+        }
     }
     struct Value {
         Value(const Key& key, const skif::FilterResult& image,
-              const SkImageFilter* filter)
-            : fKey(key), fImage(image), fFilter(filter) {}
+              const SkImageFilter* filter, uint32_t frame)
+            : fKey(key)
+            , fImage(image)
+            , fFilter(filter)
+            , fTypeName(filter ? filter->getTypeName() : "null")
+            , fBytes(result_size(image))
+            , fLastUsedFrame(frame) {}
 
         Key fKey;
         skif::FilterResult fImage;
         const SkImageFilter* fFilter;
+        const char* fTypeName;
+        size_t fBytes;
+        uint32_t fLastUsedFrame;
+        bool fProtected = false;
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
@@ -55,76 +90,242 @@ public:
     bool get(const Key& key, skif::FilterResult* result) const override {
         SkASSERT(result);
 
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
+        Shard& shard = this->shardFor(key);
+        SkAutoMutexExclusive mutex(shard.fMutex);
+        if (Value* v = shard.fLookup.find(key)) {
+            const uint32_t frame = fFrame.load(std::memory_order_relaxed);
+            if (v->fLastUsedFrame != frame) {
+                shard.fCrossFrameHits++;
+                v->fLastUsedFrame = frame;
             }
+            shard.fByType.find(v->fTypeName)->fHits++;
+            this->markUsed(&shard, v);
 
             *result = v->fImage;
             return true;
         }
+        shard.fMisses++;
         return false;
     }
 
     void set(const Key& key, const SkImageFilter* filter,
-             const skif::FilterResult& result) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            this->removeInternal(v);
-        }
-        Value* v = new Value(key, result, filter);
-        fLookup.add(v);
-        fLRU.addToHead(v);
-        fCurrentBytes += result.image() ? result.image()->getSize() : 0;
-        if (auto* values = fImageFilterValues.find(filter)) {
-            values->push_back(v);
-        } else {
-            fImageFilterValues.set(filter, {v});
-        }
+             const skif::FilterResult& result, Retention retention) override {
+        Shard& shard = this->shardFor(key);
+        Value* v;
+        {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (Value* existing = shard.fLookup.find(key)) {
+                this->removeInternal(&shard, existing);
+            }
+            v = new Value(key, result, filter, fFrame.load(std::memory_order_relaxed));
+            shard.fLookup.add(v);
+            shard.fProbation.addToHead(v);
+            if (retention == Retention::kLikelyReused) {
+                this->markUsed(&shard, v);
+            }
+            fCurrentBytes.fetch_add(v->fBytes, std::memory_order_relaxed);
+
+            Counters* counters = shard.fByType.find(v->fTypeName);
+            if (!counters) {
+                counters = shard.fByType.set(v->fTypeName, {});
+            }
+            counters->fInserts++;
+            counters->fBytes += v->fBytes;
+            counters->fEntries++;
 
-        while (fCurrentBytes > fMaxBytes) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            if (tail == v) {
-                break;
+            if (auto* values = shard.fImageFilterValues.find(filter)) {
+                values->push_back(v);
+            } else {
+                shard.fImageFilterValues.set(filter, {v});
             }
-            this->removeInternal(tail);
         }
+
+        // 'v' is only compared against, never dereferenced, once the shard lock is released.
+        this->evictToBudget(&shard, v);
     }
 
     void purge() override {
-        SkAutoMutexExclusive mutex(fMutex);
-        while (fCurrentBytes > 0) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            this->removeInternal(tail);
+        for (int i = 0; i < fShardCount; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            while (Value* tail = shard.fProbation.tail()) {
+                this->removeInternal(&shard, tail);
+            }
+            while (Value* tail = shard.fProtected.tail()) {
+                this->removeInternal(&shard, tail);
+            }
         }
     }
 
     void purgeByImageFilter(const SkImageFilter* filter) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        auto* values = fImageFilterValues.find(filter);
-        if (!values) {
-            return;
+        // A filter's results are spread over every shard.
+        for (int i = 0; i < fShardCount; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            auto* values = shard.fImageFilterValues.find(filter);
+            if (!values) {
+                continue;
+            }
+            for (Value* v : *values) {
+                // We set the filter to be null so that removeInternal() won't delete from values
+                // while we're iterating over it.
+                v->fFilter = nullptr;
+                this->removeInternal(&shard, v);
+            }
+            shard.fImageFilterValues.remove(filter);
+        }
+    }
+
+    void setMaxBytes(size_t maxBytes) override {
+        fMaxBytes.store(maxBytes, std::memory_order_relaxed);
+        this->evictToBudget(&fShards[0], nullptr);
+    }
+
+    void newFrame() override {
+        fFrame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Stats stats() const override {
+        Stats stats;
+        stats.fMaxBytes = fMaxBytes.load(std::memory_order_relaxed);
+        stats.fShardCount = fShardCount;
+        for (int i = 0; i < fShardCount; ++i) {
+            const Shard& shard = fShards[i];
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            stats.fMisses += shard.fMisses;
+            stats.fCrossFrameHits += shard.fCrossFrameHits;
+            shard.fByType.foreach([&](const char* name, const Counters& counters) {
+                accumulate(&stats.fTotal, counters);
+                // Type names are string literals, but compare them by value in case the same name
+                // was emitted by more than one translation unit.
+                auto it = std::find_if(stats.fByFilterType.begin(), stats.fByFilterType.end(),
+                                       [&](const auto& entry) {
+                                           return strcmp(entry.first, name) == 0;
+                                       });
+                if (it == stats.fByFilterType.end()) {
+                    stats.fByFilterType.push_back({name, counters});
+                } else {
+                    accumulate(&it->second, counters);
+                }
+            });
         }
-        for (Value* v : *values) {
-            // We set the filter to be null so that removeInternal() won't delete from values while
-            // we're iterating over it.
-            v->fFilter = nullptr;
-            this->removeInternal(v);
+        std::sort(stats.fByFilterType.begin(), stats.fByFilterType.end(),
+                  [](const auto& a, const auto& b) { return strcmp(a.first, b.first) < 0; });
+        return stats;
+    }
+
+    void resetStats() override {
+        for (int i = 0; i < fShardCount; ++i) {
+            Shard& shard = fShards[i];
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            shard.fMisses = 0;
+            shard.fCrossFrameHits = 0;
+            shard.fByType.foreach([](const char*, Counters* counters) {
+                counters->fHits = 0;
+                counters->fInserts = 0;
+                counters->fEvictions = 0;
+            });
         }
-        fImageFilterValues.remove(filter);
     }
 
-    SkDEBUGCODE(int count() const override { return fLookup.count(); })
+    SkDEBUGCODE(int count() const override {
+        int count = 0;
+        for (int i = 0; i < fShardCount; ++i) {
+            SkAutoMutexExclusive mutex(fShards[i].fMutex);
+            count += fShards[i].fLookup.count();
+        }
+        return count;
+    })
+
 private:
-    void removeInternal(Value* v) {
+    // Each shard is a segmented LRU: new results enter fProbation, and move to fProtected when
+    // they are hit. fProtected is capped to a share of the budget so that results that stop being
+    // used eventually age back into fProbation. Every shard's fProbation is evicted from before
+    // any shard's fProtected.
+    struct Shard {
+        mutable SkMutex                                     fMutex;
+        SkTDynamicHash<Value, Key>                          fLookup;
+        SkTInternalLList<Value>                             fProbation;
+        SkTInternalLList<Value>                             fProtected;
+        size_t                                              fProtectedBytes = 0;
+        // Value* always points to an item in fLookup.
+        THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+        THashMap<const char*, Counters>                     fByType;
+        uint64_t                                            fMisses = 0;
+        uint64_t                                            fCrossFrameHits = 0;
+    };
+
+    static void accumulate(Counters* dst, const Counters& src) {
+        dst->fHits += src.fHits;
+        dst->fInserts += src.fInserts;
+        dst->fEvictions += src.fEvictions;
+        dst->fBytes += src.fBytes;
+        dst->fEntries += src.fEntries;
+    }
+
+    Shard& shardFor(const Key& key) const {
+        // SkTDynamicHash indexes with the low bits of the hash, so shard on the high bits.
+        return fShards[(Value::Hash(key) >> 24) & (fShardCount - 1)];
+    }
+
+    void markUsed(Shard* shard, Value* v) const {
+        if (v->fProtected) {
+            if (v != shard->fProtected.head()) {
+                shard->fProtected.remove(v);
+                shard->fProtected.addToHead(v);
+            }
+            return;
+        }
+        shard->fProbation.remove(v);
+        shard->fProtected.addToHead(v);
+        shard->fProtectedBytes += v->fBytes;
+        v->fProtected = true;
+
+        const size_t maxProtectedBytes =
+                fMaxBytes.load(std::memory_order_relaxed) / fShardCount / 5 * 4;
+        while (shard->fProtectedBytes > maxProtectedBytes && shard->fProtected.tail() != v) {
+            Value* tail = shard->fProtected.tail();
+            shard->fProtected.remove(tail);
+            shard->fProtectedBytes -= tail->fBytes;
+            tail->fProtected = false;
+            shard->fProbation.addToHead(tail);
+        }
+    }
+
+    // Evicts until the cache is within budget, one shard lock at a time: first results on
+    // probation from every shard, starting with 'first', and only then protected results. That
+    // way a one-off result never pushes out a reused one while any shard still holds one-off
+    // results. 'keep', the result that was just set, is never evicted.
+    void evictToBudget(Shard* first, const Value* keep) {
+        const int firstIndex = first - fShards;
+        for (auto list : {&Shard::fProbation, &Shard::fProtected}) {
+            for (int i = 0; i < fShardCount; ++i) {
+                if (fCurrentBytes.load(std::memory_order_relaxed) <=
+                    fMaxBytes.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                Shard& shard = fShards[(firstIndex + i) % fShardCount];
+                SkAutoMutexExclusive mutex(shard.fMutex);
+                while (fCurrentBytes.load(std::memory_order_relaxed) >
+                       fMaxBytes.load(std::memory_order_relaxed)) {
+                    // 'keep' is at the head of its list, so if it is also the tail there is
+                    // nothing else to evict from that list.
+                    Value* tail = (shard.*list).tail();
+                    if (!tail || tail == keep) {
+                        break;
+                    }
+                    shard.fByType.find(tail->fTypeName)->fEvictions++;
+                    this->removeInternal(&shard, tail);
+                }
+            }
+        }
+    }
+
+    void removeInternal(Shard* shard, Value* v) {
         if (v->fFilter) {
-            if (auto* values = fImageFilterValues.find(v->fFilter)) {
+            if (auto* values = shard->fImageFilterValues.find(v->fFilter)) {
                 if (values->size() == 1 && (*values)[0] == v) {
-                    fImageFilterValues.remove(v->fFilter);
+                    shard->fImageFilterValues.remove(v->fFilter);
                 } else {
                     for (auto it = values->begin(); it != values->end(); ++it) {
                         if (*it == v) {
@@ -135,19 +336,26 @@ private:
                 }
             }
         }
-        fCurrentBytes -= v->fImage.image() ? v->fImage.image()->getSize() : 0;
-        fLRU.remove(v);
-        fLookup.remove(v->fKey);
+        Counters* counters = shard->fByType.find(v->fTypeName);
+        counters->fBytes -= v->fBytes;
+        counters->fEntries--;
+        fCurrentBytes.fetch_sub(v->fBytes, std::memory_order_relaxed);
+        if (v->fProtected) {
+            shard->fProtected.remove(v);
+            shard->fProtectedBytes -= v->fBytes;
+        } else {
+            shard->fProbation.remove(v);
+        }
+        shard->fLookup.remove(v->fKey);
         delete v;
     }
+
 private:
-    SkTDynamicHash<Value, Key>                          fLookup;
-    mutable SkTInternalLList<Value>                     fLRU;
-    // Value* always points to an item in fLookup.
-    THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
-    size_t                                              fMaxBytes;
-    size_t                                              fCurrentBytes;
-    mutable SkMutex                                     fMutex;
+    const int                  fShardCount;
+    mutable Shard              fShards[kMaxShards];
+    std::atomic<size_t>        fMaxBytes;
+    std::atomic<size_t>        fCurrentBytes;
+    std::atomic<uint32_t>      fFrame;
 };
 
 } // namespace
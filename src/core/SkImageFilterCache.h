@@ -13,9 +13,11 @@
 #include "include/core/SkRefCnt.h"
 #include "include/private/SkAssert.h"
 #include "include/private/SkDebug.h"
+#include "include/private/SkTArray.h"
 
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 
 class SkImageFilter;
 namespace skif { class FilterResult; }
@@ -54,6 +56,12 @@ struct SkImageFilterCacheKey {
 // This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to result
 // NOTE: this is the _specific_ unique ID of the image filter, so refiltering the same image with a
 // copy of the image filter (with exactly the same parameters) will not yield a cache hit.
+//
+// The cache is split into shards by key hash, each with its own lock and LRU, so that filters
+// evaluated on several threads do not serialize on a single mutex. The byte budget is shared by
+// all shards. Within a shard, results that have been hit at least once are evicted only after
+// results that have not been reused, so a result that is re-requested every frame is not pushed
+// out by one-off results of the same size.
 class SkImageFilterCache : public SkRefCnt {
 public:
     static constexpr size_t kDefaultTransientSize = 32 * 1024 * 1024;
@@ -65,6 +73,31 @@ public:
     enum class CreateIfNecessary : bool { kNo, kYes };
     static sk_sp<SkImageFilterCache> Get(CreateIfNecessary = CreateIfNecessary::kYes);
 
+    // A hint to set() about how long a result should be kept. kLikelyReused results, e.g. those of
+    // a layer that is known not to change next frame, are treated as if they had already been hit.
+    enum class Retention : bool { kDefault, kLikelyReused };
+
+    struct Counters {
+        uint64_t fHits = 0;
+        uint64_t fInserts = 0;
+        uint64_t fEvictions = 0;  // Removed to stay within budget, not by purge() or replacement.
+        size_t   fBytes = 0;
+        int      fEntries = 0;
+    };
+
+    struct Stats {
+        Counters fTotal;
+        uint64_t fMisses = 0;
+        // Hits on a result that was last set or hit before the most recent newFrame().
+        uint64_t fCrossFrameHits = 0;
+        size_t   fMaxBytes = 0;
+        int      fShardCount = 0;
+        // Counters keyed by SkFlattenable::getTypeName() of the filter that produced each result,
+        // sorted by name. Misses are not attributed since get() does not know the filter, but
+        // every miss in SkImageFilter_Base::filterImage() is followed by an insert.
+        skia_private::TArray<std::pair<const char*, Counters>> fByFilterType;
+    };
+
     // Returns true on cache hit and updates 'result' to be the cached result. Returns false when
     // not in the cache, in which case 'result' is not modified.
     virtual bool get(const SkImageFilterCacheKey& key,
@@ -72,9 +105,19 @@ public:
     // 'filter' is included in the caching to allow the purging of all of an image filter's cached
     // results when it is destroyed.
     virtual void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
-                     const skif::FilterResult& result) = 0;
+                     const skif::FilterResult& result,
+                     Retention retention = Retention::kDefault) = 0;
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
+
+    // Changes the byte budget, evicting results if it shrank. The shard count is fixed at creation.
+    virtual void setMaxBytes(size_t maxBytes) = 0;
+    // Marks a frame boundary for the cross-frame statistics.
+    virtual void newFrame() = 0;
+    virtual Stats stats() const = 0;
+    // Zeroes the hit, miss, insert and eviction counts. Byte and entry counts are unaffected.
+    virtual void resetStats() = 0;
+
     SkDEBUGCODE(virtual int count() const = 0;)
 };
 
@@ -8,6 +8,7 @@
 #include "src/core/SkImageFilterTypes.h"
 
 #include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkBlender.h"
 #include "include/core/SkCanvas.h"
@@ -18,7 +19,9 @@
 #include "include/core/SkM44.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"  // IWYU pragma: keep
+#include "include/core/SkPixmap.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkSurfaceProps.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/SkDebug.h"
 #include "include/private/SkFloatingPoint.h"
@@ -34,13 +37,16 @@
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/core/SkVx.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 namespace skif {
 
@@ -183,8 +189,8 @@ std::optional<LayerSpace<SkMatrix>> periodic_axis_transform(
 class RasterBackend : public Backend {
 public:
 
-    RasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType)
-            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType) {}
+    RasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType, SkExecutor* executor)
+            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType, executor) {}
 
     sk_sp<SkDevice> makeDevice(SkISize size,
                                sk_sp<SkColorSpace> colorSpace,
@@ -215,15 +221,58 @@ public:
 
 Backend::Backend(sk_sp<SkImageFilterCache> cache,
                  const SkSurfaceProps& surfaceProps,
-                 const SkColorType colorType)
+                 const SkColorType colorType,
+                 SkExecutor* executor)
         : fCache(std::move(cache))
         , fSurfaceProps(surfaceProps)
-        , fColorType(colorType) {}
+        , fColorType(colorType)
+        , fExecutor(executor) {}
 
 Backend::~Backend() = default;
 
-sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType) {
-    return sk_make_sp<RasterBackend>(surfaceProps, colorType);
+sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType,
+                                 SkExecutor* executor) {
+    return sk_make_sp<RasterBackend>(surfaceProps, colorType, executor);
+}
+
+void Context::parallelFor(int count,
+                          const std::function<void(int, const Context&)>& fn) const {
+    SkExecutor* executor = fExecutor;
+    if (!executor || count <= 1) {
+        for (int i = 0; i < count; ++i) {
+            fn(i, *this);
+        }
+        return;
+    }
+
+    // The first call runs on this thread while the rest are queued on the executor. Stats are
+    // plain counters, so each queued call gets its own. Queued calls must not queue and wait on
+    // more work themselves: with a pool that doesn't let waiting threads borrow work, every thread
+    // could end up waiting, so their nested evaluation is serial.
+    std::vector<Stats> stats(fStats ? count - 1 : 0);
+    SkTaskGroup group(*executor);
+    for (int i = 1; i < count; ++i) {
+        group.add([&, i] {
+            Context ctx = *this;
+            ctx.fExecutor = nullptr;
+            ctx.fStats = fStats ? &stats[i - 1] : nullptr;
+            fn(i, ctx);
+        });
+    }
+    fn(0, *this);
+    group.wait();
+
+    for (const Stats& s : stats) {
+        fStats->merge(s);
+    }
+}
+
+void Stats::merge(const Stats& other) {
+    fNumVisitedImageFilters += other.fNumVisitedImageFilters;
+    fNumCacheHits += other.fNumCacheHits;
+    fNumOffscreenSurfaces += other.fNumOffscreenSurfaces;
+    fNumShaderClampedDraws += other.fNumShaderClampedDraws;
+    fNumShaderBasedTilingDraws += other.fNumShaderBasedTilingDraws;
 }
 
 void Stats::dumpStats() const {
@@ -589,6 +638,42 @@ public:
 
     explicit operator bool() const { return fCanvas.has_value(); }
 
+    // Fills the surface's clip with 'paint'. When the backend has an executor, a large raster
+    // surface is split into bands of rows that are drawn concurrently. Each band draws through its
+    // own canvas onto the same pixels, with the same device coordinates and a clip covering only
+    // its rows, so the result is identical to a single draw.
+    void drawPaint(const Context& ctx, const SkPaint& paint) {
+        // Below this many pixels per band, the per-draw setup outweighs the parallelism.
+        static constexpr int64_t kMinPixelsPerBand = 64 * 1024;
+        static constexpr int kMaxBands = 16;
+
+        SkCanvas* canvas = this->canvas();
+        const SkIRect clip = canvas->getDeviceClipBounds();
+        const int bands = (int)std::min<int64_t>(
+                kMaxBands, clip.width() * (int64_t)clip.height() / kMinPixelsPerBand);
+        SkPixmap pixels;
+        if (!ctx.executor() || bands < 2 || !canvas->isClipRect() ||
+            !this->device()->accessPixels(&pixels)) {
+            canvas->drawPaint(paint);
+            return;
+        }
+
+        const SkM44 localToDevice = canvas->getLocalToDevice();
+        const SkSurfaceProps props = this->device()->surfaceProps();
+        ctx.parallelFor(bands, [&](int band, const Context&) {
+            SkIRect rows = clip;
+            rows.fTop    = clip.fTop + (int)(clip.height() * (int64_t)band / bands);
+            rows.fBottom = clip.fTop + (int)(clip.height() * (int64_t)(band + 1) / bands);
+
+            SkBitmap bitmap;
+            bitmap.installPixels(pixels);
+            SkCanvas bandCanvas(bitmap, props);
+            bandCanvas.clipIRect(rows);
+            bandCanvas.setMatrix(localToDevice);
+            bandCanvas.drawPaint(paint);
+        });
+    }
+
     SkCanvas* canvas() { SkASSERT(fCanvas.has_value()); return &*fCanvas; }
     SkDevice* device() { return SkCanvasPriv::TopDevice(this->canvas()); }
     SkCanvas* operator->() { return this->canvas(); }
@@ -2071,7 +2156,7 @@ FilterResult FilterResult::Builder::drawShader(sk_sp<SkShader> shader,
 #if !defined(SK_USE_SRCOVER_FOR_FILTERS)
         paint.setBlendMode(SkBlendMode::kSrc);
 #endif
-        surface->drawPaint(paint);
+        surface.drawPaint(fContext, paint);
     }
     return surface.snap();
 }
@@ -2134,8 +2219,11 @@ FilterResult FilterResult::Builder::blur(const LayerSpace<SkSize>& sigma) {
     auto sampleBounds = outputBounds;
     sampleBounds.outset(radii);
 
-    float sx = sigma.width()  > algorithm->maxSigma() ? algorithm->maxSigma()/sigma.width()  : 1.f;
-    float sy = sigma.height() > algorithm->maxSigma() ? algorithm->maxSigma()/sigma.height() : 1.f;
+    // Sigmas past what the algorithm prefers to evaluate at full resolution are blurred at a lower
+    // resolution and upscaled, which hides the rescaling error.
+    const float maxSigma = algorithm->maxFullResolutionSigma();
+    float sx = sigma.width()  > maxSigma ? maxSigma/sigma.width()  : 1.f;
+    float sy = sigma.height() > maxSigma ? maxSigma/sigma.height() : 1.f;
     // For identity scale factors, this rescale() is a no-op when possible, but otherwise it will
     // also handle resolving any color filters or transform similar to a resolve() except that it
     // can defer the tile mode.
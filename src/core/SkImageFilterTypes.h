@@ -29,15 +29,19 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkSpecialImage.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <utility>
+#include <vector>
 
 class FilterResultTestAccess;  // for testing
 class SkBitmap;
 class SkBlender;
 class SkBlurEngine;
 class SkDevice;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageFilterCache;
@@ -1123,18 +1127,26 @@ public:
 
     SkImageFilterCache* cache() const { return fCache.get(); }
 
+    // If not null, independent parts of the filter DAG, and large per-pixel draws, may be
+    // evaluated concurrently on this executor. Only backends whose devices can be drawn to from
+    // multiple threads provide one.
+    SkExecutor* executor() const { return fExecutor; }
+
 protected:
     Backend(sk_sp<SkImageFilterCache> cache,
             const SkSurfaceProps& surfaceProps,
-            const SkColorType colorType);
+            const SkColorType colorType,
+            SkExecutor* executor = nullptr);
 
 private:
     sk_sp<SkImageFilterCache> fCache;
     SkSurfaceProps fSurfaceProps;
     SkColorType fColorType;
+    SkExecutor* fExecutor;
 };
 
-sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType);
+sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType,
+                                 SkExecutor* executor = nullptr);
 
 // Stats for a single image filter evaluation
 struct Stats {
@@ -1146,6 +1158,8 @@ struct Stats {
 
     void dumpStats() const;   // log to std out
     void reportStats() const; // trace event counters
+
+    void merge(const Stats& other); // accumulate stats gathered on another thread
 };
 
 // The context contains all necessary information to describe how the image filter should be
@@ -1166,10 +1180,15 @@ public:
         , fDesiredOutput(desiredOutput)
         , fSource(source)
         , fColorSpace(sk_ref_sp(colorSpace))
+        , fExecutor(fBackend ? fBackend->executor() : nullptr)
         , fStats(stats) {}
 
     const Backend* backend() const { return fBackend.get(); }
 
+    // The backend's executor, or null in contexts handed to calls that parallelFor() ran on the
+    // executor: work is only ever split at one level, so that no executor thread waits on others.
+    SkExecutor* executor() const { return fExecutor; }
+
     // The mapping that defines the transformation from local parameter space of the filters to the
     // layer space where the image filters are evaluated, as well as the remaining transformation
     // from the layer space to the final device space. The layer space defined by the returned
@@ -1225,6 +1244,28 @@ public:
         return c;
     }
 
+    // The sorted unique IDs of the filters that are an input more than once in the DAG being
+    // evaluated. Null until the root filter of the DAG has found them.
+    const std::vector<uint32_t>* sharedFilterIDs() const { return fSharedFilterIDs; }
+    bool isSharedFilter(uint32_t uniqueID) const {
+        return fSharedFilterIDs && std::binary_search(fSharedFilterIDs->begin(),
+                                                      fSharedFilterIDs->end(), uniqueID);
+    }
+    // Create a new context that matches this context, but with the given shared filter IDs, which
+    // must outlive every context derived from it.
+    Context withSharedFilterIDs(const std::vector<uint32_t>* ids) const {
+        Context c = *this;
+        c.fSharedFilterIDs = ids;
+        return c;
+    }
+
+
+    // Calls fn(i, ctx) for i in [0, count). When this context has an executor, the calls may run
+    // concurrently, and this returns once they have all finished. Every call gets a context that
+    // matches this one, except that calls off the calling thread gather stats separately, and have
+    // no executor so that anything they run is serial. Their stats are merged into this context's
+    // afterwards, so the totals match a serial evaluation.
+    void parallelFor(int count, const std::function<void(int, const Context&)>& fn) const;
 
     // Stats tracking
     void markVisitedImageFilter() const {
@@ -1265,6 +1306,8 @@ private:
     // The color space the filters are evaluated in
     sk_sp<SkColorSpace> fColorSpace;
 
+    SkExecutor* fExecutor;
+    const std::vector<uint32_t>* fSharedFilterIDs = nullptr;
     Stats* fStats;
 };
 
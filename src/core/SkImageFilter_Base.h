@@ -199,6 +199,10 @@ protected:
     // `withNewDesiredOutput`.
     skif::FilterResult getChildOutput(int index, const skif::Context& ctx) const;
 
+    // Evaluates every input filter with the same context, as getChildOutput() would. Independent
+    // inputs are evaluated concurrently when the context's backend has an executor.
+    skia_private::TArray<skif::FilterResult> getChildOutputs(const skif::Context& ctx) const;
+
 private:
     friend class SkImageFilter;
     // For PurgeCache()
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkMappedPicture.h"
+
+#include "include/private/SkAssert.h"
+#include "src/core/SkPictureData.h"
+#include "src/core/SkPicturePlayback.h"
+
+#include <utility>
+
+SkMappedPicture::SkMappedPicture(std::unique_ptr<SkPictureData> data,
+                                 int opCount,
+                                 int nestedOpCount)
+    : fOpCount(opCount)
+    , fNestedOpCount(nestedOpCount) {
+    SkASSERT(data && data->opData());
+    // Playback may happen on several threads at once, so compute the lazy path bounds now.
+    data->initForPlayback();
+    fData = std::move(data);
+}
+
+SkMappedPicture::~SkMappedPicture() = default;
+
+void SkMappedPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+
+    SkPicturePlayback playback(fData.get());
+    playback.draw(canvas, callback, nullptr);
+}
+
+SkRect SkMappedPicture::cullRect() const { return fData->info().fCullRect; }
+int SkMappedPicture::approximateOpCount(bool nested) const {
+    return nested ? fNestedOpCount : fOpCount;
+}
+size_t SkMappedPicture::approximateBytesUsed() const {
+    // The op data and the encoded images are mapped rather than allocated.
+    return sizeof(*this) + fData->approximateBytesUsed();
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMappedPicture_DEFINED
+#define SkMappedPicture_DEFINED
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+
+#include <cstddef>
+#include <memory>
+
+class SkCanvas;
+class SkPictureData;
+
+// An SkPicture returned by SkPicture::MakeFromMappedData(). Rather than being forwardported into
+// an SkRecord, the SkPictureData it was read into is kept, with its op data (and the encoded
+// data of its images) still pointing into the mapped SkData, and it is replayed op by op.
+class SkMappedPicture final : public SkPicture {
+public:
+    SkMappedPicture(std::unique_ptr<SkPictureData> data, int opCount, int nestedOpCount);
+    ~SkMappedPicture() override;
+
+    void playback(SkCanvas*, AbortCallback*) const override;
+
+    SkRect cullRect()                         const override;
+    int    approximateOpCount(bool nested)    const override;
+    size_t approximateBytesUsed()             const override;
+
+private:
+    std::unique_ptr<const SkPictureData> fData;
+    const int                            fOpCount;
+    const int                            fNestedOpCount;
+};
+
+#endif
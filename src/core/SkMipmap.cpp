@@ -14,7 +14,9 @@
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
 #include <new>
 
 //
@@ -26,6 +28,65 @@
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Builds 'dst' from 'src', splitting it into bands of rows on 'executor' when it is large enough
+// for that to pay for the tasks.
+static void build_level(SkMipmapDownSampler* downsampler, const SkPixmap& dst,
+                        const SkPixmap& src, SkExecutor* executor) {
+    static constexpr int64_t kMinPixelsPerBand = 64 * 1024;
+    static constexpr int kMaxBands = 16;
+
+    int bands = 1;
+    if (executor && downsampler->canBuildRegions()) {
+        bands = (int)std::min<int64_t>({kMaxBands,
+                                        dst.height(),
+                                        dst.width() * (int64_t)dst.height() / kMinPixelsPerBand});
+    }
+    if (bands <= 1) {
+        downsampler->buildLevel(dst, src);
+        return;
+    }
+
+    // Each dst row is filtered from src rows 2y and 2y + 1, and also 2y + 2 when the src height is
+    // odd. Giving each band its extra src row keeps the src band odd, so the same filter is used.
+    const int extraSrcRow = src.height() & 1;
+    SkTaskGroup group(*executor);
+    for (int band = 0; band < bands; ++band) {
+        const int top = dst.height() * band / bands;
+        const int bottom = dst.height() * (band + 1) / bands;
+        group.add([=] {
+            SkPixmap dstBand, srcBand;
+            SkAssertResult(dst.extractSubset(&dstBand,
+                                             SkIRect::MakeLTRB(0, top, dst.width(), bottom)));
+            SkAssertResult(src.extractSubset(&srcBand,
+                                             SkIRect::MakeLTRB(0, 2 * top, src.width(),
+                                                               2 * bottom + extraSrcRow)));
+            downsampler->buildLevel(dstBand, srcBand);
+        });
+    }
+}
+
+// Each dst pixel is filtered from src pixels 2x and 2x + 1, and also 2x + 2 when the src is odd
+// in that dimension. These map a rect of one level to the rects of its neighbours that it touches.
+static SkIRect dst_footprint(const SkIRect& srcRect, SkISize srcSize, SkISize dstSize) {
+    auto lo = [](int src, int srcSize) {
+        const int taps = (srcSize & 1) ? 3 : 2;
+        return (std::max(0, src - (taps - 1)) + 1) / 2;
+    };
+    return SkIRect::MakeLTRB(lo(srcRect.fLeft, srcSize.width()),
+                             lo(srcRect.fTop, srcSize.height()),
+                             std::min(dstSize.width(), (srcRect.fRight + 1) / 2),
+                             std::min(dstSize.height(), (srcRect.fBottom + 1) / 2));
+}
+
+static SkIRect src_footprint(const SkIRect& dstRect, SkISize srcSize) {
+    // Keeping the src rect odd when the src is odd selects the same filter as the whole level.
+    return SkIRect::MakeLTRB(2 * dstRect.fLeft,
+                             2 * dstRect.fTop,
+                             std::min(srcSize.width(), 2 * dstRect.fRight + (srcSize.width() & 1)),
+                             std::min(srcSize.height(),
+                                      2 * dstRect.fBottom + (srcSize.height() & 1)));
+}
+
 SkMipmap::SkMipmap(void* malloc, size_t size) : SkCachedData(malloc, size) {}
 SkMipmap::SkMipmap(size_t size, SkDiscardableMemory* dm) : SkCachedData(size, dm) {}
 
@@ -43,7 +104,7 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 }
 
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
-                          bool computeContents) {
+                          bool computeContents, SkExecutor* executor) {
     if (src.width() <= 1 && src.height() <= 1) {
         return nullptr;
     }
@@ -121,7 +182,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (downsampler) {
-            downsampler->buildLevel(dstPM, srcPM);
+            build_level(downsampler.get(), dstPM, srcPM, executor);
         }
         srcPM = dstPM;
         addr += height * rowBytes;
@@ -266,12 +327,46 @@ bool SkMipmap::validForRootLevel(const SkImageInfo& root) const {
 
 // Helper which extracts a pixmap from the src bitmap
 //
-SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact,
+                          SkExecutor* executor) {
     SkPixmap srcPixmap;
     if (!src.peekPixels(&srcPixmap)) {
         return nullptr;
     }
-    return Build(srcPixmap, fact);
+    return Build(srcPixmap, fact, /*computeContents=*/true, executor);
+}
+
+bool SkMipmap::rebuildRegion(const SkPixmap& src, const SkIRect& dirty, SkExecutor* executor) {
+    if (!src.addr() || !this->validForRootLevel(src.info())) {
+        return false;
+    }
+    SkIRect srcRect = dirty;
+    if (!srcRect.intersect(src.bounds())) {
+        return true;
+    }
+
+    std::unique_ptr<SkMipmapDownSampler> downsampler = MakeDownSampler(src);
+    if (!downsampler) {
+        return false;
+    }
+
+    SkPixmap srcPM(src);
+    for (int i = 0; i < fCount; ++i) {
+        const SkPixmap& dstPM = fLevels[i].fPixmap;
+        if (downsampler->canBuildRegions()) {
+            const SkIRect dstRect = dst_footprint(srcRect, srcPM.dimensions(), dstPM.dimensions());
+            SkPixmap dstSubset, srcSubset;
+            SkAssertResult(dstPM.extractSubset(&dstSubset, dstRect));
+            SkAssertResult(srcPM.extractSubset(&srcSubset,
+                                               src_footprint(dstRect, srcPM.dimensions())));
+            build_level(downsampler.get(), dstSubset, srcSubset, executor);
+            srcRect = dstRect;
+        } else {
+            build_level(downsampler.get(), dstPM, srcPM, executor);
+        }
+        srcPM = dstPM;
+    }
+    return true;
 }
 
 int SkMipmap::countLevels() const {
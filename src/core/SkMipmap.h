@@ -19,6 +19,7 @@
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -27,6 +28,11 @@ struct SkMipmapDownSampler {
     virtual ~SkMipmapDownSampler() {}
 
     virtual void buildLevel(const SkPixmap& dst, const SkPixmap& src) = 0;
+
+    // Whether buildLevel() may be called on subsets of a level, including concurrently on bands of
+    // rows, where each subset of dst is passed with the subset of src that it is filtered from.
+    // The results must be the same as building the whole level at once.
+    virtual bool canBuildRegions() const { return false; }
 };
 
 /*
@@ -41,10 +47,19 @@ public:
     ~SkMipmap() override;
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // If an executor is provided, large levels are built in bands of rows on it. The levels
+    // themselves are still built in order, since each is filtered from the one before it.
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
-                           bool computeContents = true);
+                           bool computeContents = true, SkExecutor* executor = nullptr);
+
+    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc,
+                           SkExecutor* executor = nullptr);
 
-    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
+    // Rebuilds only the parts of each level that are filtered from 'dirty' in 'src', which must
+    // be the base level this mipmap was built from, after those pixels have changed. The cost is
+    // proportional to the dirty area rather than to the whole image. Returns false, leaving the
+    // levels untouched, if src does not match the levels or their memory has been purged.
+    bool rebuildRegion(const SkPixmap& src, const SkIRect& dirty, SkExecutor* executor = nullptr);
 
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
@@ -8,6 +8,7 @@
 
 #include "include/core/SkImage.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkTypes.h"
 #include "src/core/SkMipmap.h"
 struct SkImageInfo;
@@ -37,3 +38,8 @@ SkPixmap SkMipmapBuilder::level(int index) const {
 sk_sp<SkImage> SkMipmapBuilder::attachTo(const sk_sp<const SkImage>& src) {
     return src->withMipmaps(fMM);
 }
+
+bool SkMipmapBuilder::rebuildRegion(const SkPixmap& base, const SkIRect& dirty,
+                                    SkExecutor* executor) {
+    return fMM && fMM->rebuildRegion(base, dirty, executor);
+}
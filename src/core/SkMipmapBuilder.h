@@ -10,9 +10,11 @@
 
 #include "include/core/SkRefCnt.h"
 
+class SkExecutor;
 class SkImage;
 class SkMipmap;
 class SkPixmap;
+struct SkIRect;
 struct SkImageInfo;
 
 class SkMipmapBuilder {
@@ -29,6 +31,13 @@ public:
      */
     sk_sp<SkImage> attachTo(const sk_sp<const SkImage>& src);
 
+    /**
+     *  After the pixels in 'dirty' of 'base' have changed, regenerates only the parts of these
+     *  levels that are filtered from them. base must match the info these levels were made for.
+     *  Returns false if it does not.
+     */
+    bool rebuildRegion(const SkPixmap& base, const SkIRect& dirty, SkExecutor* executor = nullptr);
+
 private:
     sk_sp<SkMipmap> fMM;
 };
@@ -96,9 +96,9 @@ struct ColorTypeFilter_88 {
 struct ColorTypeFilter_1616 {
     typedef uint32_t Type;
     static uint64_t Expand(uint32_t x) {
-        return (x & 0xFFFF) | ((x & ~0xFFFF) << 16);
+        return (x & 0xFFFF) | ((uint64_t)(x & ~0xFFFF) << 16);
     }
-    static uint16_t Compact(uint64_t x) {
+    static uint32_t Compact(uint64_t x) {
         return (x & 0xFFFF) | ((x >> 16) & ~0xFFFF);
     }
 };
@@ -140,17 +140,18 @@ struct ColorTypeFilter_16 {
 
 struct ColorTypeFilter_1010102 {
     typedef uint32_t Type;
+    // Each channel gets 16 bits, enough for the sum of the 16 weights of the 3x3 filter.
     static uint64_t Expand(uint64_t x) {
         return (((x      ) & 0x3ff)      ) |
-        (((x >> 10) & 0x3ff) << 20) |
-        (((x >> 20) & 0x3ff) << 40) |
-        (((x >> 30) & 0x3  ) << 60);
+        (((x >> 10) & 0x3ff) << 16) |
+        (((x >> 20) & 0x3ff) << 32) |
+        (((x >> 30) & 0x3  ) << 48);
     }
     static uint32_t Compact(uint64_t x) {
         return (((x      ) & 0x3ff)      ) |
-        (((x >> 20) & 0x3ff) << 10) |
-        (((x >> 40) & 0x3ff) << 20) |
-        (((x >> 60) & 0x3  ) << 30);
+        (((x >> 16) & 0x3ff) << 10) |
+        (((x >> 32) & 0x3ff) << 20) |
+        (((x >> 48) & 0x3  ) << 30);
     }
 };
 
@@ -162,7 +163,7 @@ template <typename T> T shift_right(const T& x, int bits) {
     return x >> bits;
 }
 
-skvx::float4 shift_right(const skvx::float4& x, int bits) {
+template <int N> skvx::Vec<N, float> shift_right(const skvx::Vec<N, float>& x, int bits) {
     return x * (1.0f / (1 << bits));
 }
 
@@ -170,7 +171,7 @@ template <typename T> T shift_left(const T& x, int bits) {
     return x << bits;
 }
 
-skvx::float4 shift_left(const skvx::float4& x, int bits) {
+template <int N> skvx::Vec<N, float> shift_left(const skvx::Vec<N, float>& x, int bits) {
     return x * (1 << bits);
 }
 
@@ -375,6 +376,215 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
 }
 
 
+//
+//  A wide filter expands kDstPixels pairs of adjacent source pixels at once, into one vector
+//  holding the even pixels (2i) and one holding the odd pixels (2i + 1), so that the wide
+//  downsamplers produce kDstPixels destination pixels per iteration with plain lane-wise math.
+//  Each does the same arithmetic as its scalar filter, and so gets the same results. The scalar
+//  downsamplers above handle what is left at the end of each row.
+//
+//  Pixels are loaded a pair at a time into an integer twice their size and split with a mask and
+//  a shift, which leaves room above each pixel to spread out its channels. Only 8888 has a wide
+//  filter: the scalar loops of the other integer color types are already auto-vectorized about as
+//  well, and the float ones are vectorized across the channels of each pixel.
+//
+
+template <typename Pair, int D, typename T>
+SK_ALWAYS_INLINE void load_pixel_pairs(const T* p, skvx::Vec<D, Pair>* even,
+                                       skvx::Vec<D, Pair>* odd) {
+    static_assert(sizeof(Pair) == 2 * sizeof(T));
+    constexpr int kBits = 8 * sizeof(T);
+    const auto pairs = skvx::Vec<D, Pair>::Load(p);
+    *even = pairs & (Pair)((Pair(1) << kBits) - 1);
+    *odd = pairs >> kBits;
+}
+
+struct WideFilter_8888 {
+    typedef uint32_t Type;
+    typedef ColorTypeFilter_8888 Scalar;
+    static constexpr int kDstPixels = 8;
+    using V = skvx::Vec<kDstPixels, uint64_t>;
+
+    // Gives each channel 16 bits: bytes 0 and 2 stay in place, bytes 1 and 3 move up 24 bits.
+    SK_ALWAYS_INLINE static V Expand(const V& x) {
+        return (x & 0x00FF00FF) | ((x & 0xFF00FF00) << 24);
+    }
+    SK_ALWAYS_INLINE static void Load(const uint32_t* p, V* even, V* odd) {
+        load_pixel_pairs(p, even, odd);
+        *even = Expand(*even);
+        *odd = Expand(*odd);
+    }
+    SK_ALWAYS_INLINE static void Store(uint32_t* d, const V& x) {
+        skvx::cast<uint32_t>((x & 0x00FF00FF) | ((x >> 24) & 0xFF00FF00)).store(d);
+    }
+};
+
+template <typename W> void downsample_2_1_wide(void* dst, const void* src, size_t srcRB,
+                                                int count) {
+    SkASSERT(count > 0);
+    constexpr int D = W::kDstPixels;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + D <= count; i += D) {
+        typename W::V c00, c01;
+        W::Load(p0, &c00, &c01);
+
+        auto c = c00 + c01;
+        W::Store(d, shift_right(c, 1));
+        p0 += 2 * D;
+        d += D;
+    }
+    if (i < count) {
+        downsample_2_1<typename W::Scalar>(d, p0, srcRB, count - i);
+    }
+}
+
+template <typename W> void downsample_2_2_wide(void* dst, const void* src, size_t srcRB,
+                                                int count) {
+    SkASSERT(count > 0);
+    constexpr int D = W::kDstPixels;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + D <= count; i += D) {
+        typename W::V c00, c01, c10, c11;
+        W::Load(p0, &c00, &c01);
+        W::Load(p1, &c10, &c11);
+
+        auto c = c00 + c10 + c01 + c11;
+        W::Store(d, shift_right(c, 2));
+        p0 += 2 * D;
+        p1 += 2 * D;
+        d += D;
+    }
+    if (i < count) {
+        downsample_2_2<typename W::Scalar>(d, p0, srcRB, count - i);
+    }
+}
+
+template <typename W> void downsample_2_3_wide(void* dst, const void* src, size_t srcRB,
+                                                int count) {
+    SkASSERT(count > 0);
+    constexpr int D = W::kDstPixels;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename W::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + D <= count; i += D) {
+        typename W::V c00, c01, c10, c11, c20, c21;
+        W::Load(p0, &c00, &c01);
+        W::Load(p1, &c10, &c11);
+        W::Load(p2, &c20, &c21);
+
+        auto c = add_121(c00, c10, c20) + add_121(c01, c11, c21);
+        W::Store(d, shift_right(c, 3));
+        p0 += 2 * D;
+        p1 += 2 * D;
+        p2 += 2 * D;
+        d += D;
+    }
+    if (i < count) {
+        downsample_2_3<typename W::Scalar>(d, p0, srcRB, count - i);
+    }
+}
+
+// The 3-wide filters also need pixel 2i + 2, which is the odd pixel of the pair one pixel further
+// along. That load stays in the row, since the source is 2 * count + 1 pixels wide.
+template <typename W> void downsample_3_1_wide(void* dst, const void* src, size_t srcRB,
+                                                int count) {
+    SkASSERT(count > 0);
+    constexpr int D = W::kDstPixels;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + D <= count; i += D) {
+        typename W::V c00, c01, c02, unused;
+        W::Load(p0, &c00, &c01);
+        W::Load(p0 + 1, &unused, &c02);
+
+        auto c = add_121(c00, c01, c02);
+        W::Store(d, shift_right(c, 2));
+        p0 += 2 * D;
+        d += D;
+    }
+    if (i < count) {
+        downsample_3_1<typename W::Scalar>(d, p0, srcRB, count - i);
+    }
+}
+
+template <typename W> void downsample_3_2_wide(void* dst, const void* src, size_t srcRB,
+                                                int count) {
+    SkASSERT(count > 0);
+    constexpr int D = W::kDstPixels;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + D <= count; i += D) {
+        typename W::V a0, a1, b0, b1, c0, c1, unused;
+        W::Load(p0, &a0, &b0);
+        W::Load(p1, &a1, &b1);
+        W::Load(p0 + 1, &unused, &c0);
+        W::Load(p1 + 1, &unused, &c1);
+
+        auto a = a0 + a1;
+        auto b = b0 + b0 + b1 + b1;
+        auto c = c0 + c1;
+
+        auto sum = a + b + c;
+        W::Store(d, shift_right(sum, 3));
+        p0 += 2 * D;
+        p1 += 2 * D;
+        d += D;
+    }
+    if (i < count) {
+        downsample_3_2<typename W::Scalar>(d, p0, srcRB, count - i);
+    }
+}
+
+template <typename W> void downsample_3_3_wide(void* dst, const void* src, size_t srcRB,
+                                                int count) {
+    SkASSERT(count > 0);
+    constexpr int D = W::kDstPixels;
+    auto p0 = static_cast<const typename W::Type*>(src);
+    auto p1 = (const typename W::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename W::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename W::Type*>(dst);
+
+    int i = 0;
+    for (; i + D <= count; i += D) {
+        typename W::V a0, a1, a2, b0, b1, b2, c0, c1, c2, unused;
+        W::Load(p0, &a0, &b0);
+        W::Load(p1, &a1, &b1);
+        W::Load(p2, &a2, &b2);
+        W::Load(p0 + 1, &unused, &c0);
+        W::Load(p1 + 1, &unused, &c1);
+        W::Load(p2 + 1, &unused, &c2);
+
+        auto a = add_121(a0, a1, a2);
+        auto b = shift_left(add_121(b0, b1, b2), 1);
+        auto c = add_121(c0, c1, c2);
+
+        auto sum = a + b + c;
+        W::Store(d, shift_right(sum, 4));
+        p0 += 2 * D;
+        p1 += 2 * D;
+        p2 += 2 * D;
+        d += D;
+    }
+    if (i < count) {
+        downsample_3_3<typename W::Scalar>(d, p0, srcRB, count - i);
+    }
+}
+
 typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
 struct HQDownSampler : SkMipmapDownSampler {
@@ -388,6 +598,7 @@ struct HQDownSampler : SkMipmapDownSampler {
     FilterProc* proc_3_3 = nullptr;
 
     void buildLevel(const SkPixmap& dst, const SkPixmap& src) override;
+    bool canBuildRegions() const override { return true; }
 };
 
 void HQDownSampler::buildLevel(const SkPixmap& dst, const SkPixmap& src) {
@@ -453,12 +664,12 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
         case kBGRA_8888_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            proc_2_1 = downsample_2_1_wide<WideFilter_8888>;
+            proc_2_2 = downsample_2_2_wide<WideFilter_8888>;
+            proc_2_3 = downsample_2_3_wide<WideFilter_8888>;
+            proc_3_1 = downsample_3_1_wide<WideFilter_8888>;
+            proc_3_2 = downsample_3_2_wide<WideFilter_8888>;
+            proc_3_3 = downsample_3_3_wide<WideFilter_8888>;
             break;
         case kRGB_565_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
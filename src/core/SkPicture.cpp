@@ -7,13 +7,20 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/core/SkStream.h"
+#include "include/private/SkAlign.h"
+#include "include/private/SkFloatingPoint.h"
 #include "include/private/SkTFitsIn.h"
+#include "include/private/SkTPin.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkChunkedPicture.h"
+#include "src/core/SkMappedPicture.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
@@ -21,12 +28,15 @@
 #include "src/core/SkPictureRecord.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkSafeMath.h"
 #include "src/core/SkStreamPriv.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 // When we read/write the SkPictInfo via a stream, we have a sentinel byte right after the info.
 // Note: in the read/write buffer versions, we have a slightly different convention:
@@ -38,6 +48,13 @@ enum {
     kFailure_TrailingStreamByteAfterPictInfo     = 0,   // nothing follows
     kPictureData_TrailingStreamByteAfterPictInfo = 1,   // SkPictureData follows
     kCustom_TrailingStreamByteAfterPictInfo      = 2,   // -size32 follows
+    kPadded_TrailingStreamByteAfterPictInfo      = 3,   // one of the above and 2 bytes of padding
+                                                        // follow; PictureData is then preceded
+                                                        // by the op counts, and every section
+                                                        // that follows is padded to 4 bytes
+    kChunked_TrailingStreamByteAfterPictInfo     = 4,   // only after Padded: the op counts, a
+                                                        // count32, that many (bounds, size32),
+                                                        // then that many padded pictures
 };
 
 /* SkPicture impl.  This handles generic responsibilities like unique IDs and serialization. */
@@ -163,8 +180,19 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialPro
     return MakeFromStreamPriv(&stream, procs, nullptr, SkPicturePriv::kDefaultRecursionLimit);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromMappedData(sk_sp<const SkData> data,
+                                               const SkDeserialProcs* procs) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data->data(), data->size());
+    return MakeFromStreamPriv(&stream, procs, nullptr, SkPicturePriv::kDefaultRecursionLimit,
+                              data.get());
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromStreamPriv(SkStream* stream, const SkDeserialProcs* procsPtr,
-                                               SkTypefacePlayback* typefaces, int recursionLimit) {
+                                               SkTypefacePlayback* typefaces, int recursionLimit,
+                                               const SkData* mapped) {
     if (recursionLimit <= 0) {
         return nullptr;
     }
@@ -180,11 +208,30 @@ sk_sp<SkPicture> SkPicture::MakeFromStreamPriv(SkStream* stream, const SkDeseria
 
     uint8_t trailingStreamByteAfterPictInfo;
     if (!stream->readU8(&trailingStreamByteAfterPictInfo)) { return nullptr; }
+    const bool padded = trailingStreamByteAfterPictInfo == kPadded_TrailingStreamByteAfterPictInfo;
+    if (padded) {
+        uint16_t padding;
+        if (!stream->readU8(&trailingStreamByteAfterPictInfo) || !stream->readU16(&padding)) {
+            return nullptr;
+        }
+    }
     switch (trailingStreamByteAfterPictInfo) {
         case kPictureData_TrailingStreamByteAfterPictInfo: {
+            int32_t opCount = 0,
+                    nestedOpCount = 0;
+            if (padded && (!stream->readS32(&opCount) || !stream->readS32(&nestedOpCount))) {
+                return nullptr;
+            }
+            // Only the padded layout can be used in place.
+            if (!padded) {
+                mapped = nullptr;
+            }
             std::unique_ptr<SkPictureData> data(
                     SkPictureData::CreateFromStream(stream, info, procs, typefaces,
-                                                    recursionLimit));
+                                                    recursionLimit, padded, mapped));
+            if (mapped && data && data->opData()) {
+                return sk_make_sp<SkMappedPicture>(std::move(data), opCount, nestedOpCount);
+            }
             return Forwardport(info, data.get(), nullptr);
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
@@ -200,8 +247,68 @@ sk_sp<SkPicture> SkPicture::MakeFromStreamPriv(SkStream* stream, const SkDeseria
             if (stream->read(data->writable_data(), size) != size) {
                 return nullptr;
             }
+            if (padded && stream->skip(SkAlign4(size) - size) != SkAlign4(size) - size) {
+                return nullptr;
+            }
             return procs.fPictureProc(data->data(), size, procs.fPictureCtx);
         }
+        case kChunked_TrailingStreamByteAfterPictInfo: {
+            int32_t opCount, nestedOpCount;
+            uint32_t count;
+            if (!padded || !stream->readS32(&opCount) || !stream->readS32(&nestedOpCount) ||
+                !stream->readU32(&count) ||
+                SkStreamPriv::RemainingLengthIsBelow(stream, SkSafeMath::Mul(count, 20))) {
+                return nullptr;
+            }
+            auto chunks = std::make_unique<SkChunkedPicture::Chunk[]>(count);
+            SkSafeMath safe;
+            size_t total = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                SkChunkedPicture::Chunk& chunk = chunks[i];
+                uint32_t size;
+                if (!stream->readScalar(&chunk.fBounds.fLeft)   ||
+                    !stream->readScalar(&chunk.fBounds.fTop)    ||
+                    !stream->readScalar(&chunk.fBounds.fRight)  ||
+                    !stream->readScalar(&chunk.fBounds.fBottom) ||
+                    !stream->readU32(&size) || !SkIsAlign4(size)) {
+                    return nullptr;
+                }
+                chunk.fOffset = total;
+                chunk.fSize = size;
+                total = safe.add(total, size);
+            }
+            if (!safe || SkStreamPriv::RemainingLengthIsBelow(stream, total)) {
+                return nullptr;
+            }
+            // Chunks are read from mapped data in place, and otherwise copied once, up front.
+            sk_sp<const SkData> chunkData;
+            if (mapped && stream->hasPosition() &&
+                stream->getMemoryBase() == mapped->data() &&
+                stream->getPosition() <= mapped->size() - total) {
+                chunkData = mapped->shareSubset(stream->getPosition(), total);
+                if (stream->skip(total) != total) {
+                    return nullptr;
+                }
+            } else {
+                chunkData = SkData::MakeFromStream(stream, total);
+            }
+            if (!chunkData) {
+                return nullptr;
+            }
+            // Chunks are only deserialized when first drawn, so check now that each at least
+            // starts like a picture, and fail the load rather than silently drop one later.
+            for (uint32_t i = 0; i < count; i++) {
+                SkMemoryStream chunkStream(chunkData->bytes() + chunks[i].fOffset,
+                                           chunks[i].fSize, /*copyData=*/false);
+                SkPictInfo chunkInfo;
+                if (!StreamIsSKP(&chunkStream, &chunkInfo)) {
+                    return nullptr;
+                }
+            }
+            return sk_make_sp<SkChunkedPicture>(info.fCullRect, opCount, nestedOpCount,
+                                                std::move(chunks), SkToInt(count),
+                                                std::move(chunkData), procs, recursionLimit - 1);
+        }
         default:    // fall out to error return
             break;
     }
@@ -253,6 +360,88 @@ sk_sp<SkData> SkPicture::serialize(const SkSerialProcs* procs) const {
     return stream.detachAsData();
 }
 
+sk_sp<SkData> SkPicture::serializeForMapping(const SkSerialProcs* procs) const {
+    SkDynamicMemoryWStream stream;
+    this->serialize(&stream, procs, nullptr, /*textBlobsOnly=*/false, /*padded=*/true);
+    return stream.detachAsData();
+}
+
+sk_sp<SkData> SkPicture::serializeChunked(SkScalar chunkSize, const SkSerialProcs* procs) const {
+    const SkRect cull = this->cullRect();
+    if (!cull.isFinite() || cull.isEmpty() || !SkIsFinite(cull.width(), cull.height())) {
+        return this->serializeForMapping(procs);
+    }
+    // Small chunks would make for a huge index and replay the picture once per chunk, so there
+    // are never more than kMaxChunksPerSide chunks across a side.
+    static constexpr int kMaxChunksPerSide = 128;
+    const SkScalar longSide = std::max(cull.width(), cull.height());
+    if (!(chunkSize > 0)) {
+        chunkSize = longSide;
+    }
+    chunkSize = std::max(chunkSize, longSide / kMaxChunksPerSide);
+    const int cols = SkTPin(sk_float_ceil2int(cull.width()  / chunkSize), 1, kMaxChunksPerSide),
+              rows = SkTPin(sk_float_ceil2int(cull.height() / chunkSize), 1, kMaxChunksPerSide);
+
+    // Re-record with a bounding box hierarchy, so that playing back into each chunk's clip
+    // only records the ops that touch it.
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    this->playback(recorder.beginRecording(cull, &factory));
+    sk_sp<SkPicture> indexed = recorder.finishRecordingAsPicture();
+
+    struct Chunk {
+        SkRect        fBounds;
+        sk_sp<SkData> fData;
+    };
+    std::vector<Chunk> chunks;
+    // Each chunk's edges are derived from its index, so that rounding cannot accumulate, and the
+    // last row and column always end on the cull rect.
+    auto edge = [chunkSize](SkScalar start, SkScalar end, int i, int count) {
+        return i == count ? end : std::min(start + i * chunkSize, end);
+    };
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            const SkRect bounds = SkRect::MakeLTRB(edge(cull.fLeft, cull.fRight,  x,     cols),
+                                                   edge(cull.fTop,  cull.fBottom, y,     rows),
+                                                   edge(cull.fLeft, cull.fRight,  x + 1, cols),
+                                                   edge(cull.fTop,  cull.fBottom, y + 1, rows));
+            if (bounds.isEmpty()) {
+                continue;
+            }
+            SkCanvas* canvas = recorder.beginRecording(bounds);
+            canvas->save();
+            canvas->clipRect(bounds);
+            indexed->playback(canvas);
+            canvas->restore();
+            sk_sp<SkPicture> chunk = recorder.finishRecordingAsPicture();
+            if (chunk->approximateOpCount() > 0) {
+                chunks.push_back({bounds, chunk->serializeForMapping(procs)});
+            }
+        }
+    }
+
+    SkDynamicMemoryWStream stream;
+    SkPictInfo info = this->createHeader();
+    stream.write(&info, sizeof(info));
+    stream.write8(kPadded_TrailingStreamByteAfterPictInfo);
+    stream.write8(kChunked_TrailingStreamByteAfterPictInfo);
+    stream.write16(0);
+    stream.write32(SkToU32(this->approximateOpCount()));
+    stream.write32(SkToU32(this->approximateOpCount(/*nested=*/true)));
+    stream.write32(SkToU32(chunks.size()));
+    for (const Chunk& chunk : chunks) {
+        stream.writeScalar(chunk.fBounds.fLeft);
+        stream.writeScalar(chunk.fBounds.fTop);
+        stream.writeScalar(chunk.fBounds.fRight);
+        stream.writeScalar(chunk.fBounds.fBottom);
+        stream.write32(SkToU32(chunk.fData->size()));
+    }
+    for (const Chunk& chunk : chunks) {
+        stream.write(chunk.fData->data(), chunk.fData->size());
+    }
+    return stream.detachAsData();
+}
+
 static sk_sp<const SkData> custom_serialize(const SkPicture* picture, const SkSerialProcs& procs) {
     if (procs.fPictureProc) {
         auto data = procs.fPictureProc(const_cast<SkPicture*>(picture), procs.fPictureCtx);
@@ -282,7 +471,7 @@ static bool write_pad32(SkWStream* stream, const void* data, size_t size) {
 // SkPictureData::serialize makes a first pass on all subpictures, indicated by textBlobsOnly=true,
 // to fill typefaceSet.
 void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
-                          SkRefCntSet* typefaceSet, bool textBlobsOnly) const {
+                          SkRefCntSet* typefaceSet, bool textBlobsOnly, bool padded) const {
     SkSerialProcs procs;
     if (procsPtr) {
         procs = *procsPtr;
@@ -291,13 +480,23 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
     SkPictInfo info = this->createHeader();
     stream->write(&info, sizeof(info));
 
+    auto writeTrailingByte = [&](uint8_t trailingByte) {
+        if (padded) {
+            stream->write8(kPadded_TrailingStreamByteAfterPictInfo);
+            stream->write8(trailingByte);
+            stream->write16(0);
+        } else {
+            stream->write8(trailingByte);
+        }
+    };
+
     if (auto custom = custom_serialize(this, procs)) {
         int32_t size = SkToS32(custom->size());
         if (size == 0) {
-            stream->write8(kFailure_TrailingStreamByteAfterPictInfo);
+            writeTrailingByte(kFailure_TrailingStreamByteAfterPictInfo);
             return;
         }
-        stream->write8(kCustom_TrailingStreamByteAfterPictInfo);
+        writeTrailingByte(kCustom_TrailingStreamByteAfterPictInfo);
         stream->write32(-size);    // negative for custom format
         write_pad32(stream, custom->data(), size);
         return;
@@ -305,10 +504,15 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
 
     std::unique_ptr<SkPictureData> data(this->backport());
     if (data) {
-        stream->write8(kPictureData_TrailingStreamByteAfterPictInfo);
-        data->serialize(stream, procs, typefaceSet, textBlobsOnly);
+        writeTrailingByte(kPictureData_TrailingStreamByteAfterPictInfo);
+        if (padded) {
+            // Pictures read in place are not re-recorded, so they cannot count their ops.
+            stream->write32(SkToU32(this->approximateOpCount()));
+            stream->write32(SkToU32(this->approximateOpCount(/*nested=*/true)));
+        }
+        data->serialize(stream, procs, typefaceSet, textBlobsOnly, padded);
     } else {
-        stream->write8(kFailure_TrailingStreamByteAfterPictInfo);
+        writeTrailingByte(kFailure_TrailingStreamByteAfterPictInfo);
     }
 }
 
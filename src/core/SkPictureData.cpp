@@ -13,6 +13,7 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
+#include "include/private/SkAlign.h"
 #include "include/private/SkDebug.h"
 #include "include/private/SkTFitsIn.h"
 #include "include/private/SkTemplates.h"
@@ -30,6 +31,8 @@
 #include "src/core/SkWriteBuffer.h"
 
 #include <cstring>
+#include <memory>
+#include <optional>
 #include <utility>
 
 using namespace skia_private;
@@ -48,6 +51,31 @@ void SkPictureData::initForPlayback() const {
     }
 }
 
+size_t SkPictureData::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this) + fPaints.size() * sizeof(SkPaint);
+    for (const SkPath& path : fPaths) {
+        bytes += path.approximateBytesUsed();
+    }
+    for (const sk_sp<const SkVertices>& vertices : fVertices) {
+        bytes += vertices->approximateSize();
+    }
+    for (const sk_sp<const SkTextBlob>& blob : fTextBlobs) {
+        bytes += sizeof(SkTextBlob);
+        for (SkTextBlobRunIterator it(blob.get()); !it.done(); it.next()) {
+            const size_t perGlyph = sizeof(SkGlyphID) + it.scalarsPerGlyph() * sizeof(SkScalar);
+            bytes += it.glyphCount() * perGlyph + it.textSize();
+        }
+    }
+    for (const sk_sp<const SkPicture>& picture : fPictures) {
+        bytes += picture->approximateBytesUsed();
+    }
+    for (const sk_sp<SkDrawable>& drawable : fDrawables) {
+        bytes += drawable->approximateBytesUsed();
+    }
+    bytes += fTFPlayback.count() * sizeof(sk_sp<SkTypeface>);
+    return bytes;
+}
+
 SkPictureData::SkPictureData(const SkPictureRecord& record,
                              const SkPictInfo& info)
     : fPictures(record.getPictures())
@@ -102,7 +130,37 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
-void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
+// Pads a payload of size bytes out to a multiple of 4.
+static void write_padding(SkWStream* stream, size_t size) {
+    static constexpr uint32_t kZero = 0;
+    stream->write(&kZero, SkAlign4(size) - size);
+}
+
+static bool skip_padding(SkStream* stream, size_t size) {
+    const size_t padding = SkAlign4(size) - size;
+    return stream->skip(padding) == padding;
+}
+
+// If the stream is reading from mapped's memory, and the next size bytes start 4-byte aligned,
+// returns their offset into mapped.
+static std::optional<size_t> mapped_offset(SkStream* stream, size_t size, const SkData* mapped) {
+    if (!mapped || !stream->hasPosition()) {
+        return std::nullopt;
+    }
+    const uint8_t* base = static_cast<const uint8_t*>(stream->getMemoryBase());
+    if (!base) {
+        return std::nullopt;
+    }
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(base + stream->getPosition());
+    const uintptr_t mappedAddr = reinterpret_cast<uintptr_t>(mapped->bytes());
+    if (addr < mappedAddr || size > mapped->size() || addr - mappedAddr > mapped->size() - size ||
+        !SkIsAlign4(addr)) {
+        return std::nullopt;
+    }
+    return addr - mappedAddr;
+}
+
+void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec, bool padded) {
     int count = rec.count();
 
     AutoSTMalloc<16, SkFlattenable::Factory> storage(count);
@@ -128,14 +186,22 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     }
 
     SkASSERT(size == (stream->bytesWritten() - start));
+    if (padded) {
+        write_padding(stream, size);
+    }
 }
 
 void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
-                                   const SkSerialProcs& procs) {
+                                   const SkSerialProcs& procs, bool padded) {
     int count = rec.count();
 
     write_tag_size(stream, SK_PICT_TYPEFACE_TAG, count);
 
+    // Serialized typefaces do not record their own length, so a padded stream writes the length
+    // of the whole section up front to let the reader find the padding.
+    SkDynamicMemoryWStream typefaces;
+    SkWStream* out = padded ? &typefaces : stream;
+
     AutoSTMalloc<16, SkTypeface*> storage(count);
     SkTypeface** array = (SkTypeface**)storage.get();
     rec.copyToArray((SkRefCnt**)array);
@@ -145,7 +211,7 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
         if (procs.fTypefaceProc) {
             auto data = procs.fTypefaceProc(tf, procs.fTypefaceCtx);
             if (data) {
-                stream->write(data->data(), data->size());
+                out->write(data->data(), data->size());
                 continue;
             }
         }
@@ -153,7 +219,14 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
         // kIncludeDataIfLocal does not always work because there is no default
         // fontmgr to pass into SkTypeface::MakeDeserialize, so there is no
         // fontmgr to find a font given the descriptor only.
-        tf->serialize(stream, SkTypeface::SerializeBehavior::kDoIncludeData);
+        tf->serialize(out, SkTypeface::SerializeBehavior::kDoIncludeData);
+    }
+
+    if (padded) {
+        const size_t size = typefaces.bytesWritten();
+        stream->write32(SkToU32(size));
+        typefaces.writeToAndReset(stream);
+        write_padding(stream, size);
     }
 }
 
@@ -226,10 +299,14 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
 // possible that is not relevant to collecting text blobs in topLevelTypeFaceSet
 // TODO(nifong): dedupe typefaces and all other shared resources in a faster and more readable way.
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
-                              SkRefCntSet* topLevelTypeFaceSet, bool textBlobsOnly) const {
+                              SkRefCntSet* topLevelTypeFaceSet, bool textBlobsOnly,
+                              bool padded) const {
     // This can happen at pretty much any time, so might as well do it first.
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
+    if (padded) {
+        write_padding(stream, fOpData->size());
+    }
 
     // We serialize all typefaces into the typeface section of the top-level picture.
     SkRefCntSet localTypefaceSet;
@@ -258,21 +335,24 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
 
     // We need to write factories before we write the buffer.
     // We need to write typefaces before we write the buffer or any sub-picture.
-    WriteFactories(stream, factSet);
+    WriteFactories(stream, factSet, padded);
     // Pass the original typefaceproc (if any) now that we're ready to actually serialize the
     // typefaces. We skipped this proc before, when we were serializing paints, so that the
     // paints would just write indices into our typeface set.
-    WriteTypefaces(stream, *typefaceSet, procs);
+    WriteTypefaces(stream, *typefaceSet, procs, padded);
 
     // Write the buffer.
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
+    if (padded) {
+        write_padding(stream, buffer.bytesWritten());
+    }
 
     // Write sub-pictures by calling serialize again.
     if (!fPictures.empty()) {
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictures.size());
         for (const auto& pic : fPictures) {
-            pic->serialize(stream, &procs, typefaceSet, /*textBlobsOnly=*/ false);
+            pic->serialize(stream, &procs, typefaceSet, /*textBlobsOnly=*/ false, padded);
         }
     }
 
@@ -309,7 +389,9 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t size,
                                    const SkDeserialProcs& procs,
                                    SkTypefacePlayback* topLevelTFPlayback,
-                                   int recursionLimit) {
+                                   int recursionLimit,
+                                   bool padded,
+                                   const SkData* mapped) {
     if (procs.fAllowTagsProc && !procs.fAllowTagsProc(tag, procs.fAllowTagsCtx)) {
         // Typefaces are always set but if there's 0 of them, we won't mark the stream as invalid
         // if the typeface tag is not allowed.
@@ -318,12 +400,20 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
-            if (!fOpData) {
+            if (auto offset = mapped_offset(stream, size, mapped)) {
+                if (stream->skip(size) != size) {
+                    return false;
+                }
+                fOpData = const_cast<SkData*>(mapped)->shareSubset(*offset, size);
+            } else {
+                fOpData = SkData::MakeFromStream(stream, size);
+            }
+            if (!fOpData || (padded && !skip_padding(stream, size))) {
                 return false;
             }
             break;
         case SK_PICT_FACTORY_TAG: {
+            const uint32_t chunkSize = size;
             if (!stream->readU32(&size)) { return false; }
             if (SkStreamPriv::RemainingLengthIsBelow(stream, size)) {
                 return false;
@@ -342,8 +432,33 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                 }
                 fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
             }
+            if (padded && !skip_padding(stream, chunkSize)) {
+                return false;
+            }
         } break;
         case SK_PICT_TYPEFACE_TAG: {
+            // A padded stream prefixes the typefaces with their length in bytes. Read them from
+            // a stream of just that length, so that the padding can be skipped afterwards.
+            SkStream* const parent = stream;
+            uint32_t length = 0;
+            std::unique_ptr<SkStream> typefaces;
+            if (padded) {
+                if (!parent->readU32(&length) ||
+                    SkStreamPriv::RemainingLengthIsBelow(parent, length)) {
+                    return false;
+                }
+                if (auto offset = mapped_offset(parent, 0, mapped)) {
+                    typefaces = std::make_unique<SkMemoryStream>(mapped->bytes() + *offset, length,
+                                                                 /*copyData=*/false);
+                    if (parent->skip(length) != length) {
+                        return false;
+                    }
+                } else {
+                    typefaces = std::make_unique<SkMemoryStream>(
+                            SkData::MakeFromStream(parent, length));
+                }
+                stream = typefaces.get();
+            }
             if (SkStreamPriv::RemainingLengthIsBelow(stream, size)) {
                 return false;
             }
@@ -365,6 +480,9 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                 }
                 fTFPlayback[i] = std::move(tf);
             }
+            if (padded && !skip_padding(parent, length)) {
+                return false;
+            }
         } break;
         case SK_PICT_PICTURE_TAG: {
             SkASSERT(fPictures.empty());
@@ -374,8 +492,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve_exact(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStreamPriv(stream, &procs,
-                                                         topLevelTFPlayback, recursionLimit - 1);
+                auto pic = SkPicture::MakeFromStreamPriv(stream, &procs, topLevelTFPlayback,
+                                                         recursionLimit - 1, mapped);
                 if (!pic) {
                     return false;
                 }
@@ -386,12 +504,28 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             if (SkStreamPriv::RemainingLengthIsBelow(stream, size)) {
                 return false;
             }
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            // Read the buffer in place if it is mapped, letting it share encoded images too.
+            SkAutoMalloc storage;
+            const void* bytes;
+            sk_sp<const SkData> backing;
+            if (auto offset = mapped_offset(stream, size, mapped)) {
+                if (stream->skip(size) != size) {
+                    return false;
+                }
+                bytes = mapped->bytes() + *offset;
+                backing = sk_ref_sp(mapped);
+            } else {
+                if (stream->read(storage.reset(size), size) != size) {
+                    return false;
+                }
+                bytes = storage.get();
+            }
+            if (padded && !skip_padding(stream, size)) {
                 return false;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
+            buffer.setBackingData(std::move(backing));
             buffer.setVersion(fInfo.getVersion());
             // A Picture stream can contain a ReadBuffer which can, in turn, contain more
             // pictures (but not more streams or buffers), so we need to remove 1 from the
@@ -547,7 +681,9 @@ SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
                                                SkTypefacePlayback* topLevelTFPlayback,
-                                               int recursionLimit) {
+                                               int recursionLimit,
+                                               bool padded,
+                                               const SkData* mapped) {
     if (recursionLimit <= 0) {
         return nullptr;
     }
@@ -556,7 +692,7 @@ SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, procs, topLevelTFPlayback, recursionLimit)) {
+    if (!data->parseStream(stream, procs, topLevelTFPlayback, recursionLimit, padded, mapped)) {
         return nullptr;
     }
     return data.release();
@@ -579,7 +715,9 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 bool SkPictureData::parseStream(SkStream* stream,
                                 const SkDeserialProcs& procs,
                                 SkTypefacePlayback* topLevelTFPlayback,
-                                int recursionLimit) {
+                                int recursionLimit,
+                                bool padded,
+                                const SkData* mapped) {
     for (;;) {
         uint32_t tag;
         if (!stream->readU32(&tag)) { return false; }
@@ -589,7 +727,8 @@ bool SkPictureData::parseStream(SkStream* stream,
 
         uint32_t size;
         if (!stream->readU32(&size)) { return false; }
-        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback, recursionLimit)) {
+        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback, recursionLimit,
+                                  padded, mapped)) {
             return false; // we're invalid
         }
     }
@@ -89,26 +89,38 @@ class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
     // Does not affect ownership of SkStream.
+    // If padded, the stream was written with padded=true (see serialize()). If mapped is also
+    // set, the stream reads from mapped's memory, and the op data and buffer are used in place
+    // rather than copied whenever they are 4-byte aligned.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
                                            SkTypefacePlayback*,
-                                           int recursionLimit);
+                                           int recursionLimit,
+                                           bool padded = false,
+                                           const SkData* mapped = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
-    void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false) const;
+    // If padded, every tag's payload is padded to a multiple of 4 bytes, so that each payload
+    // starts 4-byte aligned relative to the start of the picture.
+    void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false,
+                   bool padded=false) const;
     void flatten(SkWriteBuffer&) const;
 
     const SkPictInfo& info() const { return fInfo; }
 
     const sk_sp<SkData>& opData() const { return fOpData; }
 
+    // Approximate heap bytes held by the deserialized contents (paints, paths, vertices, text
+    // blobs, typefaces, sub-pictures and drawables). Neither the op data nor images are counted.
+    size_t approximateBytesUsed() const;
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
     bool parseStream(SkStream*, const SkDeserialProcs&, SkTypefacePlayback*,
-                     int recursionLimit);
+                     int recursionLimit, bool padded, const SkData* mapped);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -156,7 +168,7 @@ private:
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
                         const SkDeserialProcs&, SkTypefacePlayback*,
-                        int recursionLimit);
+                        int recursionLimit, bool padded, const SkData* mapped);
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&, bool textBlobsOnly) const;
 
@@ -180,10 +192,12 @@ private:
 
     const SkPictInfo fInfo;
 
-    static void WriteFactories(SkWStream* stream, const SkFactorySet& rec);
-    static void WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec, const SkSerialProcs&);
+    static void WriteFactories(SkWStream* stream, const SkFactorySet& rec, bool padded);
+    static void WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec, const SkSerialProcs&,
+                               bool padded);
 
     void initForPlayback() const;
+    friend class SkMappedPicture;
 };
 
 #endif
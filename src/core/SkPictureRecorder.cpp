@@ -64,6 +64,11 @@ public:
     SkRect cullRect()             const override { return SkRect::MakeEmpty(); }
 };
 
+void SkPictureRecorder::optimize() {
+    SkRecordOptimize(fRecord.get(), fExtendedOptimizations ? SkRecordExtendedOptimizationPasses()
+                                                           : SkRecordDefaultOptimizationPasses());
+}
+
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
@@ -73,7 +78,7 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
     }
 
     // TODO: delay as much of this work until just before first playback?
-    SkRecordOptimize(fRecord.get());
+    this->optimize();
 
     SkDrawableList* drawableList = fRecorder->getDrawableList();
     std::unique_ptr<SkBigPicture::SnapshotArray> pictList{
@@ -133,7 +138,7 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable() {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
-    SkRecordOptimize(fRecord.get());
+    this->optimize();
 
     if (fBBH) {
         AutoTArray<SkRect> bounds(fRecord->count());
@@ -17,16 +17,21 @@
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTileMode.h"
+#include "src/core/SkResampler.h"
 #include "src/shaders/SkImageShader.h"
 
+#include <optional>
 #include <utility>
 
-struct SkSamplingOptions;
+class SkExecutor;
 
-bool SkPixmap::scalePixels(const SkPixmap& actualDst, const SkSamplingOptions& sampling) const {
+bool SkPixmap::scalePixels(const SkPixmap& actualDst,
+                           const SkSamplingOptions& sampling,
+                           SkExecutor* executor) const {
     // We may need to tweak how we interpret these just a little below, so we make copies.
     SkPixmap src = *this,
              dst = actualDst;
@@ -42,6 +47,12 @@ bool SkPixmap::scalePixels(const SkPixmap& actualDst, const SkSamplingOptions& s
         return src.readPixels(dst);
     }
 
+    // Axis-aligned 8888 scales don't need the full pipeline; filter them separably instead.
+    if (auto kernel = SkResampler::KernelFor(sampling);
+            kernel && SkResampler::CanScale(dst, src)) {
+        return SkResampler::Scale(dst, src, *kernel, executor);
+    }
+
     // If src and dst are both unpremul, we'll fake the source out to appear as if premul,
     // and mark the destination as opaque.  This odd combination allows us to scale unpremul
     // pixels without ever premultiplying them (perhaps losing information in the color channels).
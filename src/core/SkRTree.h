@@ -10,6 +10,7 @@
 
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSpan.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -20,29 +21,48 @@
  * bounding rectangles.
  *
  * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * This performs a bottom-up bulk load, packing the rects into leaves either in the order they
+ * were inserted (which is what we get from recording, and usually reasonable), or sorted with the
+ * STR (sort-tile-recursive) or Hilbert pack algorithms.
  *
- * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
- * which groups rects by position on the Hilbert curve, is probably worth a look). There also
- * exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
+ * Each node stores its children's bounds as one array per edge, so that a query tests several
+ * children at once.
+ *
+ * TODO: There also exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
  *
  * For more details see:
  *
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
  *      an efficient and robust access method for points and rectangles"
+ *  Leutenegger, S.; Lopez, M.; Edgington, J. (1997). "STR: A Simple and Efficient Algorithm
+ *      for R-Tree Packing"
+ *  Kamel, I.; Faloutsos, C. (1993). "On Packing R-trees"
  */
 class SkRTree : public SkBBoxHierarchy {
 public:
-    SkRTree();
+    // How insert() orders the rects before packing them into leaves.
+    enum class BulkLoad {
+        kInsertionOrder,  // Cheapest to build. Best when the rects are already spatially ordered.
+        kSTR,             // Sorts into vertical slices by center x, then each slice by center y.
+        kHilbert,         // Sorts by the Hilbert curve index of the rect centers.
+    };
+
+    explicit SkRTree(BulkLoad = BulkLoad::kInsertionOrder);
 
     void insert(const SkRect[], int N) override;
+    // Results are always in ascending order.
     void search(const SkRect& query, std::vector<int>* results) const override;
     size_t bytesUsed() const override;
 
+    // Writes the indices of the rects intersecting query into results and returns how many there
+    // are, which may be more than results.size(). When they all fit they are in ascending order;
+    // otherwise which ones were written is unspecified. This never allocates.
+    size_t search(const SkRect& query, SkSpan<int> results) const;
+
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fNodes[fRoot].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -51,23 +71,34 @@ public:
                      kMaxChildren = 11;
 
 private:
-    struct Node;
+    // Children are tested four at a time, so node arrays are padded to a multiple of four.
+    static constexpr int kLanes = 4,
+                         kPaddedChildren = (kMaxChildren + kLanes - 1) / kLanes * kLanes;
 
     struct Branch {
-        union {
-            Node* fSubtree;
-            int fOpIndex;
-        };
+        int32_t fIndex;  // Index into fNodes, or the op index at level 0.
         SkRect fBounds;
     };
 
     struct Node {
+        // Unused children have an inverted, infinite rect that intersects nothing.
+        float fLeft  [kPaddedChildren];
+        float fTop   [kPaddedChildren];
+        float fRight [kPaddedChildren];
+        float fBottom[kPaddedChildren];
+        int32_t fChildren[kPaddedChildren];
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
+
+        void setChild(int i, const Branch&);
     };
 
-    void search(Node* root, const SkRect& query, std::vector<int>* results) const;
+    // Calls onHit() with the index of each rect intersecting query, in tree order.
+    template <typename Fn>
+    void forEachHit(const SkRect& query, Fn&& onHit) const;
+
+    // Reorders the leaf branches according to fBulkLoad.
+    void sortBranches(std::vector<Branch>*) const;
 
     // Consumes the input array.
     Branch bulkLoad(std::vector<Branch>* branches, int level = 0);
@@ -75,11 +106,13 @@ private:
     // How many times will bulkLoad() call allocateNodeAtLevel()?
     static int CountNodes(int branches);
 
-    Node* allocateNodeAtLevel(uint16_t level);
+    int allocateNodeAtLevel(uint16_t level);
 
+    BulkLoad fBulkLoad;
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
-    Branch fRoot;
+    int fRoot;
+    SkRect fRootBounds;
     std::vector<Node> fNodes;
 };
 
@@ -8,6 +8,8 @@
 #ifndef SkRasterPipelineOpContexts_DEFINED
 #define SkRasterPipelineOpContexts_DEFINED
 
+#include "include/core/SkTileMode.h"
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -72,9 +74,12 @@ struct GatherCtx {
     int         stride;
     float       width;
     float       height;
-    float       weights[16];  // for bicubic and bicubic_clamp_8888
+    float       weights[16];  // for bicubic, bicubic_clamp_8888 and bicubic_tile_8888
     // Controls whether pixel i-1 or i is selected when floating point sample position is exactly i.
     bool        roundDownAtInteger = false;
+    // Applied to integer texel coordinates by bilerp_tile_8888 and bicubic_tile_8888.
+    SkTileMode  tileModeX = SkTileMode::kClamp;
+    SkTileMode  tileModeY = SkTileMode::kClamp;
 };
 
 // State shared by save_xy, accumulate, and bilinear_* / bicubic_*.
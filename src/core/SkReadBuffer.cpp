@@ -58,6 +58,12 @@ void SkReadBuffer::setMemory(const void* data, size_t size) {
     }
 }
 
+void SkReadBuffer::setBackingData(sk_sp<const SkData> data) {
+    SkASSERT(!data || (data->bytes() <= (const uint8_t*)fBase &&
+                       (const uint8_t*)fStop <= data->bytes() + data->size()));
+    fBackingData = std::move(data);
+}
+
 void SkReadBuffer::setInvalid() {
     if (!fError) {
         // When an error is found, send the read cursor to the end of the stream
@@ -328,6 +334,15 @@ sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
         return nullptr;
     }
 
+    if (fBackingData) {
+        const size_t offset = fCurr + sizeof(uint32_t) - (const char*)fBackingData->data();
+        if (!this->skipByteArray(nullptr)) {
+            return nullptr;
+        }
+        // SkData is immutable once shared, so handing out a mutable subset is safe.
+        return const_cast<SkData*>(fBackingData.get())->shareSubset(offset, numBytes);
+    }
+
     SkAutoMalloc buffer(numBytes);
     if (!this->readByteArray(buffer.get(), numBytes)) {
         return nullptr;
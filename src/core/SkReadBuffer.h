@@ -10,6 +10,7 @@
 
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkFourByteTag.h"
 #include "include/core/SkImageFilter.h"
@@ -61,6 +62,12 @@ public:
 
     void setMemory(const void*, size_t);
 
+    /**
+     *  If the buffer's memory lies within data, byte arrays returned by readByteArrayAsData()
+     *  (e.g. encoded images) share data instead of being copied out of the buffer.
+     */
+    void setBackingData(sk_sp<const SkData> data);
+
     /**
      *  Returns true IFF the version is older than the specified version.
      */
@@ -275,6 +282,8 @@ private:
 
     SkDeserialProcs fProcs;
 
+    sk_sp<const SkData> fBackingData;
+
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
     }
@@ -11,7 +11,9 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/private/SkMath.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkRecord.h"
@@ -20,6 +22,8 @@
 
 #include <cstdint>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
 using namespace SkRecords;
 
@@ -266,7 +270,245 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-void SkRecordOptimize(SkRecord* record) {
+// Intersecting a non-AA clip with two rects is the same as intersecting it with their intersection,
+// as long as the rects stay axis-aligned: mapping and rounding each edge to the pixel grid commute
+// with taking the min/max of the edges. AA clips are left alone, as their coverage along shared
+// edges would be multiplied in twice.
+static bool is_collapsible_clip(const ClipRect& clip) {
+    return clip.opAA.op() == SkClipOp::kIntersect && !clip.opAA.aa();
+}
+
+void SkRecordCollapseClipRects(SkRecord* record) {
+    // Unlike a Pattern, this folds runs of any length in one walk.
+    int previous = -1;
+    for (int i = 0; i < record->count(); i++) {
+        Is<NoOp> noop;
+        Is<ClipRect> clip;
+        if (record->mutate(i, noop)) {
+            continue;
+        }
+        if (!record->mutate(i, clip) || !is_collapsible_clip(*clip.get())) {
+            previous = -1;
+            continue;
+        }
+        if (previous >= 0) {
+            Is<ClipRect> previousClip;
+            record->mutate(previous, previousClip);
+            if (!clip.get()->rect.intersect(previousClip.get()->rect)) {
+                clip.get()->rect.setEmpty();
+            }
+            record->replace<NoOp>(previous);
+        }
+        previous = i;
+    }
+}
+
+struct OverwrittenMatrixNooper {
+    typedef Pattern<Or<Is<SetMatrix>, Is<SetM44>, Is<Concat>, Is<Concat44>,
+                       Is<Translate>, Is<Scale>>,
+                    Greedy<Is<NoOp>>,
+                    Or<Is<SetMatrix>, Is<SetM44>>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match*, int begin, int end) {
+        record->replace<NoOp>(begin);
+        return true;
+    }
+};
+void SkRecordNoopOverwrittenMatrices(SkRecord* record) {
+    OverwrittenMatrixNooper pass;
+    while (apply(&pass, record));
+}
+
+namespace {
+
+enum class OcclusionKind {
+    kSave,
+    kSaveLayer,
+    kRestore,
+    kClip,
+    kBehind,    // Reaches outside what we can reason about, so we leave the record alone.
+    kOccluder,  // Overwrites every pixel in the clip.
+    kCullable,  // Draws, and has no effect once its pixels are overwritten.
+    kOther,
+};
+
+// Whether drawing this paint everywhere replaces the destination, independent of what was there.
+bool overwrites_dst(const SkPaint& paint) {
+    if (paint.getShader() || paint.getColorFilter() || paint.getMaskFilter() ||
+        paint.getImageFilter()) {
+        return false;
+    }
+    std::optional<SkBlendMode> mode = paint.asBlendMode();
+    return mode == SkBlendMode::kSrc ||
+           (mode == SkBlendMode::kSrcOver && 0xFF == paint.getAlpha());
+}
+
+struct ClassifyForOcclusion {
+    OcclusionKind operator()(const Save*)       { return OcclusionKind::kSave; }
+    OcclusionKind operator()(const SaveLayer*)  { return OcclusionKind::kSaveLayer; }
+    OcclusionKind operator()(const Restore*)    { return OcclusionKind::kRestore; }
+    OcclusionKind operator()(const ClipPath*)   { return OcclusionKind::kClip; }
+    OcclusionKind operator()(const ClipRRect*)  { return OcclusionKind::kClip; }
+    OcclusionKind operator()(const ClipRect*)   { return OcclusionKind::kClip; }
+    OcclusionKind operator()(const ClipRegion*) { return OcclusionKind::kClip; }
+    OcclusionKind operator()(const ClipShader*) { return OcclusionKind::kClip; }
+
+    // SaveBehind and DrawBehind reach under earlier draws. ResetClip widens the clip to the
+    // device, possibly past the clip the picture is played back under, so later draws can touch
+    // pixels that an unclipped occluder does not cover.
+    OcclusionKind operator()(const SaveBehind*) { return OcclusionKind::kBehind; }
+    OcclusionKind operator()(const DrawBehind*) { return OcclusionKind::kBehind; }
+    OcclusionKind operator()(const ResetClip*)  { return OcclusionKind::kBehind; }
+
+    // Drawables and pictures may carry annotations or other side effects, so always keep them.
+    OcclusionKind operator()(const DrawDrawable*) { return OcclusionKind::kOther; }
+    OcclusionKind operator()(const DrawPicture*)  { return OcclusionKind::kOther; }
+
+    OcclusionKind operator()(const DrawPaint* op) {
+        return overwrites_dst(op->paint) ? OcclusionKind::kOccluder : OcclusionKind::kCullable;
+    }
+
+    template <typename T>
+    std::enable_if_t<SkToBool(T::kTags & kDraw_Tag), OcclusionKind> operator()(const T*) {
+        return OcclusionKind::kCullable;
+    }
+    template <typename T>
+    std::enable_if_t<!(T::kTags & kDraw_Tag), OcclusionKind> operator()(const T*) {
+        return OcclusionKind::kOther;
+    }
+};
+
+}  // namespace
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    // For each open Save or SaveLayer: whether it is a layer, and whether anything clipped it.
+    struct SaveState {
+        bool fIsLayer;
+        bool fClipped;
+    };
+    std::vector<SaveState> saves;
+    bool clipped = false;
+    int layers = 0;
+    int lastOccluder = -1;
+
+    ClassifyForOcclusion classify;
+    for (int i = 0; i < record->count(); i++) {
+        switch (record->mutate(i, classify)) {
+            case OcclusionKind::kSave:
+                saves.push_back({false, clipped});
+                break;
+            case OcclusionKind::kSaveLayer:
+                saves.push_back({true, clipped});
+                layers++;
+                break;
+            case OcclusionKind::kRestore:
+                if (!saves.empty()) {
+                    clipped = saves.back().fClipped;
+                    layers -= saves.back().fIsLayer ? 1 : 0;
+                    saves.pop_back();
+                }
+                break;
+            case OcclusionKind::kClip:
+                clipped = true;
+                break;
+            case OcclusionKind::kBehind:
+                return;
+            case OcclusionKind::kOccluder:
+                // Inside a layer this only covers the layer, which is then blended onto what's
+                // underneath it.
+                if (!clipped && layers == 0) {
+                    lastOccluder = i;
+                }
+                break;
+            case OcclusionKind::kCullable:
+            case OcclusionKind::kOther:
+                break;
+        }
+    }
+
+    for (int i = 0; i < lastOccluder; i++) {
+        OcclusionKind kind = record->mutate(i, classify);
+        if (kind == OcclusionKind::kCullable || kind == OcclusionKind::kOccluder) {
+            record->replace<NoOp>(i);
+        }
+    }
+}
+
+// SkDevice::drawEdgeAAImageSet() draws each entry with drawImageRect(), using the set's paint with
+// anti-aliasing turned on only for kAll_QuadAAFlags and its alpha scaled by the entry's alpha. So
+// a DrawImageRect becomes an entry with an alpha of 1 and AA flags matching its paint. Image and
+// mask filters are applied to the set as a whole rather than per image, so those can't merge.
+static bool can_merge_image_rect(const DrawImageRect& op) {
+    return !op.paint || (!op.paint->getImageFilter() && !op.paint->getMaskFilter());
+}
+
+static bool image_rects_match(const DrawImageRect& a, const DrawImageRect& b) {
+    if (a.sampling != b.sampling || a.constraint != b.constraint) {
+        return false;
+    }
+    if (!a.paint || !b.paint) {
+        return !a.paint && !b.paint;
+    }
+    return *a.paint == *b.paint;
+}
+
+void SkRecordMergeImageRects(SkRecord* record) {
+    for (int i = 0; i < record->count();) {
+        Is<DrawImageRect> head;
+        if (!record->mutate(i, head) || !can_merge_image_rect(*head.get())) {
+            i++;
+            continue;
+        }
+
+        // Find the run of matching DrawImageRects, allowing NoOps in between.
+        int count = 1, end = i + 1;
+        for (int j = i + 1; j < record->count(); j++) {
+            Is<NoOp> noop;
+            Is<DrawImageRect> next;
+            if (record->mutate(j, noop)) {
+                continue;
+            }
+            if (!record->mutate(j, next) || !image_rects_match(*head.get(), *next.get())) {
+                break;
+            }
+            count++;
+            end = j + 1;
+        }
+        if (count < 2) {
+            i = end;
+            continue;
+        }
+
+        // The head's paint is destroyed when it's replaced, so copy it first.
+        const DrawImageRect* first = head.get();
+        SkPaint* paint = first->paint ? new (record->alloc<SkPaint>()) SkPaint(*first->paint)
+                                      : nullptr;
+        const SkSamplingOptions sampling = first->sampling;
+        const SkCanvas::SrcRectConstraint constraint = first->constraint;
+        const unsigned aaFlags = paint && paint->isAntiAlias() ? SkCanvas::kAll_QuadAAFlags
+                                                               : SkCanvas::kNone_QuadAAFlags;
+
+        skia_private::AutoTArray<SkCanvas::ImageSetEntry> set(count);
+        for (int j = i, n = 0; j < end; j++) {
+            Is<DrawImageRect> op;
+            if (record->mutate(j, op)) {
+                set[n++] = SkCanvas::ImageSetEntry(
+                        op.get()->image, op.get()->src, op.get()->dst, 1.f, aaFlags);
+                if (j != i) {
+                    record->replace<NoOp>(j);
+                }
+            }
+        }
+        new (record->replace<DrawEdgeAAImageSet>(i)) DrawEdgeAAImageSet{
+                paint, std::move(set), count, nullptr, nullptr, sampling, constraint};
+        i = end;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static constexpr SkRecordOptimizationPass kDefaultPasses[] = {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
     // and the bounding box hierarchy will do the work of skipping no-op
@@ -274,15 +516,45 @@ void SkRecordOptimize(SkRecord* record) {
     // As there is a known problem with this peephole and drawAnnotation, disable this.
     // If we want to enable this we must first fix this bug:
     //     https://bugs.chromium.org/p/skia/issues/detail?id=5548
-//    SkRecordNoopSaveRestores(record);
+//    SkRecordNoopSaveRestores,
 
     // Turn off this optimization completely for Android framework
     // because it makes the following Android CTS test fail:
     // android.uirendering.cts.testclasses.LayerTests#testSaveLayerClippedWithAlpha
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
-    SkRecordNoopSaveLayerDrawRestores(record);
+    SkRecordNoopSaveLayerDrawRestores,
 #endif
-    SkRecordMergeSvgOpacityAndFilterLayers(record);
+    SkRecordMergeSvgOpacityAndFilterLayers,
+};
+
+static constexpr SkRecordOptimizationPass kExtendedPasses[] = {
+#ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
+    SkRecordNoopSaveLayerDrawRestores,
+#endif
+    SkRecordMergeSvgOpacityAndFilterLayers,
+    // Culling first leaves fewer commands for the rest to walk, and its NoOps let the clip and
+    // matrix passes see through to the commands on either side.
+    SkRecordNoopOccludedDraws,
+    SkRecordCollapseClipRects,
+    SkRecordNoopOverwrittenMatrices,
+    SkRecordMergeImageRects,
+};
 
+SkSpan<const SkRecordOptimizationPass> SkRecordDefaultOptimizationPasses() {
+    return kDefaultPasses;
+}
+
+SkSpan<const SkRecordOptimizationPass> SkRecordExtendedOptimizationPasses() {
+    return kExtendedPasses;
+}
+
+void SkRecordOptimize(SkRecord* record, SkSpan<const SkRecordOptimizationPass> passes) {
+    for (SkRecordOptimizationPass pass : passes) {
+        pass(record);
+    }
     record->defrag();
 }
+
+void SkRecordOptimize(SkRecord* record) {
+    SkRecordOptimize(record, SkRecordDefaultOptimizationPasses());
+}
@@ -8,11 +8,28 @@
 #ifndef SkRecordOpts_DEFINED
 #define SkRecordOpts_DEFINED
 
+#include "include/core/SkSpan.h"
+
 class SkRecord;
 
+// A single optimization pass. Passes may leave NoOps behind; SkRecordOptimize() defrags after
+// running all of them.
+using SkRecordOptimizationPass = void (*)(SkRecord*);
+
 // Run all optimizations in recommended order.
 void SkRecordOptimize(SkRecord*);
 
+// Run the given passes in order, then defrag the record.
+void SkRecordOptimize(SkRecord*, SkSpan<const SkRecordOptimizationPass>);
+
+// The passes run by SkRecordOptimize(SkRecord*).
+SkSpan<const SkRecordOptimizationPass> SkRecordDefaultOptimizationPasses();
+
+// The default passes followed by every pass below that is opt-in. Use these for records that are
+// played back through pixel-aligned clips (see SkRecordNoopOccludedDraws).
+// SkPictureRecorder::setExtendedOptimizations() runs these when recording finishes.
+SkSpan<const SkRecordOptimizationPass> SkRecordExtendedOptimizationPasses();
+
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
 void SkRecordNoopSaveRestores(SkRecord*);
 
@@ -26,4 +43,24 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Opt-in passes, not run by SkRecordOptimize(SkRecord*).
+
+// Folds non-AA ClipRect-[NoOp]*-ClipRect intersections into the last clip. This is exact when the
+// clips are axis-aligned in device space; rotated rect clips may differ by rasterization rounding.
+void SkRecordCollapseClipRects(SkRecord*);
+
+// Turns matrix commands that are overwritten by a following SetMatrix or SetM44 into NoOps.
+void SkRecordNoopOverwrittenMatrices(SkRecord*);
+
+// Turns every draw before the last opaque, unclipped, top-level DrawPaint into a NoOp. Annotations,
+// drawables and nested pictures are kept. This assumes the record is played back through a
+// pixel-aligned clip: under an anti-aliased clip the culled draws would still show at its edges.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
+// Merges runs of DrawImageRects that share a paint, sampling and constraint into a single
+// DrawEdgeAAImageSet, which draws the same entries in the same order. Runs of DrawRects are not
+// merged: the canvas has no batched solid-rect call, drawAtlas() needs an image and is never
+// anti-aliased, and experimental_DrawEdgeAAQuad() takes one quad, so it would save nothing.
+void SkRecordMergeImageRects(SkRecord*);
+
 #endif//SkRecordOpts_DEFINED
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkResampler.h"
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPixmap.h"
+#include "include/private/SkAssert.h"
+#include "include/private/SkFloatingPoint.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/core/SkVx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// The filters are defined in src pixel units, and are zero at and beyond their radius.
+float radius(const SkResampler::Kernel& kernel) {
+    switch (kernel.fFilter) {
+        case SkResampler::Filter::kBox:      return 0.5f;
+        case SkResampler::Filter::kTriangle: return 1;
+        case SkResampler::Filter::kCubic:    return 2;
+        case SkResampler::Filter::kLanczos3: return 3;
+    }
+    SkUNREACHABLE;
+}
+
+float sinc(float x) {
+    if (x == 0) {
+        return 1;
+    }
+    x *= SK_FloatPI;
+    return std::sin(x) / x;
+}
+
+// See SkCubicResampler, and SkImageShader::CubicResamplerMatrix() for the same family written as
+// a polynomial in the fractional offset.
+float cubic(float x, float B, float C) {
+    x = std::fabs(x);
+    if (x < 1) {
+        return ((12 - 9*B - 6*C)*x*x*x + (-18 + 12*B + 6*C)*x*x + (6 - 2*B)) * (1/6.0f);
+    }
+    if (x < 2) {
+        return ((-B - 6*C)*x*x*x + (6*B + 30*C)*x*x + (-12*B - 48*C)*x + (8*B + 24*C)) * (1/6.0f);
+    }
+    return 0;
+}
+
+// The weight of the src pixel whose center is 'x' filter units away from the sample point. The box
+// filter is integrated over the pixel instead, so that non-integer downscales still weigh each src
+// pixel by how much of it the dst pixel covers; 'width' is the pixel's width in filter units.
+float weight(const SkResampler::Kernel& kernel, float x, float width) {
+    switch (kernel.fFilter) {
+        case SkResampler::Filter::kBox: {
+            const float lo = std::max(x - 0.5f * width, -0.5f),
+                        hi = std::min(x + 0.5f * width,  0.5f);
+            return std::max(hi - lo, 0.0f);
+        }
+        case SkResampler::Filter::kTriangle:
+            return std::max(1 - std::fabs(x), 0.0f);
+        case SkResampler::Filter::kCubic:
+            return cubic(x, kernel.fCubic.B, kernel.fCubic.C);
+        case SkResampler::Filter::kLanczos3:
+            return std::fabs(x) < 3 ? sinc(x) * sinc(x / 3) : 0;
+    }
+    SkUNREACHABLE;
+}
+
+// The filter taps along one axis. Dst pixel i reads the fTaps src pixels starting at fStart[i],
+// weighted by fWeights[i*fTaps ...]. Windows that would run off the edge of the src are clamped,
+// with the weight of the missing pixels folded onto the edge pixel, as SkTileMode::kClamp would.
+struct AxisTaps {
+    int                fTaps;
+    std::vector<int>   fStart;
+    std::vector<float> fWeights;
+
+    AxisTaps(int srcSize, int dstSize, const SkResampler::Kernel& kernel) {
+        const float scale = (float)dstSize / srcSize;
+        // When downscaling, widen the filter to cover the src footprint of each dst pixel.
+        const float filterScale = std::min(scale, 1.0f);
+        const float support = radius(kernel) / filterScale;
+
+        fTaps = std::min(srcSize, (int)std::ceil(2 * support) + 2);
+        fStart.resize(dstSize);
+        fWeights.assign((size_t)dstSize * fTaps, 0);
+
+        for (int i = 0; i < dstSize; ++i) {
+            // Pixel centers are at half-integers, so this maps dst centers to src coordinates just
+            // like the scale matrix scalePixels() draws with.
+            const float center = (i + 0.5f) / scale;
+            const int lo = (int)std::floor(center - support),
+                      hi = (int)std::ceil (center + support);
+            const int start = std::min(std::max(lo, 0), srcSize - fTaps);
+            float* w = &fWeights[(size_t)i * fTaps];
+
+            float sum = 0;
+            for (int j = lo; j <= hi; ++j) {
+                const float wj = weight(kernel, (j + 0.5f - center) * filterScale, filterScale);
+                w[std::clamp(j, 0, srcSize - 1) - start] += wj;
+                sum += wj;
+            }
+            if (sum != 0) {
+                for (int t = 0; t < fTaps; ++t) {
+                    w[t] /= sum;
+                }
+            } else {
+                // Only reachable for degenerate kernels; fall back to the nearest pixel.
+                w[std::clamp((int)center, 0, srcSize - 1) - start] = 1;
+            }
+            fStart[i] = start;
+        }
+    }
+};
+
+using F4 = skvx::float4;
+
+F4 load(const uint32_t* px) {
+    return skvx::cast<float>(skvx::byte4::Load(px));
+}
+
+// Filters dst rows [top, bottom): each row is first filtered vertically into a row of src width,
+// then horizontally into dst. Doing the vertical pass first keeps the intermediate to a single
+// row, and means bands never redo each other's work.
+void scale_rows(const SkPixmap& dst, const SkPixmap& src, const AxisTaps& xTaps,
+                const AxisTaps& yTaps, bool clampToAlpha, int top, int bottom) {
+    std::vector<F4> column(src.width());
+    for (int y = top; y < bottom; ++y) {
+        std::fill(column.begin(), column.end(), F4(0));
+        const float* yw = &yTaps.fWeights[(size_t)y * yTaps.fTaps];
+        for (int t = 0; t < yTaps.fTaps; ++t) {
+            if (yw[t] == 0) {
+                continue;
+            }
+            const F4 w = yw[t];
+            const uint32_t* row = src.addr32(0, yTaps.fStart[y] + t);
+            for (int x = 0; x < src.width(); ++x) {
+                column[x] += w * load(row + x);
+            }
+        }
+
+        uint32_t* out = dst.writable_addr32(0, y);
+        for (int x = 0; x < dst.width(); ++x) {
+            const float* xw = &xTaps.fWeights[(size_t)x * xTaps.fTaps];
+            const F4* in = &column[xTaps.fStart[x]];
+            F4 c = 0;
+            for (int t = 0; t < xTaps.fTaps; ++t) {
+                c += xw[t] * in[t];
+            }
+
+            // Cubic and Lanczos filters overshoot on both sides.
+            c = skvx::pin(c, F4(0), F4(255));
+            if (clampToAlpha) {
+                c = skvx::min(c, F4(c[3]));
+            }
+            skvx::cast<uint8_t>(c + 0.5f).store(out + x);
+        }
+    }
+}
+
+}  // namespace
+
+namespace SkResampler {
+
+std::optional<Kernel> KernelFor(const SkSamplingOptions& sampling) {
+    if (sampling.isAniso()) {
+        return std::nullopt;
+    }
+    if (sampling.useCubic) {
+        return Kernel{Filter::kCubic, sampling.cubic};
+    }
+    if (sampling.filter == SkFilterMode::kLinear && sampling.mipmap != SkMipmapMode::kNone) {
+        return Kernel{Filter::kTriangle};
+    }
+    return std::nullopt;
+}
+
+bool CanScale(const SkPixmap& dst, const SkPixmap& src) {
+    const SkColorType ct = src.colorType();
+    if ((ct != kRGBA_8888_SkColorType && ct != kBGRA_8888_SkColorType) ||
+        dst.colorType() != ct ||
+        !SkColorSpace::Equals(src.colorSpace(), dst.colorSpace())) {
+        return false;
+    }
+    return src.alphaType() == dst.alphaType() || src.alphaType() == kOpaque_SkAlphaType;
+}
+
+bool Scale(const SkPixmap& dst, const SkPixmap& src, const Kernel& kernel, SkExecutor* executor) {
+    if (!CanScale(dst, src) || !src.addr() || !dst.addr() ||
+        src.width() <= 0 || src.height() <= 0 || dst.width() <= 0 || dst.height() <= 0) {
+        return false;
+    }
+
+    const AxisTaps xTaps(src.width(), dst.width(), kernel),
+                   yTaps(src.height(), dst.height(), kernel);
+    // Premul colors can't exceed their alpha. Unpremul ones, which are filtered as they are, can.
+    const bool clampToAlpha = dst.alphaType() != kUnpremul_SkAlphaType;
+
+    static constexpr int64_t kMinPixelsPerBand = 64 * 1024;
+    static constexpr int kMaxBands = 64;
+
+    int bands = 1;
+    if (executor) {
+        bands = (int)std::min<int64_t>({kMaxBands,
+                                        dst.height(),
+                                        dst.width() * (int64_t)dst.height() / kMinPixelsPerBand});
+    }
+    if (bands <= 1) {
+        scale_rows(dst, src, xTaps, yTaps, clampToAlpha, 0, dst.height());
+        return true;
+    }
+
+    SkTaskGroup group(*executor);
+    for (int band = 0; band < bands; ++band) {
+        const int top = dst.height() * band / bands;
+        const int bottom = dst.height() * (band + 1) / bands;
+        group.add([&, top, bottom] {
+            scale_rows(dst, src, xTaps, yTaps, clampToAlpha, top, bottom);
+        });
+    }
+    return true;
+}
+
+}  // namespace SkResampler
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkResampler_DEFINED
+#define SkResampler_DEFINED
+
+#include "include/core/SkSamplingOptions.h"
+
+#include <optional>
+
+class SkExecutor;
+class SkPixmap;
+
+// A separable resampler for axis-aligned scales of 32-bit RGBA and BGRA pixmaps. Each axis gets a
+// precomputed table of filter taps. When downscaling, the filter is widened by the scale factor,
+// so large reductions are filtered over their whole footprint instead of being sampled from a
+// mip level.
+namespace SkResampler {
+
+enum class Filter {
+    kBox,       // Averages the src area covered by each dst pixel.
+    kTriangle,  // Bilinear when upscaling; a tent over twice the footprint when downscaling.
+    kCubic,     // The SkCubicResampler family, e.g. Mitchell or Catmull-Rom.
+    kLanczos3,  // Windowed sinc with three lobes.
+};
+
+struct Kernel {
+    Filter           fFilter = Filter::kCubic;
+    SkCubicResampler fCubic = SkCubicResampler::Mitchell();  // Only used by kCubic.
+};
+
+// The kernel SkPixmap::scalePixels() uses for these sampling options, or nothing if they should
+// keep going through the raster pipeline. Cubic sampling maps to kCubic, and linear sampling with
+// mipmaps to kTriangle. Point sampling and linear sampling without mipmaps are left alone, since
+// their aliasing is part of what was asked for.
+std::optional<Kernel> KernelFor(const SkSamplingOptions&);
+
+// Whether Scale() can convert src into dst: both must be RGBA_8888 or both BGRA_8888, with the same
+// color space, and an alpha type that needs no conversion. Like scalePixels(), unpremul pixels are
+// filtered as they are when both sides are unpremul.
+bool CanScale(const SkPixmap& dst, const SkPixmap& src);
+
+// Scales all of src into all of dst. If an executor is provided, bands of dst rows are filtered on
+// it; the result is the same either way. Returns false, without touching dst, if !CanScale().
+bool Scale(const SkPixmap& dst, const SkPixmap& src, const Kernel&,
+           SkExecutor* executor = nullptr);
+
+}  // namespace SkResampler
+
+#endif  // SkResampler_DEFINED
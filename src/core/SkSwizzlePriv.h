@@ -29,7 +29,14 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. keep the high byte of big-endian 16-bit
+                                            //      channels and insert an opaque alpha
+                           RGB16_to_BGR1,   // i.e. same, and swap RB
+                           RGBA16_to_RGBA,  // i.e. keep the high byte of big-endian 16-bit channels
+                           RGBA16_to_BGRA,  // i.e. same, and swap RB
+                           RGBA16_to_rgbA,  // i.e. same, and premultiply
+                           RGBA16_to_bgrA;  // i.e. same, swap RB and premultiply
 
     void Init_Swizzler();
 }  // namespace SkOpts
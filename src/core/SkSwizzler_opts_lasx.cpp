@@ -32,6 +32,8 @@ namespace SkOpts {
         gray_to_RGB1          = lasx::gray_to_RGB1;
         grayA_to_RGBA         = lasx::grayA_to_RGBA;
         grayA_to_rgbA         = lasx::grayA_to_rgbA;
+        RGBA16_to_rgbA        = lasx::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = lasx::RGBA16_to_bgrA;
         inverted_CMYK_to_RGB1 = lasx::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = lasx::inverted_CMYK_to_BGR1;
     }
@@ -34,6 +34,12 @@ namespace SkOpts {
         gray_to_RGB1          = ml3::gray_to_RGB1;
         grayA_to_RGBA         = ml3::grayA_to_RGBA;
         grayA_to_rgbA         = ml3::grayA_to_rgbA;
+        RGB16_to_RGB1         = ml3::RGB16_to_RGB1;
+        RGB16_to_BGR1         = ml3::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = ml3::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = ml3::RGBA16_to_BGRA;
+        RGBA16_to_rgbA        = ml3::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = ml3::RGBA16_to_bgrA;
         inverted_CMYK_to_RGB1 = ml3::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = ml3::inverted_CMYK_to_BGR1;
     }
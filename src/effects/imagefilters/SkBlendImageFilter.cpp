@@ -309,8 +309,9 @@ skif::FilterResult SkBlendImageFilter::onFilterImage(const skif::Context& ctx) c
 
     skif::Context inputCtx = ctx.withNewDesiredOutput(*requiredInput);
     skif::FilterResult::Builder builder{ctx};
-    builder.add(this->getChildOutput(kBackground, inputCtx));
-    builder.add(this->getChildOutput(kForeground, inputCtx));
+    auto childOutputs = this->getChildOutputs(inputCtx);
+    builder.add(childOutputs[kBackground]);
+    builder.add(childOutputs[kForeground]);
     return builder.eval(
             [&](SkSpan<sk_sp<SkShader>> inputs) -> sk_sp<SkShader> {
                 return this->makeBlendShader(inputs[kBackground], inputs[kForeground]);
@@ -82,10 +82,9 @@ sk_sp<SkFlattenable> SkMergeImageFilter::CreateProc(SkReadBuffer& buffer) {
 ///////////////////////////////////////////////////////////////////////////////
 
 skif::FilterResult SkMergeImageFilter::onFilterImage(const skif::Context& ctx) const {
-    const int inputCount = this->countInputs();
     skif::FilterResult::Builder builder{ctx};
-    for (int i = 0; i < inputCount; ++i) {
-        builder.add(this->getChildOutput(i, ctx));
+    for (const skif::FilterResult& childOutput : this->getChildOutputs(ctx)) {
+        builder.add(childOutput);
     }
     return builder.merge();
 }
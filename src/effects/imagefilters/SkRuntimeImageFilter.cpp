@@ -244,12 +244,13 @@ skif::FilterResult SkRuntimeImageFilter::onFilterImage(const skif::Context& ctx)
 
     skif::Context inputCtx = ctx.withNewDesiredOutput(
             this->applyMaxSampleRadius(ctx.mapping(), ctx.desiredOutput()));
+    auto childOutputs = this->getChildOutputs(inputCtx);
     skif::FilterResult::Builder builder{ctx};
     for (int i = 0; i < inputCount; ++i) {
         // Record the input context's desired output as the sample bounds for the child shaders
         // since the runtime shader can go up to max sample radius away from its desired output
         // (which is the default sample bounds if we didn't override it here).
-        builder.add(this->getChildOutput(i, inputCtx),
+        builder.add(childOutputs[i],
                     inputCtx.desiredOutput(),
                     ShaderFlags::kNonTrivialSampling);
     }
@@ -110,12 +110,13 @@ sk_sp<SkImage> MakeWithFilter(sk_sp<SkImage> src,
                               const SkIRect& subset,
                               const SkIRect& clipBounds,
                               SkIRect* outSubset,
-                              SkIPoint* offset) {
+                              SkIPoint* offset,
+                              SkExecutor* executor) {
     if (!src || !filter) {
         return nullptr;
     }
 
-    sk_sp<skif::Backend> backend = skif::MakeRasterBackend({}, src->colorType());
+    sk_sp<skif::Backend> backend = skif::MakeRasterBackend({}, src->colorType(), executor);
     return as_IFB(filter)->makeImageWithFilter(std::move(backend),
                                                std::move(src),
                                                subset,
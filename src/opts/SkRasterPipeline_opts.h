@@ -5100,6 +5100,43 @@ HIGHP_STAGE(gauss_a_to_rgba, NoCtx) {
     b = a;
 }
 
+// Wraps v onto [0,m), for whole-number v.
+SI F floor_mod(F v, float m) {
+    F r = v - floor_(v * (1.0f / m)) * m;
+    // The reciprocal is inexact, so the quotient can be off by one near multiples of m.
+    r = if_then_else(r < 0, r + m, r);
+    return if_then_else(r >= m, r - m, r);
+}
+
+// Maps a whole-number texel coordinate into [0,size) following an SkTileMode. Decal is clamped
+// like kClamp so it always loads from inside the image; callers mask those texels off.
+SI F tile_texel(F v, SkTileMode mode, float size) {
+    if (mode == SkTileMode::kRepeat) {
+        v = floor_mod(v, size);
+    } else if (mode == SkTileMode::kMirror) {
+        F m = floor_mod(v, 2 * size);
+        v = if_then_else(m < size, m, (2 * size - 1) - m);
+    }
+    return min(max(0.0f, v), size - 1);
+}
+
+// Gathers the 8888 texel at whole-number coordinates (x,y), tiled by ctx's tile modes.
+// Texels outside the image on a decal axis come back as transparent black.
+SI U32 gather_tiled_8888(const SkRasterPipelineContexts::GatherCtx* ctx, F x, F y) {
+    U32 ix = trunc_(tile_texel(y, ctx->tileModeY, ctx->height)) * ctx->stride +
+             trunc_(tile_texel(x, ctx->tileModeX, ctx->width));
+    U32 px = gather_unaligned((const uint32_t*)ctx->pixels, ix);
+    if (ctx->tileModeX == SkTileMode::kDecal) {
+        px = sk_bit_cast<U32>(if_then_else((x >= 0) & (x < ctx->width),
+                                           sk_bit_cast<I32>(px), I32_(0)));
+    }
+    if (ctx->tileModeY == SkTileMode::kDecal) {
+        px = sk_bit_cast<U32>(if_then_else((y >= 0) & (y < ctx->height),
+                                           sk_bit_cast<I32>(px), I32_(0)));
+    }
+    return px;
+}
+
 SI void bilerp_clamp_large(const SkRasterPipelineContexts::GatherCtx* ctx,
                            F* r, F* g, F* b, F* a) {
     // (cx,cy) are the center of our sample.
@@ -5201,6 +5238,61 @@ HIGHP_STAGE(bicubic_clamp_8888, const SkRasterPipelineContexts::GatherCtx* ctx)
     }
 }
 
+// A fused 8888 bilinear image shader for any combination of tile modes. The tiling is applied to
+// the integer texel coordinates of each tap, which matches tiling the tap positions themselves.
+HIGHP_STAGE(bilerp_tile_8888, const SkRasterPipelineContexts::GatherCtx* ctx) {
+    // (x0,y0) is the texel up and to the left of the sample, (tx,ty) the distance past its center.
+    F x0 = floor_(r - 0.5f),
+      y0 = floor_(g - 0.5f),
+      tx = (r - 0.5f) - x0,
+      ty = (g - 0.5f) - y0;
+
+    r = g = b = a = F0;
+    for (int yy = 0; yy <= 1; ++yy)
+    for (int xx = 0; xx <= 1; ++xx) {
+        F sr,sg,sb,sa;
+        from_8888(gather_tiled_8888(ctx, x0 + (float)xx, y0 + (float)yy), &sr,&sg,&sb,&sa);
+
+        F area = (xx ? tx : 1.0f - tx) * (yy ? ty : 1.0f - ty);
+        r = mad(area, sr, r);
+        g = mad(area, sg, g);
+        b = mad(area, sb, b);
+        a = mad(area, sa, a);
+    }
+}
+
+// A fused 8888 bicubic image shader for any combination of tile modes.
+HIGHP_STAGE(bicubic_tile_8888, const SkRasterPipelineContexts::GatherCtx* ctx) {
+    F x0 = floor_(r - 0.5f),
+      y0 = floor_(g - 0.5f),
+      fx = (r - 0.5f) - x0,
+      fy = (g - 0.5f) - y0;
+
+    const float* w = ctx->weights;
+    const F scaley[4] = {bicubic_wts(fy, w[0], w[4], w[ 8], w[12]),
+                         bicubic_wts(fy, w[1], w[5], w[ 9], w[13]),
+                         bicubic_wts(fy, w[2], w[6], w[10], w[14]),
+                         bicubic_wts(fy, w[3], w[7], w[11], w[15])};
+    const F scalex[4] = {bicubic_wts(fx, w[0], w[4], w[ 8], w[12]),
+                         bicubic_wts(fx, w[1], w[5], w[ 9], w[13]),
+                         bicubic_wts(fx, w[2], w[6], w[10], w[14]),
+                         bicubic_wts(fx, w[3], w[7], w[11], w[15])};
+
+    r = g = b = a = F0;
+    for (int yy = 0; yy <= 3; ++yy)
+    for (int xx = 0; xx <= 3; ++xx) {
+        F sr,sg,sb,sa;
+        from_8888(gather_tiled_8888(ctx, x0 + (float)(xx - 1), y0 + (float)(yy - 1)),
+                  &sr,&sg,&sb,&sa);
+
+        F scale = scalex[xx] * scaley[yy];
+        r = mad(scale, sr, r);
+        g = mad(scale, sg, g);
+        b = mad(scale, sb, b);
+        a = mad(scale, sa, a);
+    }
+}
+
 // ~~~~~~ skgpu::Swizzle stage ~~~~~~ //
 
 HIGHP_STAGE(swizzle, void* ctx) {
@@ -6731,6 +6823,43 @@ LOWP_STAGE_GP(evenly_spaced_2_stop_gradient,
                    &r,&g,&b,&a);
 }
 
+// Wraps v onto [0,m), for whole-number v.
+SI F floor_mod(F v, float m) {
+    F r = v - floor_(v * (1.0f / m)) * m;
+    // The reciprocal is inexact, so the quotient can be off by one near multiples of m.
+    r = if_then_else(r < 0.0f, r + m, r);
+    return if_then_else(r >= m, r - m, r);
+}
+
+// Maps a whole-number texel coordinate into [0,size) following an SkTileMode. Decal is clamped
+// like kClamp so it always loads from inside the image; callers mask those texels off.
+SI F tile_texel(F v, SkTileMode mode, float size) {
+    if (mode == SkTileMode::kRepeat) {
+        v = floor_mod(v, size);
+    } else if (mode == SkTileMode::kMirror) {
+        F m = floor_mod(v, 2 * size);
+        v = if_then_else(m < size, m, (2 * size - 1) - m);
+    }
+    return min(max(0.0f, v), size - 1);
+}
+
+// Gathers the 8888 texel at whole-number coordinates (x,y), tiled by ctx's tile modes.
+// Texels outside the image on a decal axis come back as transparent black.
+SI U32 gather_tiled_8888(const SkRasterPipelineContexts::GatherCtx* ctx, F x, F y) {
+    U32 ix = trunc_(tile_texel(y, ctx->tileModeY, ctx->height)) * ctx->stride +
+             trunc_(tile_texel(x, ctx->tileModeX, ctx->width));
+    U32 px = gather_unaligned<U32>((const uint32_t*)ctx->pixels, ix);
+    if (ctx->tileModeX == SkTileMode::kDecal) {
+        px = sk_bit_cast<U32>(if_then_else((x >= 0.0f) & (x < ctx->width),
+                                           sk_bit_cast<I32>(px), I32_(0)));
+    }
+    if (ctx->tileModeY == SkTileMode::kDecal) {
+        px = sk_bit_cast<U32>(if_then_else((y >= 0.0f) & (y < ctx->height),
+                                           sk_bit_cast<I32>(px), I32_(0)));
+    }
+    return px;
+}
+
 LOWP_STAGE_GP(bilerp_clamp_8888, const SkRasterPipelineContexts::GatherCtx* ctx) {
     // Quantize sample point and transform into lerp coordinates converting them to 16.16 fixed
     // point number.
@@ -6855,6 +6984,82 @@ LOWP_STAGE_GP(bilerp_clamp_8888, const SkRasterPipelineContexts::GatherCtx* ctx)
     a = lerpY(topA, bottomA);
 }
 
+// The tiled 8888 filters below never leave integers: the texels are unpacked straight out of their
+// 32-bit words, and the sub-texel position is quantized to fixed point weights.
+LOWP_STAGE_GP(bilerp_tile_8888, const SkRasterPipelineContexts::GatherCtx* ctx) {
+    // (x0,y0) is the texel up and to the left of the sample. (tx,ty) is the distance past its
+    // center, in 1/256ths of a texel, i.e. on [0,256].
+    F x0 = floor_(x - 0.5f),
+      y0 = floor_(y - 0.5f);
+    U32 tx = trunc_(mad((x - 0.5f) - x0, 256.0f, 0.5f)),
+        ty = trunc_(mad((y - 0.5f) - y0, 256.0f, 0.5f));
+
+    U32 tl = gather_tiled_8888(ctx, x0       , y0       ),
+        tr = gather_tiled_8888(ctx, x0 + 1.0f, y0       ),
+        bl = gather_tiled_8888(ctx, x0       , y0 + 1.0f),
+        br = gather_tiled_8888(ctx, x0 + 1.0f, y0 + 1.0f);
+
+    // Each horizontal lerp is 8.8 fixed point, so the vertical lerp lands in 8.16.
+    auto lerp = [&](int shift) -> U16 {
+        U32 top    = ((tl >> shift) & 0xff) * (256 - tx) + ((tr >> shift) & 0xff) * tx,
+            bottom = ((bl >> shift) & 0xff) * (256 - tx) + ((br >> shift) & 0xff) * tx;
+        return cast<U16>((top * (256 - ty) + bottom * ty + 0x8000) >> 16);
+    };
+    r = lerp( 0);
+    g = lerp( 8);
+    b = lerp(16);
+    a = lerp(24);
+}
+
+SI F bicubic_wts(F t, float A, float B, float C, float D) {
+    return mad(t, mad(t, mad(t, D, C), B), A);
+}
+
+// The four bicubic weights along one axis at fractional offset t, in 10-bit fixed point. The last
+// weight absorbs the rounding so that they still sum to exactly 1, keeping flat areas flat.
+SI void bicubic_fixed_wts(const float w[16], F t, I32 q[4]) {
+    q[0] = cast<I32>(floor_(mad(bicubic_wts(t, w[0], w[4], w[ 8], w[12]), 1024.0f, 0.5f)));
+    q[1] = cast<I32>(floor_(mad(bicubic_wts(t, w[1], w[5], w[ 9], w[13]), 1024.0f, 0.5f)));
+    q[2] = cast<I32>(floor_(mad(bicubic_wts(t, w[2], w[6], w[10], w[14]), 1024.0f, 0.5f)));
+    q[3] = 1024 - q[0] - q[1] - q[2];
+}
+
+LOWP_STAGE_GP(bicubic_tile_8888, const SkRasterPipelineContexts::GatherCtx* ctx) {
+    F x0 = floor_(x - 0.5f),
+      y0 = floor_(y - 0.5f);
+
+    I32 wx[4], wy[4];
+    bicubic_fixed_wts(ctx->weights, (x - 0.5f) - x0, wx);
+    bicubic_fixed_wts(ctx->weights, (y - 0.5f) - y0, wy);
+
+    // Filter each row of four texels horizontally, then the four rows vertically. For B and C on
+    // [0,1] the weight magnitudes along an axis sum to at most 1.5, so the 20-bit fixed point sums
+    // stay well inside an I32.
+    I32 sum[4] = {I32_(0), I32_(0), I32_(0), I32_(0)};
+    for (int yy = 0; yy <= 3; ++yy) {
+        I32 row[4] = {I32_(0), I32_(0), I32_(0), I32_(0)};
+        for (int xx = 0; xx <= 3; ++xx) {
+            U32 px = gather_tiled_8888(ctx, x0 + (float)(xx - 1), y0 + (float)(yy - 1));
+            for (int c = 0; c < 4; ++c) {
+                row[c] += sk_bit_cast<I32>((px >> (8 * c)) & 0xff) * wx[xx];
+            }
+        }
+        for (int c = 0; c < 4; ++c) {
+            sum[c] += row[c] * wy[yy];
+        }
+    }
+
+    // Bicubic filtering overshoots on both sides, so clamp to [0,255] here. The clamp_01 or
+    // clamp_gamut that follows takes care of the upper bound relative to alpha.
+    auto narrow = [](I32 v) -> U16 {
+        return cast<U16>(min(max((v + (1 << 19)) >> 20, 0), 255));
+    };
+    r = narrow(sum[0]);
+    g = narrow(sum[1]);
+    b = narrow(sum[2]);
+    a = narrow(sum[3]);
+}
+
 LOWP_STAGE_GG(xy_to_unit_angle, NoCtx) {
     F xabs = abs_(x),
       yabs = abs_(y);
@@ -143,3 +143,34 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 size_t SkDeflateWStream::bytesWritten() const {
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
+
+sk_sp<SkData> SkDeflateCompress(const void* src, size_t length, int compressionLevel) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    SkASSERT(compressionLevel != 0);
+    SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
+    if (!SkTFitsIn<uInt>(length)) {
+        return nullptr;
+    }
+    z_stream zStream;
+    zStream.next_in = nullptr;
+    zStream.zalloc = &skia_alloc_func;
+    zStream.zfree = &skia_free_func;
+    zStream.opaque = nullptr;
+    if (Z_OK != deflateInit2(&zStream, compressionLevel, Z_DEFLATED, 0x0F, 8,
+                             Z_DEFAULT_STRATEGY)) {
+        return nullptr;
+    }
+    const uLong bound = deflateBound(&zStream, SkTo<uLong>(length));
+    sk_sp<SkData> out = SkData::MakeUninitialized(bound);
+    zStream.next_in = static_cast<Bytef*>(const_cast<void*>(src));
+    zStream.avail_in = SkToUInt(length);
+    zStream.next_out = static_cast<Bytef*>(out->writable_data());
+    zStream.avail_out = SkToUInt(bound);
+    const int result = deflate(&zStream, Z_FINISH);
+    const size_t written = bound - zStream.avail_out;
+    (void)deflateEnd(&zStream);
+    if (result != Z_STREAM_END) {
+        return nullptr;
+    }
+    return out->shareSubset(0, written);
+}
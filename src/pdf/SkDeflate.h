@@ -9,6 +9,8 @@
 #ifndef SkFlate_DEFINED
 #define SkFlate_DEFINED
 
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
 #include <cstddef>
 
@@ -53,4 +55,14 @@ private:
     std::unique_ptr<Impl> fImpl;
 };
 
+/**
+  * Compress a whole buffer at once with zlib. For input that is already in memory, this skips
+  * the intermediate buffering and copies of SkDeflateWStream, and writes straight into an
+  * output buffer sized for the worst case.
+  *
+  * @param compressionLevel as for SkDeflateWStream.
+  * @return the zlib-wrapped data, or nullptr on failure.
+  */
+sk_sp<SkData> SkDeflateCompress(const void* src, size_t length, int compressionLevel);
+
 #endif  // SkFlate_DEFINED
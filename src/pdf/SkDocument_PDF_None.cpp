@@ -13,6 +13,8 @@ class SkPDFArray {};
 
 sk_sp<SkDocument> SkPDF::MakeDocument(SkWStream*, const SkPDF::Metadata&) { return nullptr; }
 
+void SkPDF::DrawPictures(SkDocument*, SkSpan<const sk_sp<SkPicture>>, SkExecutor*) {}
+
 void SkPDF::SetNodeId(SkCanvas* c, int n) {
     c->drawAnnotation({0, 0, 0, 0}, "PDF_Node_Key", SkData::MakeWithCopy(&n, sizeof(n)).get());
 }
@@ -18,6 +18,7 @@
 #include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
@@ -33,8 +34,10 @@
 #include "src/core/SkTHash.h"
 #include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
+#include "src/pdf/SkPDFResourceDict.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUnion.h"
+#include "src/pdf/SkPDFUtils.h"
 
 #include <algorithm>
 #include <array>
@@ -99,7 +102,8 @@ void emit_image_stream(SkPDFDocument* doc,
                        SkPDFUnion&& colorSpace,
                        SkPDFIndirectReference sMask,
                        size_t length,
-                       SkPDFStreamFormat format) {
+                       SkPDFStreamFormat format,
+                       bool invertedCMYK = false) {
     if (!ref) {
         return;
     }
@@ -112,6 +116,10 @@ void emit_image_stream(SkPDFDocument* doc,
         pdfDict.insertRef("SMask", sMask);
     }
     pdfDict.insertInt("BitsPerComponent", 8);
+    if (invertedCMYK) {
+        // Adobe CMYK JPEGs store 0 as full ink coverage.
+        pdfDict.insertObject("Decode", SkPDFMakeArray(1, 0, 1, 0, 1, 0, 1, 0));
+    }
     switch (format) {
         case SkPDFStreamFormat::DCT: pdfDict.insertName("Filter", "DCTDecode"); break;
         case SkPDFStreamFormat::Flate: pdfDict.insertName("Filter", "FlateDecode"); break;
@@ -125,7 +133,8 @@ void emit_image_stream(SkPDFDocument* doc,
 }
 
 size_t do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
+    SkPDF::Metadata::CompressionLevel compressionLevel =
+            doc->compressionLevel(SkPDFStreamKind::kImage);
     SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
                              ? SkPDFStreamFormat::Uncompressed
                              : SkPDFStreamFormat::Flate;
@@ -204,7 +213,8 @@ size_t do_deflated_image(const SkPixmap& pm,
                          SkPDFDocument* doc,
                          bool isOpaque,
                          SkPDFIndirectReference ref) {
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
+    SkPDF::Metadata::CompressionLevel compressionLevel =
+            doc->compressionLevel(SkPDFStreamKind::kImage);
     SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
                              ? SkPDFStreamFormat::Uncompressed
                              : SkPDFStreamFormat::Flate;
@@ -284,15 +294,35 @@ size_t do_deflated_image(const SkPixmap& pm,
     return length;
 }
 
+// Draws `image`, which holds a JPEG in its encoded orientation, upright in the unit square that
+// image XObjects are drawn into.
+void emit_oriented_form(SkPDFDocument* doc,
+                        SkPDFIndirectReference ref,
+                        SkPDFIndirectReference image,
+                        SkEncodedOrigin origin) {
+    // The origin matrix is y-down; PDF image space is y-up.
+    const SkMatrix flip = SkMatrix::MakeAll(1, 0, 0, 0, -1, 1, 0, 0, 1);
+    SkMatrix transform = SkMatrix::Concat(flip, SkEncodedOriginToMatrix(origin, 1, 1));
+    transform.preConcat(flip);
+
+    SkDynamicMemoryWStream content;
+    SkPDFUtils::AppendTransform(transform, &content);
+    SkPDFWriteResourceName(&content, SkPDFResourceType::kXObject, image.fValue);
+    content.writeText(" Do\n");
+
+    SkPDFDict form("XObject");
+    form.insertName("Subtype", "Form");
+    form.insertObject("BBox", SkPDFMakeArray(0, 0, 1, 1));
+    form.insertObject("Resources", SkPDFMakeResourceDict({}, {}, {image}, {}));
+    form.insertInt("Length", SkToInt(content.bytesWritten()));
+    doc->emitStream(form, [&content](SkWStream* dst) { content.writeToAndReset(dst); }, ref);
+}
+
 size_t do_jpeg(sk_sp<const SkData> data,
                SkColorSpace* imageColorSpace,
                SkPDFDocument* doc,
                SkISize size,
                SkPDFIndirectReference ref) {
-    if (!ref) {
-        return data->size();
-    }
-
     SkPDF::DecodeJpegCallback decodeJPEG = doc->metadata().jpegDecoder;
     if (!decodeJPEG) {
         return 0;
@@ -304,19 +334,39 @@ size_t do_jpeg(sk_sp<const SkData> data,
 
     SkISize jpegSize = codec->dimensions();
     const SkEncodedInfo& encodedInfo = SkCodecPriv::GetEncodedInfo(codec.get());
-    SkEncodedInfo::Color jpegColorType = encodedInfo.color();
     SkEncodedOrigin exifOrientation = codec->getOrigin();
 
-    bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
-    bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
-    if (jpegSize != size  // Safety check.
-            || !goodColorType
-            || kTopLeft_SkEncodedOrigin != exifOrientation) {
+    int channels;
+    SkPDFUnion colorSpace = SkPDFUnion::Name("DeviceRGB");
+    bool invertedCMYK = false;
+    switch (encodedInfo.color()) {
+        case SkEncodedInfo::kYUV_Color:
+            channels = 3;
+            break;
+        case SkEncodedInfo::kGray_Color:
+            channels = 1;
+            colorSpace = SkPDFUnion::Name("DeviceGray");
+            break;
+        case SkEncodedInfo::kInvertedCMYK_Color:
+        case SkEncodedInfo::kYCCK_Color:
+            // DCTDecode undoes the YCCK transform itself, as directed by the Adobe marker.
+            channels = 4;
+            colorSpace = SkPDFUnion::Name("DeviceCMYK");
+            invertedCMYK = true;
+            break;
+        default:
+            return 0;
+    }
+    // Oriented JPEGs are embedded as encoded and rotated into place by a form XObject.
+    SkISize orientedSize = SkEncodedOriginSwapsWidthHeight(exifOrientation)
+                         ? SkISize{jpegSize.height(), jpegSize.width()}
+                         : jpegSize;
+    if (orientedSize != size) {  // Safety check.
         return 0;
     }
-
-    int channels = yuv ? 3 : 1;
-    SkPDFUnion colorSpace = yuv ? SkPDFUnion::Name("DeviceRGB") : SkPDFUnion::Name("DeviceGray");
+    if (!ref) {
+        return data->size();
+    }
 
     if (sk_sp<const SkData> encodedIccProfileData = encodedInfo.profileData();
         encodedIccProfileData && !icc_channel_mismatch(encodedInfo.profile(), channels))
@@ -336,10 +386,16 @@ size_t do_jpeg(sk_sp<const SkData> data,
         }
     }
 
-    emit_image_stream(doc, ref,
+    SkPDFIndirectReference imageRef =
+            kTopLeft_SkEncodedOrigin == exifOrientation ? ref : doc->reserveRef();
+    emit_image_stream(doc, imageRef,
                       [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
                       jpegSize, std::move(colorSpace),
-                      SkPDFIndirectReference(), SkToInt(data->size()), SkPDFStreamFormat::DCT);
+                      SkPDFIndirectReference(), SkToInt(data->size()), SkPDFStreamFormat::DCT,
+                      invertedCMYK);
+    if (imageRef != ref) {
+        emit_oriented_form(doc, ref, imageRef, exifOrientation);
+    }
     return data->size();
 }
 
@@ -400,22 +456,60 @@ size_t serialize_image(const SkImage* img,
 
 } // namespace
 
+bool SkPDFImageContentKey::Make(const SkImage* img, SkPDFImageContentKey* key) {
+    SkASSERT(img);
+    SkASSERT(key);
+    key->fInfo = img->imageInfo();
+    SkMD5 md5;
+    if (sk_sp<const SkData> data = img->refEncodedData()) {
+        md5.write(data->data(), data->size());
+        key->fDigest = md5.finish();
+        key->fEncoded = true;
+        return true;
+    }
+    SkPixmap pm;
+    if (!img->peekPixels(&pm)) {
+        return false;
+    }
+    const size_t rowBytes = pm.info().minRowBytes();
+    for (int y = 0; y < pm.height(); ++y) {
+        md5.write(pm.addr(0, y), rowBytes);
+    }
+    key->fDigest = md5.finish();
+    key->fEncoded = false;
+    return true;
+}
+
 size_t SkPDFSerializeImageSize(const SkImage* img, SkPDFDocument* doc, int encodingQuality) {
     return serialize_image(img, encodingQuality, doc, SkPDFIndirectReference());
 }
 
+size_t SkPDFPassThroughImageSize(const SkImage* img, SkPDFDocument* doc) {
+    SkASSERT(img);
+    SkASSERT(doc);
+    sk_sp<const SkData> data = img->refEncodedData();
+    return data ? do_jpeg(std::move(data), img->colorSpace(), doc, img->dimensions(),
+                          SkPDFIndirectReference())
+                : 0;
+}
+
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
                                            int encodingQuality) {
     SkASSERT(img);
     SkASSERT(doc);
     SkPDFIndirectReference ref = doc->reserveRef();
-    if (SkExecutor* executor = doc->executor()) {
+    doc->stats().fImageCount++;
+    SkExecutor* executor = doc->executor();
+    // The job may read the image back into a pixel buffer this large.
+    const size_t bytes = img->imageInfo().computeMinByteSize();
+    if (executor && doc->tryQueueJobBytes(bytes)) {
         SkRef(img);
         doc->incrementJobCount();
-        executor->add([img, encodingQuality, doc, ref]() {
+        executor->add([img, encodingQuality, doc, ref, bytes]() {
             serialize_image(img, encodingQuality, doc, ref);
             SkSafeUnref(img);
+            doc->releaseJobBytes(bytes);
             doc->signalJobComplete();
         });
         return ref;
@@ -8,12 +8,15 @@
 #define SkPDFBitmap_DEFINED
 
 #include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
 #include "src/core/SkChecksum.h"
+#include "src/core/SkMD5.h"
 
 #include <cstdint>
+#include <cstring>
 
-class SkImage;
 class SkPDFDocument;
 struct SkPDFIndirectReference;
 
@@ -27,6 +30,12 @@ SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
 
 size_t SkPDFSerializeImageSize(const SkImage* img, SkPDFDocument* doc, int encodingQuality);
 
+/**
+ * If img's encoded data can be embedded as is, without decoding, return its size.  Otherwise
+ * return 0.
+ */
+size_t SkPDFPassThroughImageSize(const SkImage* img, SkPDFDocument* doc);
+
 struct SkPDFIccProfileKey {
     sk_sp<const SkData> fData;
     int fChannels;
@@ -42,4 +51,30 @@ struct SkPDFIccProfileKey {
     };
 };
 
+/** Identifies an image by its content rather than its unique ID: either by the encoded data it
+    will be embedded from, or by its pixels when it has no encoded data.  Only a digest of the
+    content is kept, so the key does not hold on to the image.  Images that can be neither
+    peeked nor passed through as encoded data have no content key.
+*/
+struct SkPDFImageContentKey {
+    SkImageInfo fInfo;
+    SkMD5::Digest fDigest;
+    bool fEncoded = false;  // fDigest is of the encoded data rather than the pixels.
+
+    static bool Make(const SkImage*, SkPDFImageContentKey*);
+
+    bool operator==(const SkPDFImageContentKey& that) const {
+        return fEncoded == that.fEncoded && fDigest == that.fDigest && fInfo == that.fInfo;
+    }
+    bool operator!=(const SkPDFImageContentKey& rhs) const { return !(*this == rhs); }
+
+    struct Hash {
+        uint32_t operator()(const SkPDFImageContentKey& k) const {
+            uint32_t hash;
+            memcpy(&hash, k.fDigest.data, sizeof(hash));
+            return hash;
+        }
+    };
+};
+
 #endif  // SkPDFBitmap_DEFINED
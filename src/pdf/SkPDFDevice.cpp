@@ -469,7 +469,7 @@ void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* v
     if (linkType != SkPDFLink::Type::kNone) {
         std::unique_ptr<SkPDFLink> link = std::make_unique<SkPDFLink>(
             linkType, value, transformedRect, fMarkManager.elemId());
-        fDocument->fCurrentPageLinks.push_back(std::move(link));
+        fDocument->currentPageLinks().push_back(std::move(link));
     }
 }
 
@@ -662,6 +662,7 @@ void SkPDFDevice::setGraphicState(SkPDFIndirectReference gs, SkDynamicMemoryWStr
 
 void SkPDFDevice::clearMaskOnGraphicState(SkDynamicMemoryWStream* contentStream) {
     // The no-softmask graphic state is used to "turn off" the mask for later draw calls.
+    fDocument->waitForPageTurn();
     SkPDFIndirectReference& noSMaskGS = fDocument->fNoSmaskGraphicState;
     if (!noSMaskGS) {
         SkPDFDict tmp("ExtGState");
@@ -958,8 +959,14 @@ void SkPDFDevice::internalDrawGlyphRun(
         return;
     }
 
-    const std::vector<SkUnichar>& glyphToUnicode = SkPDFFont::GetUnicodeMap(typeface, fDocument);
-    THashMap<SkGlyphID, SkString>& glyphToUnicodeEx=SkPDFFont::GetUnicodeMapEx(typeface, fDocument);
+    // Only text with clusters reads (and adds to) the unicode maps, so only it waits for them.
+    const std::vector<SkUnichar>* glyphToUnicode = nullptr;
+    THashMap<SkGlyphID, SkString>* glyphToUnicodeEx = nullptr;
+    if (!glyphRun.text().empty()) {
+        fDocument->waitForPageTurn();
+        glyphToUnicode = &SkPDFFont::GetUnicodeMap(typeface, fDocument);
+        glyphToUnicodeEx = &SkPDFFont::GetUnicodeMapEx(typeface, fDocument);
+    }
 
     // TODO: FontType should probably be on SkPDFStrike?
     SkAdvancedTypefaceMetrics::FontType initialFontType = SkPDFFont::FontType(*pdfStrike, *metrics);
@@ -1011,6 +1018,14 @@ void SkPDFDevice::internalDrawGlyphRun(
     SK_AT_SCOPE_EXIT(if (clusterator.reversedChars()) { out->writeText("EMC\n"); } );
     GlyphPositioner glyphPositioner(out, glyphRunFont.getSkewX(), offset);
     SkPDFFont* font = nullptr;
+    // Glyph usage is noted a font at a time; the fonts are shared with other pages.
+    STArray<64, SkGlyphID> usedGlyphs;
+    auto noteUsedGlyphs = [&font, &usedGlyphs] {
+        if (font && !usedGlyphs.empty()) {
+            font->noteGlyphUsage(SkSpan(usedGlyphs));
+        }
+        usedGlyphs.clear();
+    };
 
     SkBulkGlyphMetricsAndPaths paths{pdfStrike->fPath.fStrikeSpec};
     auto glyphs = paths.glyphs(glyphRun.glyphsIDs());
@@ -1025,6 +1040,7 @@ void SkPDFDevice::internalDrawGlyphRun(
                              out->writeText("EMC\n");
                          });
         if (c.fUtf8Text) {
+            SkASSERT(glyphToUnicode && glyphToUnicodeEx);
             bool toUnicode = false;
             const char* textPtr = c.fUtf8Text;
             const char* textEnd = c.fUtf8Text + c.fTextByteLength;
@@ -1032,7 +1048,7 @@ void SkPDFDevice::internalDrawGlyphRun(
             // ToUnicode can only handle one glyph in a cluster.
             if (clusterUnichar >= 0 && c.fGlyphCount == 1) {
                 SkGlyphID gid = glyphIDs[glyphIndex];
-                SkUnichar fontUnichar = gid < glyphToUnicode.size() ? glyphToUnicode[gid] : 0;
+                SkUnichar fontUnichar = gid < glyphToUnicode->size() ? (*glyphToUnicode)[gid] : 0;
 
                 // The regular cmap can handle this if there is one glyph in the cluster,
                 // one code point in the cluster, and the glyph maps to the code point.
@@ -1044,9 +1060,9 @@ void SkPDFDevice::internalDrawGlyphRun(
                 // and the mapping matches or can be added.
                 // UTF-16 uses at most 2x space of UTF-8; 64 code points seems enough.
                 if (!toUnicode && fontUnichar <= 0 && c.fTextByteLength < 256) {
-                    SkString* unicodes = glyphToUnicodeEx.find(gid);
+                    SkString* unicodes = glyphToUnicodeEx->find(gid);
                     if (!unicodes) {
-                        glyphToUnicodeEx.set(gid, SkString(c.fUtf8Text, c.fTextByteLength));
+                        glyphToUnicodeEx->set(gid, SkString(c.fUtf8Text, c.fTextByteLength));
                         toUnicode = true;
                     } else if (unicodes->equals(c.fUtf8Text, c.fTextByteLength)) {
                         toUnicode = true;
@@ -1083,6 +1099,7 @@ void SkPDFDevice::internalDrawGlyphRun(
             }
             if (needs_new_font(font, glyphs[glyphIndex], initialFontType)) {
                 // Not yet specified font or need to switch font.
+                noteUsedGlyphs();
                 font = pdfStrike->getFontResource(glyphs[glyphIndex]);
                 SkASSERT(font);  // All preconditions for SkPDFFont::GetFontResource are met.
                 glyphPositioner.setFont(font);
@@ -1093,7 +1110,7 @@ void SkPDFDevice::internalDrawGlyphRun(
                 out->writeText(" Tf\n");
 
             }
-            font->noteGlyphUsage(gid);
+            usedGlyphs.push_back(gid);
             SkGlyphID encodedGlyph = font->glyphToPDFFontEncoding(gid);
             SkScalar advance = advanceScale * glyphs[glyphIndex]->advanceX();
             if (fMarkManager.hasActiveMark()) {
@@ -1103,6 +1120,7 @@ void SkPDFDevice::internalDrawGlyphRun(
             glyphPositioner.writeGlyph(encodedGlyph, advance, xy);
         }
     }
+    noteUsedGlyphs();
 }
 
 void SkPDFDevice::onDrawGlyphRunList(SkCanvas*,
@@ -1808,13 +1826,24 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
         // (maybe in the resource cache?)
     }
 
+    // Images are sized, looked up and serialized in page order.
+    fDocument->waitForPageTurn();
     bool useCroppedOriginal = false;
     if (didSubset && canUseOriginal) {
-        size_t originalSize = SkPDFSerializeImageSize(
-            originalImage.image().get(), fDocument, fDocument->metadata().fEncodingQuality);
-        size_t subsetSize = SkPDFSerializeImageSize(
-            imageSubset.image().get(), fDocument, fDocument->metadata().fEncodingQuality);
-        if (originalSize <= subsetSize) {
+        // Embedding an original that passes through as is, clipped to the subset, avoids decoding
+        // and re-encoding it, and is worth it unless the subset is a small part of the original.
+        // Otherwise pick whichever serializes smaller.
+        const SkImage* original = originalImage.image().get();
+        const SkISize subsetSize = imageSubset.image()->dimensions();
+        bool preferOriginal = SkPDFPassThroughImageSize(original, fDocument) &&
+                              2 * subsetSize.area() >= original->dimensions().area();
+        if (!preferOriginal) {
+            preferOriginal = SkPDFSerializeImageSize(original, fDocument,
+                                                     fDocument->metadata().fEncodingQuality) <=
+                             SkPDFSerializeImageSize(imageSubset.image().get(), fDocument,
+                                                     fDocument->metadata().fEncodingQuality);
+        }
+        if (preferOriginal) {
             matrix = originalTransform;
             imageSubset = originalImage;
             useCroppedOriginal = true;
@@ -1854,8 +1883,20 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
     if (!pdfimagePtr) {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
-                                       fDocument->metadata().fEncodingQuality);
+        SkPDFImageContentKey contentKey;
+        bool hasContentKey = fDocument->metadata().fDeduplicateImageContent &&
+                             SkPDFImageContentKey::Make(imageSubset.image().get(), &contentKey);
+        if (SkPDFIndirectReference* contentPtr =
+                    hasContentKey ? fDocument->fPDFImageContentMap.find(contentKey) : nullptr) {
+            pdfimage = *contentPtr;
+            fDocument->stats().fImageContentDuplicateCount++;
+        } else {
+            pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
+                                           fDocument->metadata().fEncodingQuality);
+            if (hasContentKey) {
+                fDocument->fPDFImageContentMap.set(std::move(contentKey), pdfimage);
+            }
+        }
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
         fDocument->fPDFBitmapMap.set(key, pdfimage);
     }
@@ -9,8 +9,11 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSize.h"
@@ -25,6 +28,7 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
 #include "src/core/SkTHash.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkUTF.h"
 #include "src/pdf/SkBitmapKey.h"
 #include "src/pdf/SkPDFBitmap.h"
@@ -43,6 +47,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <memory>
 #include <new>
 #include <utility>
 
@@ -163,68 +168,101 @@ static void serialize_footer(const SkPDFOffsetMap& offsetMap,
     wStream->writeText("\n%%EOF\n");
 }
 
+// PDF wants a tree describing all the pages in the document.  We arbitrary
+// choose 8 (kMaxPageTreeNodeSize) as the number of allowed children.  The internal
+// nodes have type "Pages" with an array of children, a parent pointer, and
+// the number of leaves below the node as "Count."  The leaves have type "Page"
+// and need a parent pointer.
+static constexpr size_t kMaxPageTreeNodeSize = 8;
+
+namespace {
+struct PageTreeNode {
+    std::unique_ptr<SkPDFDict> fNode;
+    SkPDFIndirectReference fReservedRef;
+    int fPageObjectDescendantCount;
+
+    static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
+        std::vector<PageTreeNode> result;
+        const size_t n = vec.size();
+        SkASSERT(!vec.empty());
+        const size_t result_len = (n - 1) / kMaxPageTreeNodeSize + 1;
+        SkASSERT(result_len >= 1);
+        SkASSERT(n == 1 || result_len < n);
+        result.reserve(result_len);
+        size_t index = 0;
+        for (size_t i = 0; i < result_len; ++i) {
+            if (n != 1 && index + 1 == n) {  // No need to create a new node.
+                result.push_back(std::move(vec[index++]));
+                continue;
+            }
+            SkPDFIndirectReference parent = doc->reserveRef();
+            auto kids_list = SkPDFMakeArray();
+            int descendantCount = 0;
+            for (size_t j = 0; j < kMaxPageTreeNodeSize && index < n; ++j) {
+                PageTreeNode& node = vec[index++];
+                node.fNode->insertRef("Parent", parent);
+                kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
+                descendantCount += node.fPageObjectDescendantCount;
+            }
+            auto next = SkPDFMakeDict("Pages");
+            next->insertInt("Count", descendantCount);
+            next->insertObject("Kids", std::move(kids_list));
+            result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
+        }
+        return result;
+    }
+
+    // Builds the rest of the tree bottom up, skipping internal nodes that would have only
+    // one child, and emits it.
+    static SkPDFIndirectReference EmitTree(std::vector<PageTreeNode> layer, SkPDFDocument* doc) {
+        while (layer.size() > 1) {
+            layer = Layer(std::move(layer), doc);
+        }
+        SkASSERT(layer.size() == 1);
+        const PageTreeNode& root = layer[0];
+        return doc->emit(*root.fNode, root.fReservedRef);
+    }
+};
+}  // namespace
+
 static SkPDFIndirectReference generate_page_tree(
         SkPDFDocument* doc,
         std::vector<std::unique_ptr<SkPDFDict>> pages,
         const std::vector<SkPDFIndirectReference>& pageRefs) {
-    // PDF wants a tree describing all the pages in the document.  We arbitrary
-    // choose 8 (kMaxNodeSize) as the number of allowed children.  The internal
-    // nodes have type "Pages" with an array of children, a parent pointer, and
-    // the number of leaves below the node as "Count."  The leaves are passed
-    // into the method, have type "Page" and need a parent pointer. This method
-    // builds the tree bottom up, skipping internal nodes that would have only
-    // one child.
     SkASSERT(!pages.empty());
-    struct PageTreeNode {
-        std::unique_ptr<SkPDFDict> fNode;
-        SkPDFIndirectReference fReservedRef;
-        int fPageObjectDescendantCount;
-
-        static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
-            std::vector<PageTreeNode> result;
-            static constexpr size_t kMaxNodeSize = 8;
-            const size_t n = vec.size();
-            SkASSERT(!vec.empty());
-            const size_t result_len = (n - 1) / kMaxNodeSize + 1;
-            SkASSERT(result_len >= 1);
-            SkASSERT(n == 1 || result_len < n);
-            result.reserve(result_len);
-            size_t index = 0;
-            for (size_t i = 0; i < result_len; ++i) {
-                if (n != 1 && index + 1 == n) {  // No need to create a new node.
-                    result.push_back(std::move(vec[index++]));
-                    continue;
-                }
-                SkPDFIndirectReference parent = doc->reserveRef();
-                auto kids_list = SkPDFMakeArray();
-                int descendantCount = 0;
-                for (size_t j = 0; j < kMaxNodeSize && index < n; ++j) {
-                    PageTreeNode& node = vec[index++];
-                    node.fNode->insertRef("Parent", parent);
-                    kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
-                    descendantCount += node.fPageObjectDescendantCount;
-                }
-                auto next = SkPDFMakeDict("Pages");
-                next->insertInt("Count", descendantCount);
-                next->insertObject("Kids", std::move(kids_list));
-                result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
-            }
-            return result;
-        }
-    };
     std::vector<PageTreeNode> currentLayer;
     currentLayer.reserve(pages.size());
     SkASSERT(pages.size() == pageRefs.size());
     for (size_t i = 0; i < pages.size(); ++i) {
         currentLayer.push_back(PageTreeNode{std::move(pages[i]), pageRefs[i], 1});
     }
-    currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
-    while (currentLayer.size() > 1) {
-        currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
+    // The root is always a "Pages" node, even with a single page.
+    return PageTreeNode::EmitTree(PageTreeNode::Layer(std::move(currentLayer), doc), doc);
+}
+
+// The pages have already been emitted, each naming its parent from parentRefs: one parent for
+// each run of kMaxPageTreeNodeSize pages.
+static SkPDFIndirectReference generate_streamed_page_tree(
+        SkPDFDocument* doc,
+        const std::vector<SkPDFIndirectReference>& pageRefs,
+        const std::vector<SkPDFIndirectReference>& parentRefs) {
+    SkASSERT(!pageRefs.empty());
+    SkASSERT(parentRefs.size() == (pageRefs.size() - 1) / kMaxPageTreeNodeSize + 1);
+    std::vector<PageTreeNode> currentLayer;
+    currentLayer.reserve(parentRefs.size());
+    for (size_t i = 0; i < parentRefs.size(); ++i) {
+        const size_t begin = i * kMaxPageTreeNodeSize;
+        const size_t end = std::min(begin + kMaxPageTreeNodeSize, pageRefs.size());
+        auto kids_list = SkPDFMakeArray();
+        for (size_t j = begin; j < end; ++j) {
+            kids_list->appendRef(pageRefs[j]);
+        }
+        auto node = SkPDFMakeDict("Pages");
+        node->insertInt("Count", SkToInt(end - begin));
+        node->insertObject("Kids", std::move(kids_list));
+        currentLayer.push_back(PageTreeNode{std::move(node), parentRefs[i], SkToInt(end - begin)});
     }
-    SkASSERT(currentLayer.size() == 1);
-    const PageTreeNode& root = currentLayer[0];
-    return doc->emit(*root.fNode, root.fReservedRef);
+    return PageTreeNode::EmitTree(std::move(currentLayer), doc);
 }
 
 template<typename T, typename... Args>
@@ -268,9 +306,29 @@ void SkPDFDocument::endObject() SK_REQUIRES(fMutex) {
 static SkSize operator*(SkISize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 
-SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
-    SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+thread_local SkPDFDocument::Page* SkPDFDocument::sDrawingPage = nullptr;
+
+SkPDFDocument::Page* SkPDFDocument::drawingPage() const {
+    return sDrawingPage && sDrawingPage->fDocument == this ? sDrawingPage : fCurrentPage.get();
+}
+
+sk_sp<SkPDFDevice> SkPDFDocument::makePageDevice(SkScalar width, SkScalar height) {
+    // By scaling the page at the device level, we will create bitmap layer
+    // devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
+    // devices are created when saveLayer is called with an ImageFilter;  see
+    // SkPDFDevice::createDevice().
+    SkISize pageSize = (SkSize{width, height} * fRasterScale).toRound();
+    SkMatrix initialTransform;
+    // Skia uses the top left as the origin but PDF natively has the origin at the
+    // bottom left. This matrix corrects for that, as well as the raster scale.
+    initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
+                                       0, fInverseRasterScale * pageSize.height());
+    return sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
+}
+
+void SkPDFDocument::startPage(Page* page) {
+    SkASSERT(page->fHasTurn);
+    if (fPageRefs.empty()) {
         // if this is the first page if the document.
         {
             SkAutoMutexExclusive autoMutexAcquire(fMutex);
@@ -289,20 +347,31 @@ SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
             fXMP = SkPDFMetadata::MakeXMPObject(fMetadata, fUUID, fUUID, this);
         }
     }
-    // By scaling the page at the device level, we will create bitmap layer
-    // devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
-    // devices are created when saveLayer is called with an ImageFilter;  see
-    // SkPDFDevice::createDevice().
-    SkISize pageSize = (SkSize{width, height} * fRasterScale).toRound();
-    SkMatrix initialTransform;
-    // Skia uses the top left as the origin but PDF natively has the origin at the
-    // bottom left. This matrix corrects for that, as well as the raster scale.
-    initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
-                                       0, fInverseRasterScale * pageSize.height());
-    fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
-    reset_object(&fCanvas, fPageDevice);
+    page->fIndex = fPageRefs.size();
+    page->fRef = this->reserveRef();
+    fPageRefs.push_back(page->fRef);
+}
+
+void SkPDFDocument::waitForPageTurn() {
+    Page* page = sDrawingPage;
+    if (!page || page->fDocument != this || page->fHasTurn) {
+        return;
+    }
+    page->fTurn.wait();
+    page->fHasTurn = true;
+    this->startPage(page);
+}
+
+SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
+    SkASSERT(fCanvas.imageInfo().dimensions().isZero());
+    SkASSERT(!fCurrentPage);
+    fCurrentPage = std::make_unique<Page>();
+    fCurrentPage->fDocument = this;
+    fCurrentPage->fDevice = this->makePageDevice(width, height);
+    fCurrentPage->fHasTurn = true;
+    this->startPage(fCurrentPage.get());
+    reset_object(&fCanvas, fCurrentPage->fDevice);
     fCanvas.scale(fRasterScale, fRasterScale);
-    fPageRefs.push_back(this->reserveRef());
     return &fCanvas;
 }
 
@@ -336,13 +405,14 @@ static SkPDFIndirectReference append_destinations(
 
 std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
     std::unique_ptr<SkPDFArray> array;
-    size_t count = fCurrentPageLinks.size();
+    const std::vector<std::unique_ptr<SkPDFLink>>& links = this->currentPageLinks();
+    size_t count = links.size();
     if (0 == count) {
         return array;  // is nullptr
     }
     array = SkPDFMakeArray();
     array->reserve(count);
-    for (const auto& link : fCurrentPageLinks) {
+    for (const auto& link : links) {
         SkPDFDict annotation("Annot");
         populate_link_annotation(&annotation, link->fRect);
         if (link->fType == SkPDFLink::Type::kUrl) {
@@ -372,38 +442,72 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
     return array;
 }
 
-void SkPDFDocument::onEndPage() {
-    SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
-    reset_object(&fCanvas);
-    SkASSERT(fPageDevice);
-
-    auto page = SkPDFMakeDict("Page");
+void SkPDFDocument::finishPage(Page* page) {
+    SkASSERT(page->fHasTurn);
+    auto pageDict = SkPDFMakeDict("Page");
 
-    SkSize mediaSize = fPageDevice->imageInfo().dimensions() * fInverseRasterScale;
-    std::unique_ptr<SkStreamAsset> pageContent = fPageDevice->content();
-    auto resourceDict = fPageDevice->makeResourceDict();
-    SkASSERT(!fPageRefs.empty());
+    SkSize mediaSize = page->fDevice->imageInfo().dimensions() * fInverseRasterScale;
+    std::unique_ptr<SkStreamAsset> pageContent;
+    if (!page->fContent) {
+        pageContent = page->fDevice->content();
+    }
+    auto resourceDict = page->fDevice->makeResourceDict();
 
-    page->insertObject("Resources", std::move(resourceDict));
-    page->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
+    pageDict->insertObject("Resources", std::move(resourceDict));
+    pageDict->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
 
     if (std::unique_ptr<SkPDFArray> annotations = getAnnotations()) {
-        page->insertObject("Annots", std::move(annotations));
-        fCurrentPageLinks.clear();
-    }
-
-    page->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
-    if (SkPDFParentTreeKey structParentsKey = fPageDevice->structParentsKey()) {
-        page->insertInt("StructParents", structParentsKey.fValue);
+        pageDict->insertObject("Annots", std::move(annotations));
+        page->fLinks.clear();
+    }
+
+    pageDict->insertRef("Contents",
+                        page->fContent
+                                ? SkPDFStreamOut(std::move(page->fContentDict),
+                                                 std::move(page->fContent), this,
+                                                 SkPDFSteamCompressionEnabled::No,
+                                                 SkPDFStreamKind::kContent)
+                                : SkPDFStreamOut(nullptr, std::move(pageContent), this,
+                                                 SkPDFSteamCompressionEnabled::Yes,
+                                                 SkPDFStreamKind::kContent));
+    if (SkPDFParentTreeKey structParentsKey = page->fDevice->structParentsKey()) {
+        pageDict->insertInt("StructParents", structParentsKey.fValue);
         this->setContentStreamRefForStructParentsKey(structParentsKey,
                                                      SkPDFStructTree::kPageContentStreamRef);
     }
 
     // Tabs is PDF 1.5, but setting it checks an accessibility box.
-    page->insertName("Tabs", "S");
+    pageDict->insertName("Tabs", "S");
+
+    if (fMetadata.fLowMemory) {
+        if (page->fIndex % kMaxPageTreeNodeSize == 0) {
+            fPageParentRefs.push_back(this->reserveRef());
+        }
+        pageDict->insertRef("Parent", fPageParentRefs.back());
+        this->emit(*pageDict, page->fRef);
+    } else {
+        fPages.emplace_back(std::move(pageDict));
+    }
+    page->fDevice = nullptr;
+}
+
+void SkPDFDocument::onEndPage() {
+    SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
+    reset_object(&fCanvas);
+    SkASSERT(fCurrentPage);
+    this->finishPage(fCurrentPage.get());
+    fCurrentPage = nullptr;
+}
 
-    fPages.emplace_back(std::move(page));
-    fPageDevice = nullptr;
+size_t SkPDFDocument::retainedPageBytes() {
+    SkNullWStream pageBytes;
+    for (const std::unique_ptr<SkPDFDict>& page : fPages) {
+        page->emitObject(&pageBytes);
+    }
+    size_t bytes = pageBytes.bytesWritten();
+    bytes += (fPageRefs.size() + fPageParentRefs.size()) * sizeof(SkPDFIndirectReference);
+    SkAutoMutexExclusive lock(fMutex);
+    return bytes + SkToSizeT(fOffsetMap.objectCount()) * sizeof(int);
 }
 
 void SkPDFDocument::onAbort() {
@@ -556,7 +660,24 @@ const SkMatrix& SkPDFDocument::currentPageTransform() const {
     if (!this->hasCurrentPage()) {
         return gIdentity;
     }
-    return fPageDevice->initialTransform();
+    return this->drawingPage()->fDevice->initialTransform();
+}
+
+SkPDFIndirectReference SkPDFDocument::currentPage() {
+    SkASSERT(this->hasCurrentPage());
+    this->waitForPageTurn();
+    return this->drawingPage()->fRef;
+}
+
+std::vector<std::unique_ptr<SkPDFLink>>& SkPDFDocument::currentPageLinks() {
+    SkASSERT(this->hasCurrentPage());
+    return this->drawingPage()->fLinks;
+}
+
+size_t SkPDFDocument::currentPageIndex() {
+    SkASSERT(this->hasCurrentPage());
+    this->waitForPageTurn();
+    return this->drawingPage()->fIndex;
 }
 
 SkPDFStructTree::Mark SkPDFDocument::createMarkForElemId(int elemId,
@@ -574,10 +695,12 @@ SkPDFStructTree::Mark SkPDFDocument::createMarkForElemId(int elemId,
 void SkPDFDocument::setContentStreamRefForStructParentsKey(SkPDFParentTreeKey structParentsKey,
                                                            SkPDFIndirectReference contentStreamRef)
 {
+    this->waitForPageTurn();
     fStructTree.setContentStreamRefForStructParentsKey(structParentsKey, contentStreamRef);
 }
 
 void SkPDFDocument::addStructElemTitle(int elemId, SkSpan<const char> title) {
+    this->waitForPageTurn();
     fStructTree.addStructElemTitle(elemId, std::move(title));
 }
 
@@ -598,7 +721,7 @@ static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
     fonts.reserve(canon.fStrikes.count());
     canon.fStrikes.foreach([&fonts](const sk_sp<SkPDFStrike>& strike) {
         for (const auto& [unused, font] : strike->fFontMap) {
-            fonts.push_back(&font);
+            fonts.push_back(font.get());
         }
     });
     // Sort so the output PDF is reproducible.
@@ -627,7 +750,7 @@ SkString SkPDFDocument::nextFontSubsetTag() {
 
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+    if (fPageRefs.empty()) {
         this->waitForJobs();
         return;
     }
@@ -640,7 +763,10 @@ void SkPDFDocument::onClose(SkWStream* stream) {
         docCatalog->insertObject("OutputIntents", make_srgb_output_intents(this));
     }
 
-    docCatalog->insertRef("Pages", generate_page_tree(this, std::move(fPages), fPageRefs));
+    docCatalog->insertRef("Pages",
+                          fMetadata.fLowMemory
+                                  ? generate_streamed_page_tree(this, fPageRefs, fPageParentRefs)
+                                  : generate_page_tree(this, std::move(fPages), fPageRefs));
 
     if (!fNamedDestinations.empty()) {
         docCatalog->insertRef("Dests", append_destinations(this, fNamedDestinations));
@@ -688,10 +814,44 @@ void SkPDFDocument::onClose(SkWStream* stream) {
     }
 }
 
+SkPDF::Metadata::CompressionLevel SkPDFDocument::compressionLevel(SkPDFStreamKind kind) const {
+    using CompressionLevel = SkPDF::Metadata::CompressionLevel;
+    CompressionLevel level = CompressionLevel::Default;
+    switch (kind) {
+        case SkPDFStreamKind::kOther:   break;
+        case SkPDFStreamKind::kContent: level = fMetadata.fContentCompressionLevel; break;
+        case SkPDFStreamKind::kFont:    level = fMetadata.fFontCompressionLevel;    break;
+        case SkPDFStreamKind::kImage:   level = fMetadata.fImageCompressionLevel;   break;
+    }
+    return level == CompressionLevel::Default ? fMetadata.fCompressionLevel : level;
+}
+
 void SkPDFDocument::incrementJobCount() { fJobCount++; }
 
 void SkPDFDocument::signalJobComplete() { fSemaphore.signal(); }
 
+bool SkPDFDocument::tryQueueJobBytes(size_t bytes) {
+    const size_t limit = fMetadata.fMaxQueuedJobBytes;
+    if (limit == 0) {
+        return true;
+    }
+    size_t queued = fQueuedJobBytes.load(std::memory_order_relaxed);
+    do {
+        if (queued != 0 && (bytes > limit || queued > limit - bytes)) {
+            return false;
+        }
+    } while (!fQueuedJobBytes.compare_exchange_weak(queued, queued + bytes,
+                                                    std::memory_order_relaxed));
+    return true;
+}
+
+void SkPDFDocument::releaseJobBytes(size_t bytes) {
+    if (fMetadata.fMaxQueuedJobBytes != 0) {
+        SkASSERT(fQueuedJobBytes.load(std::memory_order_relaxed) >= bytes);
+        fQueuedJobBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+}
+
 void SkPDFDocument::waitForJobs() {
      // fJobCount can increase while we wait.
      while (fJobCount > 0) {
@@ -700,6 +860,79 @@ void SkPDFDocument::waitForJobs() {
      }
 }
 
+void SkPDFDocument::drawPage(Page* page, const SkPicture* picture) {
+    sDrawingPage = page;
+    {
+        const SkRect cull = picture->cullRect();
+        SkCanvas canvas(page->fDevice);
+        canvas.scale(fRasterScale, fRasterScale);
+        canvas.translate(-cull.left(), -cull.top());
+        canvas.drawPicture(picture);
+    }
+    // Compress the content while earlier pages are still being written.
+    page->fContentDict = SkPDFMakeDict();
+    page->fContent = SkPDFCompressStream(page->fContentDict.get(), page->fDevice->content(),
+                                         this, SkPDFStreamKind::kContent);
+    this->waitForPageTurn();
+    this->finishPage(page);
+    sDrawingPage = nullptr;
+}
+
+void SkPDFDocument::drawPictures(SkSpan<const sk_sp<SkPicture>> pictures, SkExecutor* executor) {
+    if (this->getState() == kClosed_State) {
+        return;
+    }
+    this->endPage();
+    if (!executor) {
+        for (const sk_sp<SkPicture>& picture : pictures) {
+            const SkRect cull = picture->cullRect();
+            if (SkCanvas* canvas = this->beginPage(cull.width(), cull.height())) {
+                canvas->translate(-cull.left(), -cull.top());
+                canvas->drawPicture(picture.get());
+                this->endPage();
+            }
+        }
+        return;
+    }
+
+    // Bounds how many pages are drawn at once, and so how many are held in memory.
+    static constexpr int kMaxConcurrentPages = 8;
+
+    // Each page takes its turn (see waitForPageTurn()) from the one before it. Pages are drawn
+    // by whichever thread takes the next one, so the page whose turn it is is always being
+    // drawn, even if the executor runs tasks on the thread that adds them.
+    std::unique_ptr<Page[]> pages(new Page[pictures.size()]);
+    std::atomic<size_t> nextPage = {0};
+    auto drawPages = [&] {
+        size_t i;
+        while ((i = nextPage++) < pictures.size()) {
+            Page* page = &pages[i];
+            const SkRect cull = pictures[i]->cullRect();
+            if (cull.width() > 0 && cull.height() > 0) {
+                page->fDocument = this;
+                page->fDevice = this->makePageDevice(cull.width(), cull.height());
+                this->drawPage(page, pictures[i].get());
+            } else {
+                // Like beginPage(), skip empty pages.
+                page->fTurn.wait();
+            }
+            if (i + 1 < pictures.size()) {
+                pages[i + 1].fTurn.signal();
+            }
+        }
+    };
+    if (!pictures.empty()) {
+        pages[0].fTurn.signal();
+    }
+    SkTaskGroup group(*executor);
+    // This thread draws pages too.
+    for (int i = 1; i < kMaxConcurrentPages; i++) {
+        group.add(drawPages);
+    }
+    drawPages();
+    group.wait();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkPDF::SetNodeId(SkCanvas* canvas, int elemId) {
@@ -708,6 +941,18 @@ void SkPDF::SetNodeId(SkCanvas* canvas, int elemId) {
     canvas->drawAnnotation({0, 0, 0, 0}, key, payload.get());
 }
 
+void SkPDF::DrawPictures(SkDocument* document,
+                         SkSpan<const sk_sp<SkPicture>> pictures,
+                         SkExecutor* executor) {
+    SkASSERT(document);
+    static_cast<SkPDFDocument*>(document)->drawPictures(pictures, executor);
+}
+
+SkPDF::Stats SkPDF::GetStats(SkDocument* document) {
+    SkASSERT(document);
+    return static_cast<SkPDFDocument*>(document)->stats();
+}
+
 sk_sp<SkDocument> SkPDF::MakeDocument(SkWStream* stream, const SkPDF::Metadata& metadata) {
     SkPDF::Metadata meta = metadata;
     if (meta.fRasterDPI <= 0) {
@@ -22,6 +22,7 @@
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkSemaphore.h"
+#include "src/core/SkSharedMutex.h"
 #include "src/core/SkTHash.h"
 #include "src/core/SkUTF.h"
 #include "src/pdf/SkPDFBitmap.h"
@@ -41,6 +42,7 @@
 class SkDescriptor;
 class SkExecutor;
 class SkPDFDevice;
+class SkPicture;
 struct SkAdvancedTypefaceMetrics;
 struct SkBitmapKey;
 class SkMatrix;
@@ -128,12 +130,25 @@ public:
     }
 
     const SkPDF::Metadata& metadata() const { return fMetadata; }
+    SkPDF::Metadata::CompressionLevel compressionLevel(SkPDFStreamKind) const;
 
     SkPDFIndirectReference getPage(size_t pageIndex) const;
-    bool hasCurrentPage() const { return bool(fPageDevice); }
-    SkPDFIndirectReference currentPage() const {
-        return SkASSERT(this->hasCurrentPage() && !fPageRefs.empty()), fPageRefs.back();
-    }
+    bool hasCurrentPage() const { return this->drawingPage() != nullptr; }
+    // Waits for the current page's turn (see waitForPageTurn()), which is when it is numbered.
+    SkPDFIndirectReference currentPage();
+    // Links drawn on the current page, which become its annotations when it ends.
+    std::vector<std::unique_ptr<SkPDFLink>>& currentPageLinks();
+
+    // Draws each picture as a page, as SkPDF::DrawPictures() documents.
+    void drawPictures(SkSpan<const sk_sp<SkPicture>>, SkExecutor*);
+
+    // drawPictures() may draw several pages at once, on different threads. Each of those pages
+    // waits for its turn, which comes once every earlier page has ended, before it numbers an
+    // object or adds to the document, so the output is the same as drawing one page at a time.
+    // Until then it may only look up resources that earlier pages made, holding
+    // fResourceMutex shared. Does nothing if this thread is not drawing one of those pages, or
+    // if its page already has its turn.
+    void waitForPageTurn();
 
     // Create a new marked-content identifier (MCID) to be used with a marked-content sequence
     // parented by the structure element (StructElem) with the given element identifier (elemId).
@@ -157,7 +172,10 @@ public:
     std::unique_ptr<SkPDFArray> getAnnotations();
 
     // Every reference returned by this method must be passed to `emit` exactly once.
-    SkPDFIndirectReference reserveRef() { return SkPDFIndirectReference{fNextObjectNumber++}; }
+    SkPDFIndirectReference reserveRef() {
+        this->waitForPageTurn();
+        return SkPDFIndirectReference{fNextObjectNumber++};
+    }
 
     // Returns a tag to prepend to a PostScript name of a subset font. Includes the '+'.
     SkString nextFontSubsetTag();
@@ -165,11 +183,28 @@ public:
     SkExecutor* executor() const { return fExecutor; }
     void incrementJobCount();
     void signalJobComplete();
-    size_t currentPageIndex() { return fPages.size(); }
+    // Returns true if a job holding this many bytes may be queued on executor(), in which case
+    // releaseJobBytes() must be called with the same count once the job is done. Otherwise the
+    // caller should do the work itself to stay within Metadata::fMaxQueuedJobBytes.
+    bool tryQueueJobBytes(size_t bytes);
+    void releaseJobBytes(size_t bytes);
+    size_t currentPageIndex();
     size_t pageCount() { return fPageRefs.size(); }
+    // Roughly the bytes held for pages that have already ended: the page objects still
+    // waiting for close(), plus the page references and object offsets kept for the page
+    // tree and cross-reference table.
+    size_t retainedPageBytes();
 
     const SkMatrix& currentPageTransform() const;
 
+    SkPDF::Stats& stats() { return fStats; }
+
+    // Guards the maps that pages drawn by drawPictures() look resources up in before their turn:
+    // fFillGSMap, fStrokeGSMap, fStrikes, fTypefaceMetrics, and the fonts of each strike and
+    // the glyphs they use. Those pages hold it shared to look up, and it is held exclusive to
+    // add to them, always by the page whose turn it is.
+    SkSharedMutex fResourceMutex;
+
     // Canonicalized objects
     skia_private::THashMap<SkPDFImageShaderKey,
                            SkPDFIndirectReference,
@@ -178,6 +213,10 @@ public:
                            SkPDFIndirectReference,
                            SkPDFGradientShader::KeyHash> fGradientPatternMap;
     skia_private::THashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap;
+    // Only populated with Metadata::fDeduplicateImageContent.
+    skia_private::THashMap<SkPDFImageContentKey,
+                           SkPDFIndirectReference,
+                           SkPDFImageContentKey::Hash> fPDFImageContentMap;
     skia_private::THashMap<SkPDFIccProfileKey,
                            SkPDFIndirectReference,
                            SkPDFIccProfileKey::Hash> fICCProfileMap;
@@ -196,19 +235,47 @@ public:
                            SkPDFFillGraphicState::Hash> fFillGSMap;
     SkPDFIndirectReference fInvertFunction;
     SkPDFIndirectReference fNoSmaskGraphicState;
-    std::vector<std::unique_ptr<SkPDFLink>> fCurrentPageLinks;
     std::vector<SkPDFNamedDestination> fNamedDestinations;
 
 private:
+    // A page that has begun and not yet ended. beginPage() opens one at a time, while
+    // drawPictures() may draw several at once.
+    struct Page {
+        SkPDFDocument* fDocument = nullptr;
+        sk_sp<SkPDFDevice> fDevice;
+        std::vector<std::unique_ptr<SkPDFLink>> fLinks;
+        // Set when the page is numbered, once it has its turn.
+        SkPDFIndirectReference fRef;
+        size_t fIndex = 0;
+        bool fHasTurn = false;
+        SkSemaphore fTurn;
+        // The page content, compressed by drawPictures() ahead of the page's turn.
+        std::unique_ptr<SkPDFDict> fContentDict;
+        std::unique_ptr<SkStreamAsset> fContent;
+    };
+    // The page drawPictures() is drawing on this thread, if any.
+    static thread_local Page* sDrawingPage;
+
+    Page* drawingPage() const;
+    sk_sp<SkPDFDevice> makePageDevice(SkScalar width, SkScalar height);
+    void startPage(Page*);
+    void drawPage(Page*, const SkPicture*);
+    void finishPage(Page*);
+
     SkPDFOffsetMap fOffsetMap;
     SkCanvas fCanvas;
     std::vector<std::unique_ptr<SkPDFDict>> fPages;
     std::vector<SkPDFIndirectReference> fPageRefs;
+    // In low memory mode pages are emitted as they end, so the parents of each run of pages
+    // are reserved up front.
+    std::vector<SkPDFIndirectReference> fPageParentRefs;
 
-    sk_sp<SkPDFDevice> fPageDevice;
+    std::unique_ptr<Page> fCurrentPage;
     std::atomic<int> fNextObjectNumber = {1};
     std::atomic<int> fJobCount = {0};
+    std::atomic<size_t> fQueuedJobBytes = {0};
     uint32_t fNextFontSubsetTag = {0};
+    SkPDF::Stats fStats;
     SkUUID fUUID;
     SkPDFIndirectReference fInfoDict;
     SkPDFIndirectReference fXMP;
@@ -48,6 +48,7 @@
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkPathEffectBase.h"
+#include "src/core/SkSharedMutex.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkStrikeSpec.h"
 #include "src/core/SkTHash.h"
@@ -148,19 +149,8 @@ SkPDFStrikeSpec::SkPDFStrikeSpec(SkStrikeSpec strikeSpec, SkScalar em)
     , fUnitsPerEM(em)
 {}
 
-sk_sp<SkPDFStrike> SkPDFStrike::Make(SkPDFDocument* doc, const SkFont& font, const SkPaint& paint) {
-#ifdef SK_PDF_BITMAP_GLYPH_RASTER_SIZE
-    static constexpr float kBitmapFontSize = SK_PDF_BITMAP_GLYPH_RASTER_SIZE;
-#else
-    static constexpr float kBitmapFontSize = 64;
-#endif
-
-    SkScalar unitsPerEm = static_cast<SkScalar>(font.getTypeface()->getUnitsPerEm());
-    int glyphCount = font.getTypeface()->countGlyphs();
-    if (unitsPerEm <= 0 || glyphCount <= 0) {
-        return nullptr;
-    }
-
+// Clears the font settings that SkPDFDevice applies itself or that do not affect glyph outlines.
+static SkFont canonicalize_font(const SkFont& font) {
     SkFont canonFont(font);
     canonFont.setBaselineSnap(false);  // canonicalize
     canonFont.setEdging(SkFont::Edging::kAntiAlias); // canonicalize
@@ -174,30 +164,68 @@ sk_sp<SkPDFStrike> SkPDFStrike::Make(SkPDFDocument* doc, const SkFont& font, con
     canonFont.setSkewX(0.0f); // original value applied by SkPDFDevice
     canonFont.setSubpixel(false); // canonicalize
     //canonFont.setTypeface();
+    return canonFont;
+}
 
-    SkPaint pathPaint(paint);
-    if (scale_paint(pathPaint, unitsPerEm / font.getSize())) {
+// The strike that glyph outlines are taken from, preferably at unitsPerEm. On entry pathPaint is
+// the paint the glyphs are drawn with; it is scaled to match the strike.
+// Returns nullopt if the font's glyphs cannot be drawn as PDF text.
+static std::optional<SkPDFStrikeSpec> make_path_strike_spec(const SkFont& font,
+                                                            SkPaint* pathPaint) {
+    SkScalar unitsPerEm = static_cast<SkScalar>(font.getTypeface()->getUnitsPerEm());
+    int glyphCount = font.getTypeface()->countGlyphs();
+    if (unitsPerEm <= 0 || glyphCount <= 0) {
+        return std::nullopt;
+    }
+
+    SkFont canonFont = canonicalize_font(font);
+    if (scale_paint(*pathPaint, unitsPerEm / font.getSize())) {
         canonFont.setSize(unitsPerEm);
     } else {
         canonFont.setSize(font.getSize());
     }
-    SkScalar pathStrikeEM = canonFont.getSize();
-    SkStrikeSpec pathStrikeSpec = SkStrikeSpec::MakeWithNoDevice(canonFont, &pathPaint,
-                                                                 SkScalerContextFlags::kNone);
+    return SkPDFStrikeSpec(SkStrikeSpec::MakeWithNoDevice(canonFont, pathPaint,
+                                                          SkScalerContextFlags::kNone),
+                           canonFont.getSize());
+}
 
-    if (sk_sp<SkPDFStrike>* strike = doc->fStrikes.find(pathStrikeSpec.descriptor())) {
-        return *strike;
+sk_sp<SkPDFStrike> SkPDFStrike::Make(SkPDFDocument* doc, const SkFont& font, const SkPaint& paint) {
+#ifdef SK_PDF_BITMAP_GLYPH_RASTER_SIZE
+    static constexpr float kBitmapFontSize = SK_PDF_BITMAP_GLYPH_RASTER_SIZE;
+#else
+    static constexpr float kBitmapFontSize = 64;
+#endif
+
+    SkPaint pathPaint(paint);
+    std::optional<SkPDFStrikeSpec> pathStrikeSpec = make_path_strike_spec(font, &pathPaint);
+    if (!pathStrikeSpec) {
+        return nullptr;
+    }
+
+    const SkDescriptor& descriptor = pathStrikeSpec->fStrikeSpec.descriptor();
+    auto find = [doc, &descriptor]() -> sk_sp<SkPDFStrike> {
+        SkAutoSharedMutexShared lock(doc->fResourceMutex);
+        sk_sp<SkPDFStrike>* strike = doc->fStrikes.find(descriptor);
+        return strike ? *strike : nullptr;
+    };
+    if (sk_sp<SkPDFStrike> strike = find()) {
+        return strike;
+    }
+    doc->waitForPageTurn();
+    if (sk_sp<SkPDFStrike> strike = find()) {
+        return strike;
     }
 
     if (kBitmapFontSize <= 0) {
         // old code path compatibility
-        sk_sp<SkPDFStrike> strike(new SkPDFStrike(SkPDFStrikeSpec(pathStrikeSpec, pathStrikeEM),
-                                                  SkPDFStrikeSpec(pathStrikeSpec, pathStrikeEM),
+        sk_sp<SkPDFStrike> strike(new SkPDFStrike(*pathStrikeSpec, *pathStrikeSpec,
                                                   pathPaint.getMaskFilter(), doc));
+        SkAutoSharedMutexExclusive lock(doc->fResourceMutex);
         doc->fStrikes.set(strike);
         return strike;
     }
 
+    SkFont canonFont = canonicalize_font(font);
     SkPaint imagePaint(paint);
     if (scale_paint(imagePaint, kBitmapFontSize / font.getSize())) {
         canonFont.setSize(kBitmapFontSize);
@@ -208,9 +236,10 @@ sk_sp<SkPDFStrike> SkPDFStrike::Make(SkPDFDocument* doc, const SkFont& font, con
     SkStrikeSpec imageStrikeSpec = SkStrikeSpec::MakeWithNoDevice(canonFont, &imagePaint,
                                                                   SkScalerContextFlags::kNone);
 
-    sk_sp<SkPDFStrike> strike(new SkPDFStrike(SkPDFStrikeSpec(pathStrikeSpec, pathStrikeEM),
+    sk_sp<SkPDFStrike> strike(new SkPDFStrike(*pathStrikeSpec,
                                               SkPDFStrikeSpec(imageStrikeSpec, imageStrikeEM),
                                               pathPaint.getMaskFilter(), doc));
+    SkAutoSharedMutexExclusive lock(doc->fResourceMutex);
     doc->fStrikes.set(strike);
     return strike;
 
@@ -257,13 +286,25 @@ static bool can_subset(const SkAdvancedTypefaceMetrics& metrics) {
 const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface& typeface,
                                                        SkPDFDocument* canon) {
     SkTypefaceID id = typeface.uniqueID();
-    if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
-        return ptr->get();  // canon retains ownership.
+    auto find = [canon, id](const SkAdvancedTypefaceMetrics** metrics) {
+        SkAutoSharedMutexShared lock(canon->fResourceMutex);
+        std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id);
+        *metrics = ptr ? ptr->get() : nullptr;  // canon retains ownership.
+        return ptr != nullptr;
+    };
+    const SkAdvancedTypefaceMetrics* found;
+    if (find(&found)) {
+        return found;
+    }
+    canon->waitForPageTurn();
+    if (find(&found)) {
+        return found;
     }
 
     int count = typeface.countGlyphs();
     if (count <= 0 || count > 1 + SkTo<int>(UINT16_MAX)) {
         // Cache nullptr to skip this check.  Use SkSafeUnref().
+        SkAutoSharedMutexExclusive lock(canon->fResourceMutex);
         canon->fTypefaceMetrics.set(id, nullptr);
         return nullptr;
     }
@@ -303,6 +344,7 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface& typefac
     }
     // Fonts are always subset, so always prepend the subset tag.
     metrics->fPostScriptName.prepend(canon->nextFontSubsetTag());
+    SkAutoSharedMutexExclusive lock(canon->fResourceMutex);
     return canon->fTypefaceMetrics.set(id, std::move(metrics))->get();
 }
 
@@ -379,7 +421,17 @@ SkPDFFont* SkPDFStrike::getFontResource(const SkGlyph* glyph) {
     bool multibyte = SkPDFFont::IsMultiByte(type);
     SkGlyphID subsetCode =
             multibyte ? 0 : first_nonzero_glyph_for_single_byte_encoding(glyph->getGlyphID());
-    if (SkPDFFont* font = fFontMap.find(subsetCode)) {
+    auto find = [this, subsetCode]() -> SkPDFFont* {
+        SkAutoSharedMutexShared lock(fDoc->fResourceMutex);
+        std::unique_ptr<SkPDFFont>* font = fFontMap.find(subsetCode);
+        return font ? font->get() : nullptr;
+    };
+    if (SkPDFFont* font = find()) {
+        SkASSERT(multibyte == font->multiByteGlyphs());
+        return font;
+    }
+    fDoc->waitForPageTurn();
+    if (SkPDFFont* font = find()) {
         SkASSERT(multibyte == font->multiByteGlyphs());
         return font;
     }
@@ -395,7 +447,10 @@ SkPDFFont* SkPDFStrike::getFontResource(const SkGlyph* glyph) {
         lastGlyph = SkToU16(std::min<int>((int)lastGlyph, 254 + (int)subsetCode));
     }
     auto ref = fDoc->reserveRef();
-    return fFontMap.set(subsetCode, SkPDFFont(this, firstNonZeroGlyph, lastGlyph, type, ref));
+    // Not std::make_unique since the constructor is private.
+    std::unique_ptr<SkPDFFont> font(new SkPDFFont(this, firstNonZeroGlyph, lastGlyph, type, ref));
+    SkAutoSharedMutexExclusive lock(fDoc->fResourceMutex);
+    return fFontMap.set(subsetCode, std::move(font))->get();
 }
 
 SkPDFFont::SkPDFFont(const SkPDFStrike* strike,
@@ -412,6 +467,13 @@ SkPDFFont::SkPDFFont(const SkPDFStrike* strike,
     this->noteGlyphUsage(0);
 }
 
+void SkPDFFont::noteGlyphUsage(SkSpan<const SkGlyphID> glyphs) {
+    SkAutoSharedMutexExclusive lock(fStrike->fDoc->fResourceMutex);
+    for (SkGlyphID glyph : glyphs) {
+        this->noteGlyphUsage(glyph);
+    }
+}
+
 void SkPDFFont::PopulateCommonFontDescriptor(SkPDFDict* descriptor,
                                              const SkAdvancedTypefaceMetrics& metrics,
                                              uint16_t emSize,
@@ -468,7 +530,8 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
         sk_sp<SkData> subsetFontData;
         if (can_subset(metrics)) {
             SkASSERT(font.firstGlyphID() == 1);
-            subsetFontData = SkPDFSubsetFont(typeface, font.glyphUsage());
+            subsetFontData = SkPDFSubsetFont(typeface, font.glyphUsage(),
+                                             doc->metadata().fCacheFontSubsets);
         }
         std::unique_ptr<SkStreamAsset> subsetFontAsset;
         if (subsetFontData) {
@@ -481,13 +544,15 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
         streamDict->insertInt("Length1", subsetFontAsset->getLength());
         descriptor->insertRef("FontFile2",
                               SkPDFStreamOut(std::move(streamDict), std::move(subsetFontAsset),
-                                             doc, SkPDFSteamCompressionEnabled::Yes));
+                                             doc, SkPDFSteamCompressionEnabled::Yes,
+                                             SkPDFStreamKind::kFont));
     } else if (type == SkAdvancedTypefaceMetrics::kType1CID_Font) {
         std::unique_ptr<SkPDFDict> streamDict = SkPDFMakeDict();
         streamDict->insertName("Subtype", "CIDFontType0C");
         descriptor->insertRef("FontFile3",
                               SkPDFStreamOut(std::move(streamDict), std::move(fontAsset),
-                                             doc, SkPDFSteamCompressionEnabled::Yes));
+                                             doc, SkPDFSteamCompressionEnabled::Yes,
+                                             SkPDFStreamKind::kFont));
     } else {
         SkASSERT(false);
     }
@@ -545,7 +610,9 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                                    font.multiByteGlyphs(),
                                    font.firstGlyphID(),
                                    font.lastGlyphID());
-    fontDict.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicode), doc));
+    fontDict.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicode), doc,
+                                                   SkPDFSteamCompressionEnabled::Yes,
+                                                   SkPDFStreamKind::kFont));
 
     doc->emit(fontDict, font.indirectReference());
 }
@@ -884,7 +951,9 @@ static void emit_subset_type3(const SkPDFFont& pdfFont, SkPDFDocument* doc) {
             setGlyphWidthAndBoundingBox(pathGlyph->advanceX(), glyphBBox, &content);
         }
         charProcs->insertRef(std::move(characterName),
-                             SkPDFStreamOut(nullptr, content.detachAsStream(), doc));
+                             SkPDFStreamOut(nullptr, content.detachAsStream(), doc,
+                                            SkPDFSteamCompressionEnabled::Yes,
+                                            SkPDFStreamKind::kContent));
     }
 
     if (xobjects->size() || graphicStates->size()) {
@@ -922,7 +991,9 @@ static void emit_subset_type3(const SkPDFFont& pdfFont, SkPDFDocument* doc) {
                                                 false,
                                                 firstGlyphID,
                                                 lastGlyphID);
-    font.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicodeCmap), doc));
+    font.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicodeCmap), doc,
+                                               SkPDFSteamCompressionEnabled::Yes,
+                                               SkPDFStreamKind::kFont));
     font.insertRef("FontDescriptor", type3_descriptor(doc, pathTypeface, xHeight));
     font.insertObject("Widths", std::move(widthArray));
     font.insertObject("Encoding", std::move(encoding));
@@ -9,6 +9,7 @@
 
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
 #include "src/core/SkStrikeSpec.h"
@@ -18,6 +19,7 @@
 #include "src/pdf/SkPDFTypes.h"
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 class SkDescriptor;
@@ -48,7 +50,8 @@ public:
     const SkPDFStrikeSpec fImage;
     const bool fHasMaskFilter;
     SkPDFDocument* fDoc;
-    skia_private::THashMap<SkGlyphID, SkPDFFont> fFontMap;
+    // Heap allocated so fonts stay put while pages drawn in parallel add to the map.
+    skia_private::THashMap<SkGlyphID, std::unique_ptr<SkPDFFont>> fFontMap;
 
     /** Get the font resource for the glyph.
      *  The returned SkPDFFont is owned by the SkPDFStrike.
@@ -113,6 +116,9 @@ public:
         fGlyphUsage.set(glyph);
     }
 
+    /** Notes the glyphs as used, safely while other pages draw with this font. */
+    void noteGlyphUsage(SkSpan<const SkGlyphID> glyphs);
+
     SkPDFIndirectReference indirectReference() const { return fIndirectReference; }
 
     /** Gets SkAdvancedTypefaceMetrics, and caches the result.
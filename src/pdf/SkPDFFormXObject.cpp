@@ -46,7 +46,9 @@ SkPDFIndirectReference SkPDFMakeFormXObject(SkPDFDocument* doc,
     }
     group->insertBool("I", true);  // Isolated.
     dict->insertObject("Group", std::move(group));
-    SkPDFIndirectReference xobject = SkPDFStreamOut(std::move(dict), std::move(content), doc);
+    SkPDFIndirectReference xobject = SkPDFStreamOut(std::move(dict), std::move(content), doc,
+                                                    SkPDFSteamCompressionEnabled::Yes,
+                                                    SkPDFStreamKind::kContent);
     if (structParentsKey) {
         doc->setContentStreamRefForStructParentsKey(structParentsKey, xobject);
     }
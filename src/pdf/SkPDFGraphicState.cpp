@@ -14,6 +14,7 @@
 #include "include/core/SkStream.h"
 #include "include/private/SkAssert.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkSharedMutex.h"
 #include "src/core/SkTHash.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFUtils.h"
@@ -59,6 +60,31 @@ static uint8_t pdf_blend_mode(SkBlendMode mode) {
     return SkToU8((unsigned)mode);
 }
 
+// Pages drawn in parallel look states up concurrently, but only the page whose turn it is adds.
+template <typename Key, typename Hash, typename MakeStateFn>
+static SkPDFIndirectReference find_or_emit(
+        SkPDFDocument* doc,
+        skia_private::THashMap<Key, SkPDFIndirectReference, Hash>* map,
+        const Key& key,
+        MakeStateFn&& makeState) {
+    auto find = [doc, map, &key]() {
+        SkAutoSharedMutexShared lock(doc->fResourceMutex);
+        SkPDFIndirectReference* statePtr = map->find(key);
+        return statePtr ? *statePtr : SkPDFIndirectReference();
+    };
+    if (SkPDFIndirectReference ref = find()) {
+        return ref;
+    }
+    doc->waitForPageTurn();
+    if (SkPDFIndirectReference ref = find()) {
+        return ref;
+    }
+    SkPDFIndirectReference ref = doc->emit(*makeState());
+    SkAutoSharedMutexExclusive lock(doc->fResourceMutex);
+    map->set(key, ref);
+    return ref;
+}
+
 SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument* doc,
                                                                   const SkPaint& p) {
     SkASSERT(doc);
@@ -66,17 +92,13 @@ SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument*
 
     if (SkPaint::kFill_Style == p.getStyle()) {
         SkPDFFillGraphicState fillKey = {p.getColor4f().fA, pdf_blend_mode(mode)};
-        auto& fillMap = doc->fFillGSMap;
-        if (SkPDFIndirectReference* statePtr = fillMap.find(fillKey)) {
-            return *statePtr;
-        }
-        SkPDFDict state;
-        state.reserve(2);
-        state.insertColorComponentF("ca", fillKey.fAlpha);
-        state.insertName("BM", as_pdf_blend_mode_name((SkBlendMode)fillKey.fBlendMode));
-        SkPDFIndirectReference ref = doc->emit(state);
-        fillMap.set(fillKey, ref);
-        return ref;
+        return find_or_emit(doc, &doc->fFillGSMap, fillKey, [&fillKey] {
+            std::unique_ptr<SkPDFDict> state = SkPDFMakeDict();
+            state->reserve(2);
+            state->insertColorComponentF("ca", fillKey.fAlpha);
+            state->insertName("BM", as_pdf_blend_mode_name((SkBlendMode)fillKey.fBlendMode));
+            return state;
+        });
     } else {
         SkPDFStrokeGraphicState strokeKey = {
             p.getStrokeWidth(),
@@ -86,23 +108,19 @@ SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument*
             SkToU8(p.getStrokeJoin()),
             pdf_blend_mode(mode)
         };
-        auto& sMap = doc->fStrokeGSMap;
-        if (SkPDFIndirectReference* statePtr = sMap.find(strokeKey)) {
-            return *statePtr;
-        }
-        SkPDFDict state;
-        state.reserve(8);
-        state.insertColorComponentF("CA", strokeKey.fAlpha);
-        state.insertColorComponentF("ca", strokeKey.fAlpha);
-        state.insertInt("LC", to_stroke_cap(strokeKey.fStrokeCap));
-        state.insertInt("LJ", to_stroke_join(strokeKey.fStrokeJoin));
-        state.insertScalar("LW", strokeKey.fStrokeWidth);
-        state.insertScalar("ML", strokeKey.fStrokeMiter);
-        state.insertBool("SA", true);  // SA = Auto stroke adjustment.
-        state.insertName("BM", as_pdf_blend_mode_name((SkBlendMode)strokeKey.fBlendMode));
-        SkPDFIndirectReference ref = doc->emit(state);
-        sMap.set(strokeKey, ref);
-        return ref;
+        return find_or_emit(doc, &doc->fStrokeGSMap, strokeKey, [&strokeKey] {
+            std::unique_ptr<SkPDFDict> state = SkPDFMakeDict();
+            state->reserve(8);
+            state->insertColorComponentF("CA", strokeKey.fAlpha);
+            state->insertColorComponentF("ca", strokeKey.fAlpha);
+            state->insertInt("LC", to_stroke_cap(strokeKey.fStrokeCap));
+            state->insertInt("LJ", to_stroke_join(strokeKey.fStrokeJoin));
+            state->insertScalar("LW", strokeKey.fStrokeWidth);
+            state->insertScalar("ML", strokeKey.fStrokeMiter);
+            state->insertBool("SA", true);  // SA = Auto stroke adjustment.
+            state->insertName("BM", as_pdf_blend_mode_name((SkBlendMode)strokeKey.fBlendMode));
+            return state;
+        });
     }
 }
 
@@ -126,6 +144,7 @@ SkPDFIndirectReference SkPDFGraphicState::GetSMaskGraphicState(SkPDFIndirectRefe
                                                                bool invert,
                                                                SkPDFSMaskMode sMaskMode,
                                                                SkPDFDocument* doc) {
+    doc->waitForPageTurn();
     // The practical chances of using the same mask more than once are unlikely
     // enough that it's not worth canonicalizing.
     auto sMaskDict = SkPDFMakeDict("Mask");
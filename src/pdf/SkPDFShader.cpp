@@ -264,7 +264,8 @@ static SkPDFIndirectReference make_image_shader(SkPDFDocument* doc,
     SkPDFUtils::PopulateTilingPatternDict(dict.get(),
                                           patternBBox, is_tiled(tileModesX), is_tiled(tileModesY),
                                           std::move(resourceDict), finalMatrix);
-    return SkPDFStreamOut(std::move(dict), std::move(imageShader), doc);
+    return SkPDFStreamOut(std::move(dict), std::move(imageShader), doc,
+                          SkPDFSteamCompressionEnabled::Yes, SkPDFStreamKind::kContent);
 }
 
 // Generic fallback for unsupported shaders:
@@ -339,6 +340,8 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
                                        SkColor4f paintColor) {
     SkASSERT(shader);
     SkASSERT(doc);
+    // Shaders are looked up and emitted in page order.
+    doc->waitForPageTurn();
     if (as_SB(shader)->asGradient() != SkShaderBase::GradientType::kNone) {
         if (SkPDFIndirectReference gradientShader =
                     SkPDFGradientShader::Make(doc, shader, canvasTransform, surfaceBBox)) {
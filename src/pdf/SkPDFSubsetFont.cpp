@@ -7,18 +7,25 @@
 
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
+#include "include/core/SkTypes.h"
 #include "include/private/SkAssert.h"
 #include "include/private/SkMalloc.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTemplates.h"
+#include "include/private/SkThreadAnnotations.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkLRUCache.h"
 #include "src/pdf/SkPDFGlyphUse.h"
 
 #include "hb.h"  // NO_G3_REWRITE
 #include "hb-subset.h"  // NO_G3_REWRITE
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -130,7 +137,7 @@ HBFace make_subset(hb_subset_input_t* input, hb_face_t* face, bool retainZeroGly
     return HBFace(hb_subset_or_fail(face, input));
 }
 
-sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& glyphUsage) {
+HBFace make_face(const SkTypeface& typeface) {
     HBFace face;
     if (!SkPDFCanSubsetTableBasedFonts()) {
         int index = 0;
@@ -164,7 +171,14 @@ sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& g
             }
         }
     }
+    if (face) {
+        // Faces are shared between threads once cached.
+        hb_face_make_immutable(face.get());
+    }
+    return face;
+}
 
+sk_sp<SkData> subset_face(hb_face_t* face, const SkPDFGlyphUse& glyphUsage) {
     HBSubsetInput input(hb_subset_input_create_or_fail());
     SkASSERT(input);
     if (!face || !input) {
@@ -173,7 +187,7 @@ sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& g
     hb_set_t* glyphs = hb_subset_input_glyph_set(input.get());
     glyphUsage.getSetValues([&glyphs](unsigned gid) { hb_set_add(glyphs, gid);});
 
-    HBFace subset = make_subset(input.get(), face.get(), glyphUsage.has(0));
+    HBFace subset = make_subset(input.get(), face, glyphUsage.has(0));
     if (!subset) {
         return nullptr;
     }
@@ -182,10 +196,119 @@ sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& g
     return to_data(std::move(result));
 }
 
+// A subset is identified by its typeface and the exact glyphs it keeps.
+struct SubsetKey {
+    SubsetKey(SkTypefaceID typefaceID, const SkPDFGlyphUse& glyphUsage)
+            : fTypefaceID(typefaceID) {
+        glyphUsage.getSetValues([this](unsigned gid) { fGlyphs.push_back(SkToU16(gid)); });
+        fHash = SkChecksum::Hash32(fGlyphs.data(), fGlyphs.size() * sizeof(SkGlyphID),
+                                   fTypefaceID);
+    }
+
+    bool operator==(const SubsetKey& that) const {
+        return fHash == that.fHash && fTypefaceID == that.fTypefaceID && fGlyphs == that.fGlyphs;
+    }
+
+    struct Hash {
+        uint32_t operator()(const SubsetKey& key) const { return key.fHash; }
+    };
+
+    SkTypefaceID fTypefaceID;
+    std::vector<SkGlyphID> fGlyphs;
+    uint32_t fHash;
+};
+
+// Keeps SubsetCache::fSubsetBytes in step with the subsets the LRU cache holds.
+struct SubsetPurge {
+    void operator()(void* context, const SubsetKey&, const sk_sp<SkData>* data) const {
+        size_t* bytes = static_cast<size_t*>(context);
+        SkASSERT(*bytes >= (*data)->size());
+        *bytes -= (*data)->size();
+    }
+};
+
+// Process-wide cache of HarfBuzz faces and finished subsets, shared by every document with
+// Metadata::fCacheFontSubsets set. Subsetting itself runs outside the lock, so two threads
+// that miss on the same key at once may both do the work.
+class SubsetCache {
+public:
+    static SubsetCache& Get() {
+        static SubsetCache* cache = new SubsetCache;
+        return *cache;
+    }
+
+    sk_sp<SkData> subset(const SkTypeface& typeface, const SkPDFGlyphUse& glyphUsage) {
+        SubsetKey key(typeface.uniqueID(), glyphUsage);
+        HBFace face;
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (sk_sp<SkData>* data = fSubsets.find(key)) {
+                return *data;
+            }
+            if (HBFace* cached = fFaces.find(key.fTypefaceID)) {
+                face.reset(hb_face_reference(cached->get()));
+            }
+        }
+        if (!face) {
+            face = make_face(typeface);
+            if (!face) {
+                return nullptr;
+            }
+            SkAutoMutexExclusive lock(fMutex);
+            if (!fFaces.find(key.fTypefaceID)) {
+                fFaces.insert(key.fTypefaceID, HBFace(hb_face_reference(face.get())));
+            }
+        }
+
+        sk_sp<SkData> data = subset_face(face.get(), glyphUsage);
+        if (data && data->size() <= kMaxSubsetBytes) {
+            SkAutoMutexExclusive lock(fMutex);
+            if (sk_sp<SkData>* raced = fSubsets.find(key)) {
+                return *raced;
+            }
+            fSubsetBytes += data->size();
+            fSubsets.insert(std::move(key), data);
+            this->purgeSubsetsOverBudget();
+        }
+        return data;
+    }
+
+private:
+    // A face can hold a reference to its typeface, so keep only the most recent few.
+    static constexpr int kMaxFaces = 16;
+    // Subsets of CJK or emoji fonts can run to megabytes each, so bound the total size of the
+    // cached subsets as well as their number. A subset larger than the budget is not cached.
+    static constexpr int kMaxSubsets = 128;
+    static constexpr size_t kMaxSubsetBytes = 8 * 1024 * 1024;
+
+    void purgeSubsetsOverBudget() SK_REQUIRES(fMutex) {
+        while (fSubsetBytes > kMaxSubsetBytes) {
+            // foreach() visits the most recently used subset first, so this finds the least.
+            const SubsetKey* oldest = nullptr;
+            fSubsets.foreach([&](const SubsetKey* key, sk_sp<SkData>*) { oldest = key; });
+            SkASSERT(oldest);
+            const SubsetKey key = *oldest;
+            fSubsets.remove(key);
+        }
+    }
+
+    SkMutex fMutex;
+    SkLRUCache<SkTypefaceID, HBFace> fFaces SK_GUARDED_BY(fMutex){kMaxFaces};
+    size_t fSubsetBytes SK_GUARDED_BY(fMutex) = 0;
+    SkLRUCache<SubsetKey, sk_sp<SkData>, SubsetKey::Hash, SubsetPurge> fSubsets
+            SK_GUARDED_BY(fMutex){kMaxSubsets, &fSubsetBytes};
+};
+
 }  // namespace
 
-sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface, const SkPDFGlyphUse& glyphUsage) {
-    return subset_harfbuzz(typeface, glyphUsage);
+sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface,
+                              const SkPDFGlyphUse& glyphUsage,
+                              bool useCache) {
+    if (useCache) {
+        return SubsetCache::Get().subset(typeface, glyphUsage);
+    }
+    HBFace face = make_face(typeface);
+    return subset_face(face.get(), glyphUsage);
 }
 
 bool SkPDFCanSubsetTableBasedFonts() {
@@ -199,7 +322,7 @@ bool SkPDFCanSubsetTableBasedFonts() {
 
 #else
 
-sk_sp<SkData> SkPDFSubsetFont(const SkTypeface&, const SkPDFGlyphUse&) {
+sk_sp<SkData> SkPDFSubsetFont(const SkTypeface&, const SkPDFGlyphUse&, bool) {
     return nullptr;
 }
 
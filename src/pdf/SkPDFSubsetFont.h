@@ -12,9 +12,13 @@ class SkTypeface;
 /** Subset the typeface's data to only include the glyphs used.
  *  The glyph ids will remain the same.
  *
+ *  @param useCache  Look the subset up in, and add it to, a process-wide cache of subsets and
+ *                   parsed typefaces shared across documents and threads.
  *  @return The subset font data, or nullptr if it cannot be subset.
  */
-sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface, const SkPDFGlyphUse& glyphUsage);
+sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface,
+                              const SkPDFGlyphUse& glyphUsage,
+                              bool useCache);
 
 bool SkPDFCanSubsetTableBasedFonts();
 
@@ -274,7 +274,8 @@ static SkPDFIndirectReference make_type1_font_descriptor(SkPDFDocument* doc,
                 auto fontStream = SkMemoryStream::Make(std::move(fontData));
                 descriptor.insertRef("FontFile",
                                      SkPDFStreamOut(std::move(dict), std::move(fontStream),
-                                                    doc, SkPDFSteamCompressionEnabled::Yes));
+                                                    doc, SkPDFSteamCompressionEnabled::Yes,
+                                                    SkPDFStreamKind::kFont));
             }
         }
     }
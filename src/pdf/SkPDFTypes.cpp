@@ -7,6 +7,7 @@
 
 #include "src/pdf/SkPDFTypes.h"
 
+#include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
@@ -553,9 +554,73 @@ void SkPDFDict::insertUnion(const char key[], SkPDFUnion&& value) {
 
 
 
+// Deflates all of src. Streams with a memory base, or that can be copied into one, are
+// compressed as one buffer, by the client's compressor if there is one. Page content and most
+// other streams are built in an SkDynamicMemoryWStream, which has no memory base, so they are
+// copied: this briefly doubles their footprint, which is bounded by maxCopy. Larger streams go
+// through SkDeflateWStream so they are never copied; the compressed bytes are the same either
+// way.
+static std::unique_ptr<SkStreamAsset> deflate_stream(SkStreamAsset* src,
+                                                     int compressionLevel,
+                                                     SkPDF::DeflateCallback callback,
+                                                     size_t maxCopy) {
+    const size_t length = src->getLength();
+    const void* base = src->getMemoryBase();
+    sk_sp<SkData> copy;
+    if (!base && (callback || length <= maxCopy)) {
+        copy = SkData::MakeFromStream(src, length);
+        base = copy ? copy->data() : nullptr;
+    }
+    if (base) {
+        if (callback) {
+            SkDynamicMemoryWStream compressedData;
+            if (callback(&compressedData, {static_cast<const uint8_t*>(base), length},
+                         compressionLevel)) {
+                return compressedData.detachAsStream();
+            }
+            SkASSERT(compressedData.bytesWritten() == 0);
+        }
+        if (sk_sp<SkData> compressed = SkDeflateCompress(base, length, compressionLevel)) {
+            return SkMemoryStream::Make(std::move(compressed));
+        }
+    }
+    SkAssertResult(src->rewind());
+    SkDynamicMemoryWStream compressedData;
+    SkDeflateWStream deflateWStream(&compressedData, compressionLevel);
+    SkStreamPriv::Copy(&deflateWStream, src);
+    deflateWStream.finalize();
+    return compressedData.detachAsStream();
+}
+
+// Returns stream, or its compressed copy in *compressed if that is smaller, in which case the
+// filter is added to dict.
+static SkStreamAsset* compress_stream(SkPDFDict* dict,
+                                      SkStreamAsset* stream,
+                                      SkPDFStreamKind kind,
+                                      SkPDFDocument* doc,
+                                      std::unique_ptr<SkStreamAsset>* compressed) {
+    static const size_t kMinimumSavings = strlen("/Filter_/FlateDecode_");
+    const SkPDF::Metadata::CompressionLevel level = doc->compressionLevel(kind);
+    if (level == SkPDF::Metadata::CompressionLevel::None ||
+        stream->getLength() <= kMinimumSavings) {
+        return stream;
+    }
+    // Low memory mode only copies streams small enough not to matter.
+    const size_t maxCopy = doc->metadata().fLowMemory ? 64 * 1024 : 16 * 1024 * 1024;
+    *compressed = deflate_stream(stream, SkToInt(level), doc->metadata().deflate, maxCopy);
+    if (stream->getLength() > (*compressed)->getLength() + kMinimumSavings) {
+        dict->insertName("Filter", "FlateDecode");
+        return compressed->get();
+    }
+    compressed->reset();
+    SkAssertResult(stream->rewind());
+    return stream;
+}
+
 static void serialize_stream(SkPDFDict* origDict,
                              SkStreamAsset* stream,
                              SkPDFSteamCompressionEnabled compress,
+                             SkPDFStreamKind kind,
                              SkPDFDocument* doc,
                              SkPDFIndirectReference ref) {
     // Code assumes that the stream starts at the beginning.
@@ -564,23 +629,8 @@ static void serialize_stream(SkPDFDict* origDict,
     std::unique_ptr<SkStreamAsset> tmp;
     SkPDFDict tmpDict;
     SkPDFDict& dict = origDict ? *origDict : tmpDict;
-    static const size_t kMinimumSavings = strlen("/Filter_/FlateDecode_");
-    if (doc->metadata().fCompressionLevel != SkPDF::Metadata::CompressionLevel::None &&
-        compress == SkPDFSteamCompressionEnabled::Yes &&
-        stream->getLength() > kMinimumSavings)
-    {
-        SkDynamicMemoryWStream compressedData;
-        SkDeflateWStream deflateWStream(&compressedData,SkToInt(doc->metadata().fCompressionLevel));
-        SkStreamPriv::Copy(&deflateWStream, stream);
-        deflateWStream.finalize();
-        if (stream->getLength() > compressedData.bytesWritten() + kMinimumSavings) {
-            tmp = compressedData.detachAsStream();
-            stream = tmp.get();
-            dict.insertName("Filter", "FlateDecode");
-        } else {
-            SkAssertResult(stream->rewind());
-        }
-
+    if (compress == SkPDFSteamCompressionEnabled::Yes) {
+        stream = compress_stream(&dict, stream, kind, doc, &tmp);
     }
     dict.insertInt("Length", stream->getLength());
     doc->emitStream(dict,
@@ -588,25 +638,41 @@ static void serialize_stream(SkPDFDict* origDict,
                     ref);
 }
 
+std::unique_ptr<SkStreamAsset> SkPDFCompressStream(SkPDFDict* dict,
+                                                   std::unique_ptr<SkStreamAsset> stream,
+                                                   SkPDFDocument* doc,
+                                                   SkPDFStreamKind kind) {
+    SkASSERT(dict && stream && stream->hasLength());
+    std::unique_ptr<SkStreamAsset> compressed;
+    if (compress_stream(dict, stream.get(), kind, doc, &compressed) == stream.get()) {
+        return stream;
+    }
+    return compressed;
+}
+
 SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
                                       std::unique_ptr<SkStreamAsset> content,
                                       SkPDFDocument* doc,
-                                      SkPDFSteamCompressionEnabled compress) {
+                                      SkPDFSteamCompressionEnabled compress,
+                                      SkPDFStreamKind kind) {
     SkPDFIndirectReference ref = doc->reserveRef();
-    if (SkExecutor* executor = doc->executor()) {
+    SkExecutor* executor = doc->executor();
+    const size_t bytes = content->getLength();
+    if (executor && doc->tryQueueJobBytes(bytes)) {
         SkPDFDict* dictPtr = dict.release();
         SkStreamAsset* contentPtr = content.release();
         // Pass ownership of both pointers into a std::function, which should
         // only be executed once.
         doc->incrementJobCount();
-        executor->add([dictPtr, contentPtr, compress, doc, ref]() {
-            serialize_stream(dictPtr, contentPtr, compress, doc, ref);
+        executor->add([dictPtr, contentPtr, compress, kind, doc, ref, bytes]() {
+            serialize_stream(dictPtr, contentPtr, compress, kind, doc, ref);
             delete dictPtr;
             delete contentPtr;
+            doc->releaseJobBytes(bytes);
             doc->signalJobComplete();
         });
         return ref;
     }
-    serialize_stream(dict.get(), content.get(), compress, doc, ref);
+    serialize_stream(dict.get(), content.get(), compress, kind, doc, ref);
     return ref;
 }
@@ -218,6 +218,14 @@ enum class SkPDFSteamCompressionEnabled : bool {
     Yes = true,
 };
 
+// Selects which of the document's compression levels applies to a stream.
+enum class SkPDFStreamKind {
+    kOther,
+    kContent,  // Page, form and glyph content streams.
+    kFont,     // Embedded font programs and their ToUnicode maps.
+    kImage,
+};
+
 // Exposed for unit testing.
 void SkPDFWriteTextString(SkWStream* wStream, const char* cin, size_t len);
 void SkPDFWriteByteString(SkWStream* wStream, const char* cin, size_t len);
@@ -226,5 +234,13 @@ SkPDFIndirectReference SkPDFStreamOut(
     std::unique_ptr<SkPDFDict> dict,
     std::unique_ptr<SkStreamAsset> stream,
     SkPDFDocument* doc,
-    SkPDFSteamCompressionEnabled compress = SkPDFSteamCompressionEnabled::Yes);
+    SkPDFSteamCompressionEnabled compress = SkPDFSteamCompressionEnabled::Yes,
+    SkPDFStreamKind kind = SkPDFStreamKind::kOther);
+
+// Compresses stream as SkPDFStreamOut() would, adding the filter to dict if it does, so that the
+// work can be done ahead of time. Pass the results to SkPDFStreamOut() without compression.
+std::unique_ptr<SkStreamAsset> SkPDFCompressStream(SkPDFDict* dict,
+                                                   std::unique_ptr<SkStreamAsset> stream,
+                                                   SkPDFDocument* doc,
+                                                   SkPDFStreamKind kind);
 #endif
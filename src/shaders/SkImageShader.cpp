@@ -421,6 +421,8 @@ struct MipLevelHelper {
         gather->stride = pm.rowBytesAsPixels();
         gather->width = pm.width();
         gather->height = pm.height();
+        gather->tileModeX = tileModeX;
+        gather->tileModeY = tileModeY;
 
         if (sampling.useCubic) {
             SkImageShader::CubicResamplerMatrix(sampling.cubic.B, sampling.cubic.C)
@@ -693,12 +695,11 @@ bool SkImageShader::appendStages(const SkStageRec& rec, const SkShaders::MatrixR
     // TODO: Could we use the fast-path stages for each level when doing linear mipmap filtering?
     SkColorType ct = upper.pm.colorType();
     if ((ct == kRGBA_8888_SkColorType || ct == kBGRA_8888_SkColorType) &&
-        !sampling.useCubic && sampling.filter == SkFilterMode::kLinear &&
         sampling.mipmap != SkMipmapMode::kLinear &&
-        fTileModeX == SkTileMode::kClamp && fTileModeY == SkTileMode::kClamp) {
+        (sampling.useCubic || sampling.filter == SkFilterMode::kLinear)) {
         // Check bounding box of points we will sample to see if we can use lowp
         // and not over/under flow.
-        bool shouldUseHighPBilerp = false;
+        bool shouldUseHighP = false;
         if (!rec.fDstBounds.isEmpty()) {
             std::array<SkPoint, 4> quad = rec.fDstBounds.toQuad();
             baseInv.mapPoints(quad);
@@ -706,32 +707,38 @@ bool SkImageShader::appendStages(const SkStageRec& rec, const SkShaders::MatrixR
             deviceImageSpace.setBounds(quad);
             for (float val : SkSpan<const float>(deviceImageSpace.asScalars(), 4)) {
                 if (val > INT16_MAX || val < INT16_MIN || !std::isfinite(val)) {
-                    shouldUseHighPBilerp = true;
+                    shouldUseHighP = true;
                     break;
                 }
             }
         }
+        const bool clampXY = fTileModeX == SkTileMode::kClamp && fTileModeY == SkTileMode::kClamp;
 
-        if (shouldUseHighPBilerp) {
-            p->append(SkRasterPipelineOp::bilerp_clamp_8888_force_highp, upper.gather);
-        } else {
-            p->append(SkRasterPipelineOp::bilerp_clamp_8888, upper.gather);
+        std::optional<SkRasterPipelineOp> fused;
+        if (sampling.useCubic) {
+            // The lowp bicubic_tile_8888 sums in fixed point, which only has the headroom for the
+            // overshoot of cubics with B and C on [0,1].
+            const bool boundedCubic = sampling.cubic.B >= 0 && sampling.cubic.B <= 1 &&
+                                      sampling.cubic.C >= 0 && sampling.cubic.C <= 1;
+            if (!shouldUseHighP && boundedCubic) {
+                fused = SkRasterPipelineOp::bicubic_tile_8888;
+            } else if (clampXY) {
+                fused = SkRasterPipelineOp::bicubic_clamp_8888;
+            }
+        } else if (clampXY) {
+            fused = shouldUseHighP ? SkRasterPipelineOp::bilerp_clamp_8888_force_highp
+                                   : SkRasterPipelineOp::bilerp_clamp_8888;
+        } else if (!shouldUseHighP) {
+            fused = SkRasterPipelineOp::bilerp_tile_8888;
         }
 
-        if (ct == kBGRA_8888_SkColorType) {
-            p->append(SkRasterPipelineOp::swap_rb);
-        }
-        return append_misc();
-    }
-    if ((ct == kRGBA_8888_SkColorType || ct == kBGRA_8888_SkColorType) &&
-        sampling.useCubic &&
-        fTileModeX == SkTileMode::kClamp && fTileModeY == SkTileMode::kClamp) {
-
-        p->append(SkRasterPipelineOp::bicubic_clamp_8888, upper.gather);
-        if (ct == kBGRA_8888_SkColorType) {
-            p->append(SkRasterPipelineOp::swap_rb);
+        if (fused) {
+            p->append(*fused, upper.gather);
+            if (ct == kBGRA_8888_SkColorType) {
+                p->append(SkRasterPipelineOp::swap_rb);
+            }
+            return append_misc();
         }
-        return append_misc();
     }
 
     // This context can be shared by both levels when doing linear mipmap filtering
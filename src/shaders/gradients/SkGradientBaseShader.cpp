@@ -12,6 +12,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkFourByteTag.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkTileMode.h"
@@ -28,15 +29,18 @@
 #include "src/core/SkConvertPixels.h"
 #include "src/core/SkEffectPriv.h"
 #include "src/core/SkFloatBits.h"
+#include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkRasterPipelineOpContexts.h"
 #include "src/core/SkRasterPipelineOpList.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkResourceCache.h"
 #include "src/core/SkVx.h"
 #include "src/core/SkWriteBuffer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <optional>
 #include <utility>
@@ -180,12 +184,26 @@ sk_sp<SkColorSpace> srgb_if_null(sk_sp<SkColorSpace> cs) {
     return cs ? cs : SkColorSpace::MakeSRGB();
 }
 
+static uint32_t next_gradient_id() {
+    static std::atomic<uint32_t> nextID{1};
+    uint32_t id;
+    do {
+        id = nextID.fetch_add(+1, std::memory_order_relaxed);
+    } while (id == 0);
+    return id;
+}
+
+static uint64_t make_lut_shared_id(uint32_t gradientID) {
+    return ((uint64_t)SkSetFourByteTag('g', 'r', 'a', 'd') << 32) | gradientID;
+}
+
 SkGradientBaseShader::SkGradientBaseShader(const SkGradient& desc, const SkMatrix& ptsToUnit)
         : fPtsToUnit(ptsToUnit)
         , fColorSpace(srgb_if_null(desc.colors().colorSpace()))
         , fFirstStopIsImplicit(false)
         , fLastStopIsImplicit(false)
-        , fColorsAreOpaque(true) {
+        , fColorsAreOpaque(true)
+        , fUniqueID(next_gradient_id()) {
     auto colors = desc.colors().colors();
     auto pos = desc.colors().positions();
 
@@ -309,7 +327,11 @@ SkGradientBaseShader::SkGradientBaseShader(const SkGradient& desc, const SkMatri
     }
 }
 
-SkGradientBaseShader::~SkGradientBaseShader() {}
+SkGradientBaseShader::~SkGradientBaseShader() {
+    if (fAddedToCache.load()) {
+        SkResourceCache::PostPurgeSharedID(make_lut_shared_id(fUniqueID));
+    }
+}
 
 static void add_stop_color(SkRasterPipelineContexts::GradientCtx* ctx,
                            size_t stop,
@@ -388,6 +410,45 @@ static void init_stop_pos(SkRasterPipelineContexts::GradientCtx* ctx,
     add_stop_color(ctx, stop, factor, bias);
 }
 
+// There are n - 1 gaps between n colors plus 2 regions to the left and right
+// of the gradient to account for colors. For evenly spaced gradients, we cheat
+// and skip the left gap, using one block of floats unused. Allocate at least enough
+// for the AVX2 gather from a YMM register.
+static size_t factor_bias_floats(int count) {
+    constexpr int kMaxRegisterSize = 8;
+    return std::max(count + 1, kMaxRegisterSize);
+}
+
+// Points the factors and biases of ctx into buffer, and returns the first float after them.
+static float* set_factors_and_biases(SkRasterPipelineContexts::GradientCtx* ctx,
+                                     float* buffer,
+                                     size_t factorBiasFloats) {
+    for (size_t i = 0; i < SkRasterPipelineContexts::kRGBAChannels; i++) {
+        ctx->factors[i] = buffer;
+        buffer += factorBiasFloats;
+        ctx->biases[i] = buffer;
+        buffer += factorBiasFloats;
+    }
+    return buffer;
+}
+
+static void init_evenly_spaced(SkRasterPipelineContexts::GradientCtx* ctx,
+                               const SkPMColor4f* pmColors,
+                               int count) {
+    size_t stopCount = count;
+    float gapCount = stopCount - 1;
+
+    SkPMColor4f c_l = pmColors[0];
+    for (size_t i = 0; i < gapCount; i++) {
+        SkPMColor4f c_r = pmColors[i + 1];
+        init_stop_evenly(ctx, gapCount, i, c_l, c_r);
+        c_l = c_r;
+    }
+    add_const_color(ctx, stopCount - 1, c_l);
+
+    ctx->stopCount = stopCount;
+}
+
 void SkGradientBaseShader::AppendGradientFillStages(SkRasterPipeline* p,
                                                     SkArenaAlloc* alloc,
                                                     const SkPMColor4f* pmColors,
@@ -415,13 +476,7 @@ void SkGradientBaseShader::AppendGradientFillStages(SkRasterPipeline* p,
 
     auto* ctx = alloc->make<SkRasterPipelineContexts::GradientCtx>();
 
-    // Allocate at least enough for the AVX2 gather from a YMM register.
-    constexpr int kMaxRegisterSize = 8;
-
-    // There are n - 1 gaps between n colors plus 2 regions to the left and right
-    // of the gradient to account for colors. For evenly spaced gradients, we cheat
-    // and skip the left gap, using one block of floats unused.
-    const size_t factorBiasFloats = std::max(count + 1, kMaxRegisterSize);
+    const size_t factorBiasFloats = factor_bias_floats(count);
     const size_t tsForArbitraryStops = count + 1;
     using SkRasterPipelineContexts::kRGBAChannels;
 
@@ -429,28 +484,11 @@ void SkGradientBaseShader::AppendGradientFillStages(SkRasterPipeline* p,
     // if we need to include the arbitrary stops.
     const size_t toAlloc = 2 * kRGBAChannels * factorBiasFloats + tsForArbitraryStops;
     float* gradientCtxBuffer = alloc->makeArray<float>(toAlloc);
-    for (size_t i = 0; i < kRGBAChannels; i++) {
-        ctx->factors[i] = gradientCtxBuffer;
-        gradientCtxBuffer += factorBiasFloats;
-        ctx->biases[i] = gradientCtxBuffer;
-        gradientCtxBuffer += factorBiasFloats;
-    }
+    gradientCtxBuffer = set_factors_and_biases(ctx, gradientCtxBuffer, factorBiasFloats);
 
     if (positions == nullptr) {
         // Handle evenly distributed stops.
-
-        size_t stopCount = count;
-        float gapCount = stopCount - 1;
-
-        SkPMColor4f c_l = pmColors[0];
-        for (size_t i = 0; i < gapCount; i++) {
-            SkPMColor4f c_r = pmColors[i + 1];
-            init_stop_evenly(ctx, gapCount, i, c_l, c_r);
-            c_l = c_r;
-        }
-        add_const_color(ctx, stopCount - 1, c_l);
-
-        ctx->stopCount = stopCount;
+        init_evenly_spaced(ctx, pmColors, count);
         p->append(SkRasterPipelineOp::evenly_spaced_gradient, ctx);
         return;
     }
@@ -566,6 +604,218 @@ void SkGradientBaseShader::AppendInterpolatedToDstStages(SkRasterPipeline* p,
             ->apply(p);
 }
 
+#if !defined(SK_DISABLE_RASTER_GRADIENT_LUT)
+namespace {
+
+static unsigned gGradientLUTKeyNamespaceLabel;
+
+struct GradientLUTKey : public SkResourceCache::Key {
+public:
+    GradientLUTKey(uint32_t gradientID, const SkColorSpace* dstCS)
+            : fColorSpaceXYZHash(dstCS ? dstCS->toXYZD50Hash() : 0)
+            , fColorSpaceTransferFnHash(dstCS ? dstCS->transferFnHash() : 0) {
+        static const size_t keySize = sizeof(fColorSpaceXYZHash) +
+                                      sizeof(fColorSpaceTransferFnHash);
+        // This better be packed.
+        SkASSERT(sizeof(uint32_t) * (&fEndOfStruct - &fColorSpaceXYZHash) == keySize);
+        this->init(&gGradientLUTKeyNamespaceLabel, make_lut_shared_id(gradientID), keySize);
+    }
+
+private:
+    uint32_t fColorSpaceXYZHash;
+    uint32_t fColorSpaceTransferFnHash;
+
+    SkDEBUGCODE(uint32_t fEndOfStruct;)
+};
+
+// The factors and biases of an evenly spaced gradient with fStopCount stops, laid out as
+// set_factors_and_biases() expects. fData is null if no LUT approximates the gradient well
+// enough, so that we remember not to try again.
+struct GradientLUT {
+    sk_sp<SkData> fData;
+    int           fStopCount = 0;
+};
+
+struct GradientLUTRec : public SkResourceCache::Rec {
+    GradientLUTRec(const GradientLUTKey& key, GradientLUT lut) : fKey(key), fLUT(std::move(lut)) {}
+
+    GradientLUTKey fKey;
+    GradientLUT    fLUT;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + (fLUT.fData ? fLUT.fData->size() : 0);
+    }
+    const char* getCategory() const override { return "gradient-lut"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
+        const GradientLUTRec& rec = static_cast<const GradientLUTRec&>(baseRec);
+        *static_cast<GradientLUT*>(context) = rec.fLUT;
+        return true;
+    }
+};
+
+// Evaluates the gradient, converted to dstCS, at each of ts.
+void eval_gradient(const SkGradientBaseShader* shader,
+                   const SkColor4fXformer& xformed,
+                   SkColorSpace* dstCS,
+                   SkSpan<const float> ts,
+                   SkPMColor4f* colors) {
+    for (size_t i = 0; i < ts.size(); ++i) {
+        colors[i] = {ts[i], 0, 0, 0};  // The gradient stages read t from r.
+    }
+    SkRasterPipelineContexts::MemoryCtx ctx = {colors, SkToInt(ts.size())};
+
+    SkSTArenaAlloc<1024> alloc;
+    SkRasterPipeline p(&alloc);
+    p.append(SkRasterPipelineOp::load_f32, &ctx);
+    if (!xformed.fPositions) {
+        p.append(SkRasterPipelineOp::clamp_x_1);
+    }
+    SkGradientBaseShader::AppendGradientFillStages(&p, &alloc,
+                                                   xformed.fColors.begin(),
+                                                   xformed.fPositions,
+                                                   xformed.fColors.size());
+    SkGradientBaseShader::AppendInterpolatedToDstStages(&p, &alloc,
+                                                        shader->colorsAreOpaque(),
+                                                        shader->interpolation(),
+                                                        xformed.fIntermediateColorSpace.get(),
+                                                        dstCS);
+    p.append(SkRasterPipelineOp::store_f32, &ctx);
+    p.run(0, 0, ts.size(), 1);
+}
+
+// Samples the gradient at 256 or 1024 evenly spaced t, and keeps the smaller table if linear
+// interpolation between its entries is within kTolerance of the gradient everywhere we check:
+// at points between the entries, at every stop and just either side of it, and, when clamping,
+// beyond either end, where a hard stop at 0 or 1 would be lost. Checking at the stops catches
+// features narrower than a gap between entries, like a spike between two close stops, that the
+// points between entries can miss. Kinks at stops that fall between entries are what usually
+// rule a table out; hard stops always do.
+GradientLUT make_lut(const SkGradientBaseShader* shader, SkColorSpace* dstCS) {
+    static constexpr float kTolerance = 0.25f / 255;
+    static constexpr int kSubSamples = 4;
+    // How far either side of a stop to check, which is well under any gap between entries.
+    static constexpr float kStopNudge = 1.0f / (1 << 20);
+
+    SkColor4fXformer xformed(shader, dstCS);
+    const int colorCount = xformed.fColors.size();
+    TArray<float> stopTs(3 * colorCount);
+    for (int i = 0; i < colorCount; ++i) {
+        const float pos = xformed.fPositions ? xformed.fPositions[i]
+                                             : (float)i / std::max(colorCount - 1, 1);
+        for (float t : {pos - kStopNudge, pos, pos + kStopNudge}) {
+            if (t >= 0 && t <= 1) {
+                stopTs.push_back(t);
+            }
+        }
+    }
+
+    for (int stopCount : {256, 1024}) {
+        const int gapCount = stopCount - 1;
+        TArray<float> ts(stopCount + gapCount * (kSubSamples - 1) + 2 + stopTs.size());
+        for (int i = 0; i < stopCount; ++i) {
+            ts.push_back((float)i / gapCount);
+        }
+        for (int i = 0; i < gapCount; ++i) {
+            for (int k = 1; k < kSubSamples; ++k) {
+                ts.push_back((i + (float)k / kSubSamples) / gapCount);
+            }
+        }
+        ts.push_back(-1);
+        ts.push_back(2);
+        ts.push_back_n(stopTs.size(), stopTs.data());
+
+        AutoTMalloc<SkPMColor4f> colors(ts.size());
+        eval_gradient(shader, xformed, dstCS, ts, colors.get());
+
+        auto error = [](const SkPMColor4f& a, const SkPMColor4f& b) {
+            return max(abs(skvx::float4::Load(a.vec()) - skvx::float4::Load(b.vec())));
+        };
+        auto lerp = [&](int i, float w) {
+            const auto l = skvx::float4::Load(colors[i].vec()),
+                       r = skvx::float4::Load(colors[i + 1].vec());
+            SkPMColor4f lerped;
+            (l + (r - l) * w).store(lerped.vec());
+            return lerped;
+        };
+        float maxError = 0;
+        const SkPMColor4f* between = colors.get() + stopCount;
+        for (int i = 0; i < gapCount; ++i) {
+            for (int k = 1; k < kSubSamples; ++k) {
+                maxError = std::max(maxError, error(lerp(i, (float)k / kSubSamples), *between++));
+            }
+        }
+        if (shader->getTileMode() == SkTileMode::kClamp) {
+            maxError = std::max({maxError,
+                                 error(colors[0], between[0]),
+                                 error(colors[gapCount], between[1])});
+        }
+        const SkPMColor4f* atStops = between + 2;
+        for (int j = 0; j < stopTs.size(); ++j) {
+            const float x = stopTs[j] * gapCount;
+            const int i = std::min((int)x, gapCount - 1);
+            maxError = std::max(maxError, error(lerp(i, x - i), atStops[j]));
+        }
+        if (!(maxError <= kTolerance)) {
+            continue;
+        }
+
+        const size_t factorBiasFloats = factor_bias_floats(stopCount);
+        GradientLUT lut;
+        lut.fData = SkData::MakeUninitialized(2 * SkRasterPipelineContexts::kRGBAChannels *
+                                              factorBiasFloats * sizeof(float));
+        lut.fStopCount = stopCount;
+        SkRasterPipelineContexts::GradientCtx ctx;
+        set_factors_and_biases(&ctx, static_cast<float*>(lut.fData->writable_data()),
+                               factorBiasFloats);
+        init_evenly_spaced(&ctx, colors.get(), stopCount);
+        return lut;
+    }
+    return {};
+}
+
+}  // namespace
+#endif
+
+const SkRasterPipelineContexts::GradientCtx* SkGradientBaseShader::findLUT(
+        const SkStageRec& rec) const {
+#if defined(SK_DISABLE_RASTER_GRADIENT_LUT)
+    return nullptr;
+#else
+    // With fewer stops, the gradient stages are as fast as a lookup in the table. A table also
+    // skips converting from the interpolation color space, so it pays off there for any count.
+    static constexpr size_t kMinStopsForLUT = 8;
+    if (fColorCount < kMinStopsForLUT &&
+        fInterpolation.fColorSpace == Interpolation::ColorSpace::kDestination) {
+        return nullptr;
+    }
+    // The tolerance is only a fraction of a step at 8 bits per channel.
+    if (SkColorTypeMaxBitsPerChannel(rec.fDstColorType) > 8) {
+        return nullptr;
+    }
+
+    const GradientLUTKey key(fUniqueID, rec.fDstCS);
+    GradientLUT lut;
+    if (!SkResourceCache::Find(key, GradientLUTRec::Visitor, &lut)) {
+        lut = make_lut(this, rec.fDstCS);
+        SkResourceCache::Add(new GradientLUTRec(key, lut));
+        fAddedToCache.store(true);
+    }
+    if (!lut.fData) {
+        return nullptr;
+    }
+
+    auto* ctx = rec.fAlloc->make<SkRasterPipelineContexts::GradientCtx>();
+    set_factors_and_biases(ctx, static_cast<float*>(const_cast<void*>(lut.fData->data())),
+                           factor_bias_floats(lut.fStopCount));
+    ctx->stopCount = lut.fStopCount;
+    // The cache may purge the table while the pipeline still reads it.
+    rec.fAlloc->make<sk_sp<SkData>>(std::move(lut.fData));
+    return ctx;
+#endif
+}
+
 bool SkGradientBaseShader::appendStages(const SkStageRec& rec,
                                         const SkShaders::MatrixRec& mRec) const {
     SkRasterPipeline* p = rec.fPipeline;
@@ -581,6 +831,8 @@ bool SkGradientBaseShader::appendStages(const SkStageRec& rec,
 
     this->appendGradientStages(alloc, p, &postPipeline);
 
+    const SkRasterPipelineContexts::GradientCtx* lut = this->findLUT(rec);
+
     switch (fTileMode) {
         case SkTileMode::kMirror:
             p->append(SkRasterPipelineOp::mirror_x_1);
@@ -596,8 +848,8 @@ bool SkGradientBaseShader::appendStages(const SkStageRec& rec,
             [[fallthrough]];
 
         case SkTileMode::kClamp:
-            if (!fPositions) {
-                // We clamp only when the stops are evenly spaced.
+            if (!fPositions || lut) {
+                // We clamp only when the stops are evenly spaced, or approximated by a LUT.
                 // If not, there may be hard stops, and clamping ruins hard stops at 0 and/or 1.
                 // In that case, we must make sure we're using the general "gradient" stage,
                 // which is the only stage that will correctly handle unclamped t.
@@ -606,14 +858,19 @@ bool SkGradientBaseShader::appendStages(const SkStageRec& rec,
             break;
     }
 
-    // Transform all of the colors to destination color space, possibly premultiplied
-    SkColor4fXformer xformedColors(this, rec.fDstCS);
-    AppendGradientFillStages(p, alloc,
-                             xformedColors.fColors.begin(),
-                             xformedColors.fPositions,
-                             xformedColors.fColors.size());
-    AppendInterpolatedToDstStages(p, alloc, fColorsAreOpaque, fInterpolation,
-                                  xformedColors.fIntermediateColorSpace.get(), rec.fDstCS);
+    if (lut) {
+        // The LUT already holds destination colors.
+        p->append(SkRasterPipelineOp::evenly_spaced_gradient, lut);
+    } else {
+        // Transform all of the colors to destination color space, possibly premultiplied
+        SkColor4fXformer xformedColors(this, rec.fDstCS);
+        AppendGradientFillStages(p, alloc,
+                                 xformedColors.fColors.begin(),
+                                 xformedColors.fPositions,
+                                 xformedColors.fColors.size());
+        AppendInterpolatedToDstStages(p, alloc, fColorsAreOpaque, fInterpolation,
+                                      xformedColors.fIntermediateColorSpace.get(), rec.fDstCS);
+    }
 
     if (decal_ctx) {
         p->append(SkRasterPipelineOp::check_decal_mask, decal_ctx);
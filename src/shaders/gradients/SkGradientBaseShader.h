@@ -21,6 +21,7 @@
 #include "src/core/SkColorData.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -32,6 +33,10 @@ class SkWriteBuffer;
 enum class SkTileMode;
 struct SkStageRec;
 
+namespace SkRasterPipelineContexts {
+struct GradientCtx;
+}
+
 class SkGradientScope {
 public:
     std::optional<SkGradient> unflatten(SkReadBuffer&, SkMatrix* legacyLocalMatrix);
@@ -129,6 +134,11 @@ public:
     const SkBitmap& cachedBitmap() const { return fColorsAndOffsetsBitmap; }
     void setCachedBitmap(SkBitmap b) const { fColorsAndOffsetsBitmap = b; }
 
+    // Returns an evenly spaced gradient context that approximates this gradient, converted to the
+    // destination of rec, to within a fraction of an 8-bit step, or nullptr if there is none or
+    // it would not be faster. It is cached in SkResourceCache and kept alive by rec's arena.
+    const SkRasterPipelineContexts::GradientCtx* findLUT(const SkStageRec& rec) const;
+
 private:
     SkColor4f* fColors;               // points into fStorage
     SkScalar* fPositions;             // points into fStorage, or nullptr
@@ -151,6 +161,9 @@ private:
     skia_private::AutoSTMalloc<kInlineStorageSize, uint8_t> fStorage;
 
     bool fColorsAreOpaque;
+
+    const uint32_t fUniqueID;
+    mutable std::atomic<bool> fAddedToCache{false};
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkTiledPlayback.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+bool SkTiledPlayback::Draw(SkSurface* surface,
+                           const SkPicture* picture,
+                           const SkMatrix& matrix,
+                           const Options& options) {
+    if (!surface || !picture || options.fTileSize.isEmpty()) {
+        return false;
+    }
+    const SkImageInfo info = surface->imageInfo();
+    const SkSurfaceProps props = surface->props();
+
+    SkIRect bounds = matrix.mapRect(picture->cullRect()).roundOut();
+    if (!bounds.intersect(info.bounds())) {
+        return true;
+    }
+
+    // Raster surfaces are drawn into directly. Each tile writes only its own pixels, so the
+    // tiles can be drawn concurrently.
+    SkPixmap dst;
+    SkBitmap copy;
+    surface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+    const bool direct = surface->peekPixels(&dst);
+    if (!direct) {
+        if (!copy.tryAllocPixels(info) || !surface->readPixels(copy, 0, 0)) {
+            return false;
+        }
+        dst = copy.pixmap();
+    }
+
+    // Tiles stay on the tile grid even where bounds cuts through them, so that each tile's
+    // device origin, and with it the phase of effects like dithering, matches the surface's.
+    // Clipping each tile to bounds leaves the pixels outside of it alone.
+    const int tileW = options.fTileSize.width(),
+              tileH = options.fTileSize.height();
+    std::vector<SkIRect> tiles;
+    for (int y = bounds.top() / tileH * tileH; y < bounds.bottom(); y += tileH) {
+        for (int x = bounds.left() / tileW * tileW; x < bounds.right(); x += tileW) {
+            SkIRect tile = SkIRect::MakeXYWH(x, y, tileW, tileH);
+            if (tile.intersect(info.bounds())) {
+                tiles.push_back(tile);
+            }
+        }
+    }
+
+    std::atomic<bool> ok{true};
+    auto drawTile = [&](const SkIRect& tile) {
+        SkPixmap pixels;
+        std::unique_ptr<SkCanvas> canvas;
+        if (dst.extractSubset(&pixels, tile)) {
+            canvas = SkCanvas::MakeRasterDirect(pixels.info(), pixels.writable_addr(),
+                                                pixels.rowBytes(), &props);
+        }
+        if (!canvas) {
+            ok = false;
+            return;
+        }
+        canvas->clipIRect(bounds.makeOffset(-tile.x(), -tile.y()));
+        canvas->translate(-tile.x(), -tile.y());
+        canvas->concat(matrix);
+        picture->playback(canvas.get());
+    };
+
+    if (options.fExecutor && tiles.size() > 1) {
+        SkTaskGroup group(*options.fExecutor);
+        for (const SkIRect& tile : tiles) {
+            group.add([&drawTile, tile] { drawTile(tile); });
+        }
+    } else {
+        for (const SkIRect& tile : tiles) {
+            drawTile(tile);
+        }
+    }
+
+    if (!direct) {
+        surface->writePixels(copy, 0, 0);
+    }
+    return ok;
+}
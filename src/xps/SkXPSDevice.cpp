@@ -21,6 +21,7 @@
 #include <T2EmbApi.h>
 #include <FontSub.h>
 #include <limits>
+#include <memory>
 
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
@@ -36,6 +37,7 @@
 #include "include/pathops/SkPathOps.h"
 #include "include/private/SkTDArray.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkDraw.h"
 #include "src/core/SkEndian.h"
 #include "src/core/SkFontPriv.h"
@@ -124,6 +126,7 @@ SkXPSDevice::SkXPSDevice(SkISize s, SkXPS::Options opts)
         : SkClipStackDevice(SkImageInfo::MakeUnknown(s.width(), s.height()), SkSurfaceProps())
         , fCurrentPage(0)
         , fTopTypefaces(&fTypefaces)
+        , fTopImageResources(&fImageResources)
         , fOpts(opts)
 {
     if (!opts.pngEncoder) {
@@ -645,28 +648,50 @@ HRESULT SkXPSDevice::createXpsImageBrush(
     if (!fOpts.pngEncoder(&write, bitmap)) {
         HRM(E_FAIL, "Unable to encode bitmap as png.");
     }
-    SkTScopedComPtr<IStream> read;
-    HRM(SkIStream::CreateFromSkStream(write.detachAsStream(), &read),
-        "Could not create stream from png data.");
+    sk_sp<SkData> png = write.detachAsData();
 
-    const size_t size =
-        std::size(L"/Documents/1/Resources/Images/" L_GUID_ID L".png");
-    wchar_t buffer[size];
-    wchar_t id[GUID_ID_LEN];
-    HR(this->createId(id, GUID_ID_LEN));
-    swprintf_s(buffer, size, L"/Documents/1/Resources/Images/%s.png", id);
+    //Check cache.
+    const uint32_t hash = fOpts.deduplicateImages ? SkChecksum::Hash32(png->data(), png->size())
+                                                  : 0;
+    SkTScopedComPtr<IXpsOMImageResource> imageResource;
+    if (fOpts.deduplicateImages) {
+        for (const ImageResource& current : *this->fTopImageResources) {
+            if (current.hash == hash && current.png->equals(png.get())) {
+                imageResource.reset(SkRefComPtr(current.xpsImage.get()));
+                break;
+            }
+        }
+    }
 
-    SkTScopedComPtr<IOpcPartUri> imagePartUri;
-    HRM(this->fXpsFactory->CreatePartUri(buffer, &imagePartUri),
-        "Could not create image part uri.");
+    if (!imageResource) {
+        SkTScopedComPtr<IStream> read;
+        HRM(SkIStream::CreateFromSkStream(std::make_unique<SkMemoryStream>(png), &read),
+            "Could not create stream from png data.");
 
-    SkTScopedComPtr<IXpsOMImageResource> imageResource;
-    HRM(this->fXpsFactory->CreateImageResource(
-            read.get(),
-            XPS_IMAGE_TYPE_PNG,
-            imagePartUri.get(),
-            &imageResource),
-        "Could not create image resource.");
+        const size_t size =
+            std::size(L"/Documents/1/Resources/Images/" L_GUID_ID L".png");
+        wchar_t buffer[size];
+        wchar_t id[GUID_ID_LEN];
+        HR(this->createId(id, GUID_ID_LEN));
+        swprintf_s(buffer, size, L"/Documents/1/Resources/Images/%s.png", id);
+
+        SkTScopedComPtr<IOpcPartUri> imagePartUri;
+        HRM(this->fXpsFactory->CreatePartUri(buffer, &imagePartUri),
+            "Could not create image part uri.");
+
+        HRM(this->fXpsFactory->CreateImageResource(
+                read.get(),
+                XPS_IMAGE_TYPE_PNG,
+                imagePartUri.get(),
+                &imageResource),
+            "Could not create image resource.");
+
+        if (fOpts.deduplicateImages) {
+            this->fTopImageResources->push_back(
+                    {hash, std::move(png), SkTScopedComPtr<IXpsOMImageResource>(
+                                                   SkRefComPtr(imageResource.get()))});
+        }
+    }
 
     XPS_RECT bitmapRect = {
         0.0, 0.0,
@@ -1971,6 +1996,7 @@ sk_sp<SkDevice> SkXPSDevice::createDevice(const CreateInfo& info, const SkPaint*
     dev->fCurrentUnitsPerMeter = this->fCurrentUnitsPerMeter;
     dev->fCurrentPixelsPerMeter = this->fCurrentPixelsPerMeter;
     dev->fTopTypefaces = this->fTopTypefaces;
+    dev->fTopImageResources = this->fTopImageResources;
     SkAssertResult(dev->createCanvasForLayer());
     return dev;
 }
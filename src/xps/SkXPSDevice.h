@@ -18,9 +18,11 @@
 #include "include/core/SkCPURecorder.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkData.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkRefCnt.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypeface.h"
@@ -124,6 +126,12 @@ private:
     };
     friend HRESULT subset_typeface(const TypefaceUse& current);
 
+    struct ImageResource {
+        uint32_t hash;
+        sk_sp<SkData> png;
+        SkTScopedComPtr<IXpsOMImageResource> xpsImage;
+    };
+
     void onDrawGlyphRunList(SkCanvas*, const sktext::GlyphRunList&, const SkPaint&) override;
 
     bool createCanvasForLayer();
@@ -141,6 +149,10 @@ private:
     skia_private::TArray<TypefaceUse, true> fTypefaces;
     skia_private::TArray<TypefaceUse, true>* fTopTypefaces;
 
+    // Only populated with SkXPS::Options::deduplicateImages.
+    skia_private::TArray<ImageResource> fImageResources;
+    skia_private::TArray<ImageResource>* fTopImageResources;
+
     SkXPS::Options fOpts;
 
     /** Creates a GUID based id and places it into buffer.
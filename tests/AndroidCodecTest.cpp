@@ -8,6 +8,7 @@
 #include "include/codec/SkAndroidCodec.h"
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedImageFormat.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
@@ -20,7 +21,9 @@
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <initializer_list>
 #include <memory>
@@ -132,6 +135,74 @@ DEF_TEST(AndroidCodec_computeSampleSize, r) {
     }
 }
 
+DEF_TEST(AndroidCodec_boxFilter, r) {
+    if (GetResourcePath().isEmpty()) {
+        return;
+    }
+    for (const char* file : { "images/mandrill_512.png", "images/color_wheel.png",
+                              "images/32bpp-topdown-320x240.bmp", "images/rgb24prof.bmp",
+                              "images/mandrill_512_q075.jpg", "images/mandrill.wbmp" }) {
+        for (int sampleSize : { 3, 5 }) {
+            auto codec = SkAndroidCodec::MakeFromCodec(
+                    SkCodec::MakeFromData(GetResourceAsData(file)));
+            if (!codec) {
+                ERRORF(r, "Could not create codec for %s", file);
+                continue;
+            }
+
+            const SkImageInfo fullInfo = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                         .makeAlphaType(kPremul_SkAlphaType);
+            SkBitmap full;
+            full.allocPixels(fullInfo);
+            if (SkCodec::kSuccess != codec->getAndroidPixels(fullInfo, full.getPixels(),
+                                                             full.rowBytes())) {
+                ERRORF(r, "Failed to decode %s", file);
+                continue;
+            }
+
+            SkBitmap thumbnail;
+            thumbnail.allocPixels(fullInfo.makeDimensions(
+                    codec->getSampledDimensions(sampleSize)));
+            SkAndroidCodec::AndroidOptions options;
+            options.fSampleSize = sampleSize;
+            options.fBoxFilter = true;
+            if (SkCodec::kSuccess != codec->getAndroidPixels(thumbnail.info(),
+                                                             thumbnail.getPixels(),
+                                                             thumbnail.rowBytes(), &options)) {
+                ERRORF(r, "Failed to decode %s with sample size %d", file, sampleSize);
+                continue;
+            }
+
+            // Each thumbnail pixel should be the average of the block of pixels it covers.
+            const int sampleX = full.width() / thumbnail.width();
+            const int sampleY = full.height() / thumbnail.height();
+            int maxDiff = 0;
+            for (int y = 0; y < thumbnail.height(); y++) {
+                for (int x = 0; x < thumbnail.width(); x++) {
+                    const uint8_t* actual =
+                            static_cast<const uint8_t*>(thumbnail.getAddr(x, y));
+                    for (int c = 0; c < 4; c++) {
+                        int sum = 0;
+                        for (int dy = 0; dy < sampleY; dy++) {
+                            for (int dx = 0; dx < sampleX; dx++) {
+                                sum += static_cast<const uint8_t*>(
+                                        full.getAddr(x * sampleX + dx, y * sampleY + dy))[c];
+                            }
+                        }
+                        const int count = sampleX * sampleY;
+                        const int expected = (sum + count / 2) / count;
+                        maxDiff = std::max(maxDiff, std::abs(expected - actual[c]));
+                    }
+                }
+            }
+
+            // Color transforms may be applied before or after averaging.
+            REPORTER_ASSERT(r, maxDiff <= 2, "%s sample size %d: max diff %d",
+                            file, sampleSize, maxDiff);
+        }
+    }
+}
+
 DEF_TEST(AndroidCodec_wide, r) {
     if (GetResourcePath().isEmpty()) {
         return;
@@ -11,6 +11,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
@@ -23,18 +24,25 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSize.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/gpu/GpuTypes.h"
 #include "include/private/SkTPin.h"
+#include "src/core/SkBlurEngine.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkColorPriv.h"
 #include "src/core/SkFloatBits.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
+#include "src/core/SkRandom.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
@@ -705,3 +713,196 @@ DEF_TEST(blur_b508075339, reporter) {
     // completes without triggering an SkASSERT in SkBitmap::getAddr.
     canvas->drawRect(SkRect::MakeWH(kCanvasSize, kCanvasSize), paint);
 }
+
+static SkBitmap make_blur_engine_source(SkColorType colorType, int width, int height) {
+    SkBitmap n32;
+    n32.allocN32Pixels(width, height);
+    SkRandom random(42);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            // Mostly smooth content with a few hard edges, which is where box blurs round.
+            U8CPU a = (x / 7 + y / 5) % 3 ? 255 : random.nextULessThan(256);
+            *n32.getAddr32(x, y) = SkPreMultiplyARGB(a,
+                                                     random.nextULessThan(256),
+                                                     (x * 255) / width,
+                                                     (y * 255) / height);
+        }
+    }
+    if (colorType == n32.colorType()) {
+        return n32;
+    }
+    SkBitmap converted;
+    converted.allocPixels(n32.info().makeColorType(colorType));
+    SkAssertResult(n32.readPixels(converted.pixmap()));
+    return converted;
+}
+
+static SkBitmap blur_with_engine(const SkBlurEngine* engine, SkSize sigma, const SkBitmap& src,
+                                 SkTileMode tileMode, const SkIRect& dstRect) {
+    const SkBlurEngine::Algorithm* algorithm = engine->findAlgorithm(sigma, src.colorType());
+    sk_sp<SkSpecialImage> blurred = algorithm->blur(
+            sigma,
+            SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(src.dimensions()), src, {}),
+            SkIRect::MakeSize(src.dimensions()),
+            tileMode,
+            dstRect);
+    SkBitmap result;
+    if (blurred) {
+        SkAssertResult(SkSpecialImages::AsBitmap(blurred.get(), &result));
+    }
+    return result;
+}
+
+// Compares premultiplied 8888 versions of 'a' and 'b', so low alpha does not magnify differences.
+static int max_channel_diff(const SkBitmap& a, const SkBitmap& b, float* meanDiff = nullptr) {
+    if (a.dimensions() != b.dimensions()) {
+        return 256;
+    }
+    SkBitmap a32, b32;
+    a32.allocN32Pixels(a.width(), a.height());
+    b32.allocN32Pixels(b.width(), b.height());
+    SkAssertResult(a.readPixels(a32.pixmap()) && b.readPixels(b32.pixmap()));
+
+    int maxDiff = 0;
+    int64_t totalDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            uint32_t pa = *a32.getAddr32(x, y), pb = *b32.getAddr32(x, y);
+            for (int shift : {0, 8, 16, 24}) {
+                int diff = std::abs(int((pa >> shift) & 0xFF) - int((pb >> shift) & 0xFF));
+                maxDiff = std::max(maxDiff, diff);
+                totalDiff += diff;
+            }
+        }
+    }
+    if (meanDiff) {
+        *meanDiff = totalDiff / (4.f * a.width() * a.height());
+    }
+    return maxDiff;
+}
+
+DEF_TEST(BlurEngine_RasterBoxBlur, reporter) {
+    const SkBlurEngine* boxEngine = SkBlurEngine::GetRasterBlurEngine();
+    const SkBlurEngine* scanlineEngine = SkBlurEngine::GetRasterScanlineBlurEngine();
+    const SkBitmap src8888 = make_blur_engine_source(kN32_SkColorType, 61, 47);
+
+    const SkSize sigmas[] = {{2.5f, 2.5f}, {7.f, 3.f}, {30.f, 30.f}, {5.f, 0.f}, {0.f, 12.f}};
+    const SkIRect dstRects[] = {SkIRect::MakeLTRB(-20, -20, 81, 67),  // outset
+                                SkIRect::MakeLTRB(10, 5, 40, 30),     // inset
+                                SkIRect::MakeLTRB(50, -30, 120, 20)}; // partially disjoint
+    for (SkSize sigma : sigmas) {
+        REPORTER_ASSERT(reporter,
+                        !boxEngine->findAlgorithm(sigma, kN32_SkColorType)
+                                 ->supportsOnlyDecalTiling());
+
+        for (const SkIRect& dstRect : dstRects) {
+            // The 8888 box blur rounds exactly like the per-scanline box passes.
+            SkBitmap box = blur_with_engine(boxEngine, sigma, src8888, SkTileMode::kDecal,
+                                            dstRect);
+            SkBitmap scanline = blur_with_engine(scanlineEngine, sigma, src8888,
+                                                 SkTileMode::kDecal, dstRect);
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(box, scanline),
+                            "sigma (%g, %g)", sigma.width(), sigma.height());
+
+            // A8 sums the same way but rounds slightly differently from A8Pass.
+            const SkBitmap srcA8 = make_blur_engine_source(kAlpha_8_SkColorType, 61, 47);
+            box = blur_with_engine(boxEngine, sigma, srcA8, SkTileMode::kDecal, dstRect);
+            scanline = blur_with_engine(scanlineEngine, sigma, srcA8, SkTileMode::kDecal,
+                                        dstRect);
+            REPORTER_ASSERT(reporter, max_channel_diff(box, scanline) <= 1);
+
+            // F16 matches the 8888 result up to the 8-bit rounding of the intermediate pass.
+            const SkBitmap srcF16 = make_blur_engine_source(kRGBA_F16_SkColorType, 61, 47);
+            box = blur_with_engine(boxEngine, sigma, src8888, SkTileMode::kDecal, dstRect);
+            SkBitmap boxF16 = blur_with_engine(boxEngine, sigma, srcF16, SkTileMode::kDecal,
+                                               dstRect);
+            REPORTER_ASSERT(reporter, max_channel_diff(box, boxF16) <= 2);
+        }
+    }
+}
+
+DEF_TEST(BlurEngine_RasterBoxBlurTileModes, reporter) {
+    const SkBlurEngine* engine = SkBlurEngine::GetRasterBlurEngine();
+    const SkBitmap src = make_blur_engine_source(kN32_SkColorType, 37, 29);
+    const SkIRect dstRect = SkIRect::MakeLTRB(-25, -10, 60, 45);
+    const SkSize sigma = {6.f, 4.f};
+
+    // Blurring with a tile mode must match a decal blur of a source that was tiled up front, as
+    // long as the pre-tiled source covers everything the blur reads.
+    constexpr int kPad = 64;
+    for (SkTileMode tileMode : {SkTileMode::kClamp, SkTileMode::kRepeat, SkTileMode::kMirror}) {
+        SkBitmap tiled;
+        tiled.allocPixels(src.info().makeWH(src.width() + 2 * kPad, src.height() + 2 * kPad));
+        SkCanvas canvas(tiled);
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+        paint.setShader(src.makeShader(tileMode, tileMode, SkSamplingOptions(),
+                                       SkMatrix::Translate(kPad, kPad)));
+        canvas.drawPaint(paint);
+
+        SkBitmap expected = blur_with_engine(engine, sigma, tiled, SkTileMode::kDecal,
+                                             dstRect.makeOffset(kPad, kPad));
+        SkBitmap actual = blur_with_engine(engine, sigma, src, tileMode, dstRect);
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual),
+                        "tile mode %d", (int)tileMode);
+    }
+}
+
+DEF_TEST(BlurEngine_RasterDownscaledBlurAccuracy, reporter) {
+    // A drop shadow style source: opaque shapes on transparent black.
+    SkBitmap src;
+    src.allocN32Pixels(256, 256);
+    SkCanvas canvas(src);
+    canvas.clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(0xFF3060C0);
+    canvas.drawRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(20, 30, 180, 150), 16, 16), paint);
+    paint.setColor(0xFFE08020);
+    canvas.drawCircle(170, 180, 60, paint);
+
+    const SkBlurEngine* engine = SkBlurEngine::GetRasterBlurEngine();
+    for (float sigma : {30.f, 60.f, 120.f}) {
+        const SkBlurEngine::Algorithm* algorithm =
+                engine->findAlgorithm({sigma, sigma}, src.colorType());
+        REPORTER_ASSERT(reporter, sigma > algorithm->maxFullResolutionSigma());
+        REPORTER_ASSERT(reporter, sigma <= algorithm->maxSigma());
+
+        // The full resolution blur, evaluated directly by the algorithm.
+        const int radius = SkBlurEngine::SigmaToRadius(sigma);
+        const SkIRect dstBounds = src.bounds().makeOutset(radius, radius);
+        SkBitmap exact = blur_with_engine(engine, {sigma, sigma}, src, SkTileMode::kDecal,
+                                          dstBounds);
+
+        // The image filter blur, which is evaluated at a lower resolution and upscaled.
+        SkIRect outSubset;
+        SkIPoint offset;
+        sk_sp<SkImage> filtered = SkImages::MakeWithFilter(
+                src.asImage(), SkImageFilters::Blur(sigma, sigma, nullptr).get(), src.bounds(),
+                dstBounds, &outSubset, &offset);
+        REPORTER_ASSERT(reporter, filtered && !exact.empty());
+        if (!filtered || exact.empty()) {
+            continue;
+        }
+
+        SkBitmap downscaled;
+        SkAssertResult(filtered->asLegacyBitmap(&downscaled));
+        SkIRect overlap = SkIRect::MakeXYWH(offset.x(), offset.y(),
+                                            outSubset.width(), outSubset.height());
+        SkAssertResult(overlap.intersect(dstBounds));
+
+        SkBitmap exactOverlap, downscaledOverlap;
+        SkAssertResult(exact.extractSubset(
+                &exactOverlap, overlap.makeOffset(-dstBounds.left(), -dstBounds.top())));
+        SkAssertResult(downscaled.extractSubset(
+                &downscaledOverlap,
+                overlap.makeOffset(outSubset.left() - offset.x(), outSubset.top() - offset.y())));
+
+        // Simulating the rescale chain on this source gives at most two 8-bit steps; allow one
+        // more for rounding when the upscaled result is drawn.
+        float meanDiff;
+        int maxDiff = max_channel_diff(exactOverlap, downscaledOverlap, &meanDiff);
+        REPORTER_ASSERT(reporter, maxDiff <= 3 && meanDiff <= 0.25f,
+                        "sigma %g: max diff %d, mean diff %g", sigma, maxDiff, meanDiff);
+    }
+}
@@ -13,6 +13,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -21,6 +22,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
+#include "include/private/SkTo.h"
 #include "tests/CodecPriv.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -581,6 +583,65 @@ DEF_TEST(AndroidCodec_animated_gif, r) {
     test_animated_AndroidCodec(r, "images/required.gif");
 }
 
+// DecodeAllFrames must match decoding each frame on its own, whether or not it runs on an
+// executor.
+DEF_TEST(Codec_DecodeAllFrames, r) {
+    if (GetResourcePath().isEmpty()) {
+        return;
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const char* file : { "images/required.gif",
+                              "images/required.webp",
+                              "images/alphabetAnim.gif",
+                              "images/stoplight.webp",
+                              "images/randPixels.png" }) {
+        sk_sp<SkData> data(GetResourceAsData(file));
+        if (!data) {
+            ERRORF(r, "Missing %s", file);
+            continue;
+        }
+
+        std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(data));
+        if (!codec) {
+            ERRORF(r, "Failed to create codec for %s", file);
+            continue;
+        }
+        const int frameCount = codec->getFrameCount();
+
+        for (SkExecutor* exec : { (SkExecutor*)nullptr, executor.get() }) {
+            std::vector<SkBitmap> frames;
+            SkCodec::Result result = SkCodecs::DecodeAllFrames(data, kN32_SkColorType,
+                                                               kPremul_SkAlphaType, exec, &frames);
+            REPORTER_ASSERT(r, result == SkCodec::kSuccess, "%s: %s", file,
+                            SkCodec::ResultToString(result));
+            if (SkToInt(frames.size()) != frameCount) {
+                ERRORF(r, "%s: expected %i frames, got %zu", file, frameCount, frames.size());
+                continue;
+            }
+
+            for (int i = 0; i < frameCount; i++) {
+                const SkImageInfo& info = frames[i].info();
+                SkBitmap expected;
+                expected.allocPixels(info);
+                SkCodec::Options options;
+                options.fFrameIndex = i;
+                result = codec->getPixels(expected.pixmap(), &options);
+                REPORTER_ASSERT(r, result == SkCodec::kSuccess);
+
+                for (int y = 0; y < info.height(); ++y) {
+                    if (0 != memcmp(expected.getAddr(0, y), frames[i].getAddr(0, y),
+                                    info.minRowBytes())) {
+                        ERRORF(r, "%s: pixel mismatch for frame %i line %i (executor: %s)",
+                               file, i, y, exec ? "yes" : "no");
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
 DEF_TEST(EncodedOriginToMatrixTest, r) {
     // SkAnimCodecPlayer relies on the fact that these matrices are invertible.
     for (auto origin : { kTopLeft_SkEncodedOrigin     ,
@@ -2129,6 +2129,63 @@ DEF_TEST(Codec_gif_notseekable2, r) {
     compare_to_good_digest(r, goodDigest, bm);
 }
 
+// Codecs read a memory-backed input (e.g. a mapped file) in place instead of copying it
+// through their own buffers. Verify that this matches decoding the same file from a stream.
+DEF_TEST(Codec_mappedData, r) {
+    for (const char* file : { "images/flightAnim.gif",
+                              "images/test640x479.gif",
+                              "images/mandrill_512.png",
+                              "images/plane_interlaced.png" }) {
+        const SkString path = GetResourcePath(file);
+        sk_sp<SkData> mapped = SkData::MakeFromFileName(path.c_str());
+        std::unique_ptr<SkFILEStream> fileStream = SkFILEStream::Make(path.c_str());
+        if (!mapped || !fileStream) {
+            SkDebugf("Missing resource '%s'\n", file);
+            continue;
+        }
+
+        auto mappedCodec = SkCodec::MakeFromData(mapped);
+        auto streamCodec = SkCodec::MakeFromStream(std::move(fileStream));
+        if (!mappedCodec || !streamCodec) {
+            ERRORF(r, "Failed to create codecs for %s", file);
+            continue;
+        }
+        const int frameCount = mappedCodec->getFrameCount();
+        REPORTER_ASSERT(r, frameCount == streamCodec->getFrameCount());
+
+        const SkImageInfo info = mappedCodec->getInfo().makeColorType(kN32_SkColorType);
+        // Decode the last frame first so that returning to the first one seeks backwards.
+        for (int frame : { frameCount - 1, 0 }) {
+            SkCodec::Options options;
+            options.fFrameIndex = frame;
+
+            SkBitmap mappedBm, streamBm;
+            mappedBm.allocPixels(info);
+            streamBm.allocPixels(info);
+            REPORTER_ASSERT(r, mappedCodec->getPixels(mappedBm.pixmap(), &options) ==
+                               SkCodec::kSuccess);
+            REPORTER_ASSERT(r, streamCodec->getPixels(streamBm.pixmap(), &options) ==
+                               SkCodec::kSuccess);
+            REPORTER_ASSERT(r, md5(mappedBm) == md5(streamBm), "%s frame %i", file, frame);
+        }
+
+        if (frameCount > 1) {
+            continue;
+        }
+        // Running out of mapped bytes is reported the same way as a stream running dry.
+        auto truncated = SkCodec::MakeFromData(SkData::MakeSubset(mapped.get(), 0,
+                                                                  mapped->size() / 2));
+        if (!truncated) {
+            ERRORF(r, "Failed to create codec for truncated %s", file);
+            continue;
+        }
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, truncated->getPixels(bm.pixmap()) == SkCodec::kIncompleteInput,
+                        "%s", file);
+    }
+}
+
 DEF_TEST(Codec_gif_null_param, r) {
     constexpr char path[] = "images/flightAnim.gif";
     sk_sp<SkData> data(GetResourceAsData(path));
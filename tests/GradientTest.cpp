@@ -30,9 +30,14 @@
 #include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
 #include "include/private/gpu/ganesh/GrTypesPriv.h"
+#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkColorPriv.h"
+#include "src/core/SkColorSpacePriv.h"
+#include "src/core/SkEffectPriv.h"
+#include "src/core/SkRasterPipeline.h"
 #include "src/core/SkTLazy.h"
 #include "src/shaders/SkShaderBase.h"
+#include "src/shaders/gradients/SkGradientBaseShader.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
 
@@ -46,7 +51,10 @@
 #include "src/gpu/ganesh/SurfaceDrawContext.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 
@@ -647,3 +655,100 @@ DEF_TEST(Gradient, reporter) {
     test_unsorted_degenerate(reporter);
 #endif
 }
+
+static bool uses_lut(const sk_sp<SkShader>& shader, SkColorType dstColorType) {
+    SkSTArenaAlloc<256> alloc;
+    SkRasterPipeline p(&alloc);
+    SkSurfaceProps props;
+    SkStageRec rec = {&p, &alloc, dstColorType, sk_srgb_singleton(), SkColors::kBlack, props,
+                      SkRect::MakeEmpty()};
+    SkASSERT(as_SB(shader)->type() == SkShaderBase::ShaderType::kGradientBase);
+    return static_cast<const SkGradientBaseShader*>(as_SB(shader))->findLUT(rec) != nullptr;
+}
+
+// Draws shader to 8888, where it may be drawn from a LUT, and to F16, where it never is, and
+// returns the largest difference in any channel.
+static int max_lut_difference(const sk_sp<SkShader>& shader, SkISize size) {
+    SkPaint paint;
+    paint.setShader(shader);
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(size, SkColorSpace::MakeSRGB());
+    SkBitmap lut, exact, converted;
+    lut.allocPixels(info);
+    exact.allocPixels(info.makeColorType(kRGBA_F16_SkColorType));
+    converted.allocPixels(info);
+    SkCanvas(lut).drawPaint(paint);
+    SkCanvas(exact).drawPaint(paint);
+    SkAssertResult(exact.readPixels(converted.pixmap()));
+
+    int maxDifference = 0;
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            const uint32_t a = *lut.getAddr32(x, y), b = *converted.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                maxDifference = std::max(maxDifference,
+                                         std::abs((int)((a >> shift) & 0xFF) -
+                                                  (int)((b >> shift) & 0xFF)));
+            }
+        }
+    }
+    return maxDifference;
+}
+
+// Gradients that a LUT approximates closely enough are drawn from one, and match the stages.
+DEF_TEST(Gradient_LUT, reporter) {
+    const SkPoint pts[2] = {{0, 0}, {1000, 0}};
+    const SkISize size = {1000, 4};
+
+    // Many stops along a smooth curve.
+    SkColor4f smooth[16];
+    for (int i = 0; i < 16; ++i) {
+        smooth[i] = {0.5f + 0.5f * std::sin(i * 0.4f), 0.5f + 0.5f * std::cos(i * 0.3f),
+                     i / 15.f, 1};
+    }
+    sk_sp<SkShader> smoothShader = SkShaders::LinearGradient(
+            pts, {{smooth, SkTileMode::kClamp}, {}});
+    sk_sp<SkShader> smoothRadial = SkShaders::RadialGradient(
+            {500, 2}, 100, {{smooth, SkTileMode::kRepeat}, {}});
+
+    // Two stops, but interpolated in OKLab and converted back for every pixel.
+    const SkColor4f redBlue[] = {SkColors::kRed, SkColors::kBlue};
+    SkGradient::Interpolation oklab;
+    oklab.fColorSpace = SkGradient::Interpolation::ColorSpace::kOKLab;
+    sk_sp<SkShader> oklabShader = SkShaders::LinearGradient(
+            pts, {{redBlue, SkTileMode::kClamp}, oklab});
+
+    // Hard stops, which a LUT would blur.
+    SkColor4f hard[10];
+    float hardPos[10];
+    for (int i = 0; i < 10; ++i) {
+        hard[i] = i % 4 < 2 ? SkColors::kGreen : SkColors::kMagenta;
+        hardPos[i] = ((i + 1) / 2) / 5.f;
+    }
+    sk_sp<SkShader> hardShader = SkShaders::LinearGradient(
+            pts, {{hard, hardPos, SkTileMode::kClamp}, {}});
+
+    // A spike between two stops much closer together than the LUT's entries, which sampling
+    // only between the entries would miss. Stretched so that the spike covers ten pixels.
+    const SkColor4f spike[] = {SkColors::kRed, SkColors::kRed, SkColors::kRed, SkColors::kRed,
+                               SkColors::kRed, SkColors::kBlue, SkColors::kRed, SkColors::kRed,
+                               SkColors::kRed};
+    const float spikePos[] = {0, 0.125f, 0.25f, 0.375f, 0.5f, 0.50005f, 0.5001f, 0.75f, 1};
+    const SkPoint spikePts[2] = {{-49500, 0}, {50500, 0}};
+    sk_sp<SkShader> spikeShader = SkShaders::LinearGradient(
+            spikePts, {{spike, spikePos, SkTileMode::kClamp}, {}});
+
+#if !defined(SK_DISABLE_RASTER_GRADIENT_LUT)
+    REPORTER_ASSERT(reporter, uses_lut(smoothShader, kN32_SkColorType));
+    REPORTER_ASSERT(reporter, uses_lut(smoothRadial, kN32_SkColorType));
+    REPORTER_ASSERT(reporter, uses_lut(oklabShader, kN32_SkColorType));
+#endif
+    REPORTER_ASSERT(reporter, !uses_lut(hardShader, kN32_SkColorType));
+    REPORTER_ASSERT(reporter, !uses_lut(spikeShader, kN32_SkColorType));
+    REPORTER_ASSERT(reporter, !uses_lut(smoothShader, kRGBA_F16_SkColorType));
+
+    for (const sk_sp<SkShader>& shader :
+         {smoothShader, smoothRadial, oklabShader, hardShader, spikeShader}) {
+        REPORTER_ASSERT(reporter, max_lut_difference(shader, size) <= 1);
+    }
+}
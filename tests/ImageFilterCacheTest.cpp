@@ -25,8 +25,11 @@
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkDebug.h"
 #include "include/private/gpu/ganesh/GrTypesPriv.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkDevice.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilterTypes.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkSpecialImage.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
@@ -47,8 +50,10 @@
 #endif
 
 #include <cstddef>
+#include <cstring>
 #include <tuple>
 #include <utility>
+#include <vector>
 
  class GrRecordingContext;
  struct GrContextOptions;
@@ -206,6 +211,283 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_explicit_purging(reporter, fullImg, subsetImg);
 }
 
+static SkImageFilterCacheKey make_key(uint32_t id, const sk_sp<SkSpecialImage>& image) {
+    return SkImageFilterCacheKey(id, SkMatrix::I(), SkIRect::MakeWH(100, 100),
+                                 image->uniqueID(), image->subset());
+}
+
+// Results that have been hit, or were set as likely to be reused, outlive one-off results that
+// were set after them.
+DEF_TEST(ImageFilterCache_ReusedResultsSurviveChurn, reporter) {
+    SkBitmap srcBM = create_bm();
+    sk_sp<SkSpecialImage> image = SkSpecialImages::MakeFromRaster(
+            SkIRect::MakeWH(kFullSize, kFullSize), srcBM, SkSurfaceProps());
+    const skif::FilterResult result(image, skif::LayerSpace<SkIPoint>({0, 0}));
+    auto filter = make_filter();
+
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(3 * image->getSize() + 10));
+    skif::FilterResult found;
+
+    cache->set(make_key(0, image), filter.get(), result);
+    REPORTER_ASSERT(reporter, cache->get(make_key(0, image), &found));
+    cache->set(make_key(1, image), filter.get(), result,
+               SkImageFilterCache::Retention::kLikelyReused);
+    for (uint32_t id = 2; id < 10; ++id) {
+        cache->set(make_key(id, image), filter.get(), result);
+    }
+
+    REPORTER_ASSERT(reporter, cache->get(make_key(0, image), &found));
+    REPORTER_ASSERT(reporter, cache->get(make_key(1, image), &found));
+    REPORTER_ASSERT(reporter, cache->get(make_key(9, image), &found));
+    REPORTER_ASSERT(reporter, !cache->get(make_key(8, image), &found));
+    SkDEBUGCODE(REPORTER_ASSERT(reporter, 3 == cache->count());)
+
+    // Shrinking the budget still evicts reused results once the others are gone.
+    cache->setMaxBytes(image->getSize());
+    SkDEBUGCODE(REPORTER_ASSERT(reporter, 1 == cache->count());)
+    REPORTER_ASSERT(reporter, cache->stats().fTotal.fBytes == image->getSize());
+}
+
+DEF_TEST(ImageFilterCache_Stats, reporter) {
+    SkBitmap srcBM = create_bm();
+    sk_sp<SkSpecialImage> image = SkSpecialImages::MakeFromRaster(
+            SkIRect::MakeWH(kFullSize, kFullSize), srcBM, SkSurfaceProps());
+    const skif::FilterResult result(image, skif::LayerSpace<SkIPoint>({0, 0}));
+    auto filter = make_filter();
+
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(1000000));
+    skif::FilterResult found;
+
+    cache->set(make_key(0, image), filter.get(), result);
+    REPORTER_ASSERT(reporter, cache->get(make_key(0, image), &found));
+    REPORTER_ASSERT(reporter, !cache->get(make_key(1, image), &found));
+    cache->newFrame();
+    REPORTER_ASSERT(reporter, cache->get(make_key(0, image), &found));
+    REPORTER_ASSERT(reporter, cache->get(make_key(0, image), &found));
+
+    SkImageFilterCache::Stats stats = cache->stats();
+    REPORTER_ASSERT(reporter, stats.fTotal.fHits == 3);
+    REPORTER_ASSERT(reporter, stats.fTotal.fInserts == 1);
+    REPORTER_ASSERT(reporter, stats.fTotal.fEvictions == 0);
+    REPORTER_ASSERT(reporter, stats.fTotal.fBytes == image->getSize());
+    REPORTER_ASSERT(reporter, stats.fTotal.fEntries == 1);
+    REPORTER_ASSERT(reporter, stats.fMisses == 1);
+    REPORTER_ASSERT(reporter, stats.fCrossFrameHits == 1);
+    REPORTER_ASSERT(reporter, stats.fMaxBytes == 1000000);
+    REPORTER_ASSERT(reporter, stats.fByFilterType.size() == 1);
+    REPORTER_ASSERT(reporter, !strcmp(stats.fByFilterType[0].first, filter->getTypeName()));
+    REPORTER_ASSERT(reporter, stats.fByFilterType[0].second.fHits == 3);
+
+    cache->resetStats();
+    stats = cache->stats();
+    REPORTER_ASSERT(reporter, stats.fTotal.fHits == 0);
+    REPORTER_ASSERT(reporter, stats.fMisses == 0);
+    REPORTER_ASSERT(reporter, stats.fTotal.fBytes == image->getSize());
+
+    cache->purge();
+    stats = cache->stats();
+    REPORTER_ASSERT(reporter, stats.fTotal.fBytes == 0);
+    REPORTER_ASSERT(reporter, stats.fTotal.fEntries == 0);
+}
+
+// Mirrors how the cache picks a shard for a key, so that a test can fill particular shards.
+static int shard_index(const SkImageFilterCacheKey& key, int shardCount) {
+    return (SkChecksum::Hash32(&key, sizeof(key)) >> 24) & (shardCount - 1);
+}
+
+// A one-off result must not evict a reused result from its own shard while another shard still
+// holds one-off results.
+DEF_TEST(ImageFilterCache_ReusedResultsSurviveChurnAcrossShards, reporter) {
+    SkBitmap srcBM;
+    srcBM.allocPixels(SkImageInfo::MakeN32Premul(512, 512));
+    srcBM.eraseColor(SK_ColorTRANSPARENT);
+    srcBM.setImmutable();
+    sk_sp<SkSpecialImage> image = SkSpecialImages::MakeFromRaster(
+            SkIRect::MakeWH(512, 512), srcBM, SkSurfaceProps());
+    const skif::FilterResult result(image, skif::LayerSpace<SkIPoint>({0, 0}));
+    auto filter = make_filter();
+
+    // Room for eight results, split over two shards that may each protect three of them.
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(8 * image->getSize()));
+    const int shardCount = cache->stats().fShardCount;
+    REPORTER_ASSERT(reporter, shardCount == 2);
+    if (shardCount != 2) {
+        return;
+    }
+
+    std::vector<uint32_t> ids[2];
+    for (uint32_t id = 0; ids[0].size() < 4 || ids[1].size() < 5; ++id) {
+        ids[shard_index(make_key(id, image), shardCount)].push_back(id);
+    }
+
+    // Fill the first shard with reused results, and the second with one-off results.
+    skif::FilterResult found;
+    for (int i = 0; i < 3; ++i) {
+        cache->set(make_key(ids[0][i], image), filter.get(), result);
+        REPORTER_ASSERT(reporter, cache->get(make_key(ids[0][i], image), &found));
+    }
+    for (int i = 0; i < 5; ++i) {
+        cache->set(make_key(ids[1][i], image), filter.get(), result);
+    }
+
+    // A one-off result in the first shard evicts the oldest one-off result in the second.
+    cache->set(make_key(ids[0][3], image), filter.get(), result);
+    for (int i = 0; i < 4; ++i) {
+        REPORTER_ASSERT(reporter, cache->get(make_key(ids[0][i], image), &found));
+    }
+    REPORTER_ASSERT(reporter, !cache->get(make_key(ids[1][0], image), &found));
+    for (int i = 1; i < 5; ++i) {
+        REPORTER_ASSERT(reporter, cache->get(make_key(ids[1][i], image), &found));
+    }
+}
+
+// A large cache is sharded. Every result is still found, and purging by filter reaches them all.
+DEF_TEST(ImageFilterCache_Sharded, reporter) {
+    SkBitmap srcBM = create_bm();
+    sk_sp<SkSpecialImage> image = SkSpecialImages::MakeFromRaster(
+            SkIRect::MakeWH(kFullSize, kFullSize), srcBM, SkSurfaceProps());
+    const skif::FilterResult result(image, skif::LayerSpace<SkIPoint>({0, 0}));
+    auto filter1 = make_filter();
+    auto filter2 = make_filter();
+
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(64 * 1024 * 1024));
+    REPORTER_ASSERT(reporter, cache->stats().fShardCount > 1);
+
+    static constexpr uint32_t kCount = 100;
+    for (uint32_t id = 0; id < kCount; ++id) {
+        cache->set(make_key(id, image), id % 2 ? filter1.get() : filter2.get(), result);
+    }
+    skif::FilterResult found;
+    for (uint32_t id = 0; id < kCount; ++id) {
+        REPORTER_ASSERT(reporter, cache->get(make_key(id, image), &found));
+    }
+    REPORTER_ASSERT(reporter, cache->stats().fTotal.fEntries == (int) kCount);
+
+    cache->purgeByImageFilter(filter1.get());
+    for (uint32_t id = 0; id < kCount; ++id) {
+        REPORTER_ASSERT(reporter, cache->get(make_key(id, image), &found) == !(id % 2));
+    }
+    REPORTER_ASSERT(reporter, cache->stats().fTotal.fEntries == (int) kCount / 2);
+}
+
+
+namespace {
+// Records the retention each filter's results were set with, and otherwise forwards to a cache.
+class RetentionRecordingCache final : public SkImageFilterCache {
+public:
+    RetentionRecordingCache() : fCache(SkImageFilterCache::Create(kDefaultTransientSize)) {}
+
+    bool get(const SkImageFilterCacheKey& key, skif::FilterResult* result) const override {
+        return fCache->get(key, result);
+    }
+    void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
+             const skif::FilterResult& result, Retention retention) override {
+        fSets.push_back({as_IFB(filter)->uniqueID(), retention});
+        fCache->set(key, filter, result, retention);
+    }
+    void purge() override { fCache->purge(); }
+    void purgeByImageFilter(const SkImageFilter* filter) override {
+        fCache->purgeByImageFilter(filter);
+    }
+    void setMaxBytes(size_t maxBytes) override { fCache->setMaxBytes(maxBytes); }
+    void newFrame() override { fCache->newFrame(); }
+    Stats stats() const override { return fCache->stats(); }
+    void resetStats() override { fCache->resetStats(); }
+    SkDEBUGCODE(int count() const override { return fCache->count(); })
+
+    std::vector<std::pair<uint32_t, Retention>> fSets;
+
+private:
+    sk_sp<SkImageFilterCache> fCache;
+};
+
+// A raster backend that caches results in a RetentionRecordingCache.
+class RecordingRasterBackend final : public skif::Backend {
+public:
+    RecordingRasterBackend(sk_sp<RetentionRecordingCache> cache)
+            : Backend(std::move(cache), SkSurfaceProps(), kN32_SkColorType)
+            , fRaster(skif::MakeRasterBackend(SkSurfaceProps(), kN32_SkColorType)) {}
+
+    sk_sp<SkDevice> makeDevice(SkISize size, sk_sp<SkColorSpace> colorSpace,
+                               const SkSurfaceProps* props) const override {
+        return fRaster->makeDevice(size, std::move(colorSpace), props);
+    }
+    sk_sp<SkSpecialImage> makeImage(const SkIRect& subset, sk_sp<SkImage> image) const override {
+        return fRaster->makeImage(subset, std::move(image));
+    }
+    sk_sp<SkImage> getCachedBitmap(const SkBitmap& data) const override {
+        return fRaster->getCachedBitmap(data);
+    }
+    const SkBlurEngine* getBlurEngine() const override { return fRaster->getBlurEngine(); }
+
+private:
+    sk_sp<skif::Backend> fRaster;
+};
+}  // namespace
+
+// A filter whose output feeds more than one consumer in a DAG is cached as likely to be reused,
+// and the rest are not.
+DEF_TEST(ImageFilterCache_SharedInputsLikelyReused, reporter) {
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(64, 64);
+    srcBM.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> src = srcBM.asImage();
+
+    // The offset asks its input for a different area than the merge does, so the shared blur is
+    // evaluated, and cached, twice.
+    sk_sp<SkImageFilter> shared = SkImageFilters::Blur(2.f, 2.f, nullptr);
+    sk_sp<SkImageFilter> offset = SkImageFilters::Offset(7.f, 0.f, shared);
+    sk_sp<SkImageFilter> root = SkImageFilters::Merge(shared, offset);
+
+    auto cache = sk_make_sp<RetentionRecordingCache>();
+    SkIRect outSubset;
+    SkIPoint outOffset;
+    sk_sp<SkImage> result = as_IFB(root)->makeImageWithFilter(
+            sk_make_sp<RecordingRasterBackend>(cache), src, src->bounds(), src->bounds(),
+            &outSubset, &outOffset);
+    REPORTER_ASSERT(reporter, result);
+
+    int sharedSets = 0;
+    for (const auto& [id, retention] : cache->fSets) {
+        const bool isShared = id == as_IFB(shared)->uniqueID();
+        sharedSets += isShared ? 1 : 0;
+        REPORTER_ASSERT(reporter,
+                        (retention == SkImageFilterCache::Retention::kLikelyReused) == isShared);
+    }
+    REPORTER_ASSERT(reporter, sharedSets > 0);
+    REPORTER_ASSERT(reporter, cache->fSets.size() > (size_t)sharedSets);
+}
+
+// SkGraphics reports on the global cache. This is serial so that no other test uses the cache.
+DEF_SERIAL_TEST(ImageFilterCache_GraphicsStats, reporter) {
+    auto cache = SkImageFilterCache::Get();
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(32, 32);
+    srcBM.eraseColor(SK_ColorRED);
+    sk_sp<SkImage> src = srcBM.asImage();
+    sk_sp<SkImageFilter> filter = SkImageFilters::Blur(2.f, 2.f, nullptr);
+
+    SkGraphics::ResetImageFilterCacheStats();
+    SkIRect outSubset;
+    SkIPoint outOffset;
+    for (int frame = 0; frame < 2; ++frame) {
+        SkGraphics::NotifyImageFilterCacheNewFrame();
+        REPORTER_ASSERT(reporter, SkImages::MakeWithFilter(src, filter.get(), src->bounds(),
+                                                           src->bounds(), &outSubset,
+                                                           &outOffset));
+    }
+
+    const SkGraphics::ImageFilterCacheStats stats = SkGraphics::GetImageFilterCacheStats();
+    REPORTER_ASSERT(reporter, stats.fMisses == 1);
+    REPORTER_ASSERT(reporter, stats.fInserts == 1);
+    REPORTER_ASSERT(reporter, stats.fHits == 1);
+    REPORTER_ASSERT(reporter, stats.fCrossFrameHits == 1);
+    REPORTER_ASSERT(reporter, stats.fEntryCount >= 1 && stats.fBytesUsed > 0);
+    REPORTER_ASSERT(reporter, stats.fByteLimit == cache->stats().fMaxBytes);
+
+    SkGraphics::ResetImageFilterCacheStats();
+    REPORTER_ASSERT(reporter, SkGraphics::GetImageFilterCacheStats().fHits == 0);
+}
 
 // Shared test code for both the raster and gpu-backed image cases
 static void test_image_backed(skiatest::Reporter* reporter,
@@ -14,6 +14,7 @@
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
@@ -22,6 +23,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkPoint3.h"
@@ -94,6 +96,9 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <utility>
 #include <limits>
 
@@ -1931,6 +1936,91 @@ DEF_TEST(ImageFilterMakeWithFilter, reporter) {
     test_make_with_filter(reporter, createRasterSurface, raster);
 }
 
+// Filters a 512x512 image, large enough that the per-pixel stages are split into bands, with and
+// without the executor, and checks that the results match. makeFilter is called for each
+// evaluation, so that nothing is served from the image filter cache.
+static void test_executor_matches_serial(skiatest::Reporter* reporter,
+                                         const std::function<sk_sp<SkImageFilter>()>& makeFilter,
+                                         SkExecutor* executor) {
+    auto surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(512, 512));
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 16; ++i) {
+        paint.setColor(SkColorSetARGB(255 - 8 * i, 16 * i, 255 - 16 * i, 64 + 8 * i));
+        canvas->drawCircle(32.f * i + 16.f, 256.f + 128.f * SkScalarSin(i * 0.5f), 40.f, paint);
+    }
+    sk_sp<SkImage> src = surface->makeImageSnapshot();
+    const SkIRect subset = src->bounds();
+
+    SkIRect serialSubset, parallelSubset;
+    SkIPoint serialOffset, parallelOffset;
+    sk_sp<SkImage> serial = SkImages::MakeWithFilter(
+            src, makeFilter().get(), subset, subset, &serialSubset, &serialOffset);
+    sk_sp<SkImage> parallel = SkImages::MakeWithFilter(
+            src, makeFilter().get(), subset, subset, &parallelSubset, &parallelOffset,
+            executor);
+
+    REPORTER_ASSERT(reporter, serial && parallel);
+    if (!serial || !parallel) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, serialSubset == parallelSubset);
+    REPORTER_ASSERT(reporter, serialOffset == parallelOffset);
+
+    SkPixmap serialPixels, parallelPixels, serialResult, parallelResult;
+    REPORTER_ASSERT(reporter, serial->peekPixels(&serialPixels) &&
+                              serialPixels.extractSubset(&serialResult, serialSubset));
+    REPORTER_ASSERT(reporter, parallel->peekPixels(&parallelPixels) &&
+                              parallelPixels.extractSubset(&parallelResult, parallelSubset));
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(serialResult, parallelResult));
+}
+
+DEF_TEST(ImageFilterMakeWithFilter_Executor, reporter) {
+    // Builds a DAG with independent branches feeding merge and blend nodes, and per-pixel
+    // lighting and displacement stages.
+    auto makeFilter = []() {
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(3.f, 3.f, nullptr);
+        sk_sp<SkImageFilter> lit = SkImageFilters::DistantLitDiffuse(
+                {1.f, 1.f, 1.f}, SK_ColorWHITE, 2.f, 1.f, blur);
+        sk_sp<SkImageFilter> displaced = SkImageFilters::DisplacementMap(
+                SkColorChannel::kR, SkColorChannel::kG, 12.f, lit, nullptr);
+        sk_sp<SkImageFilter> dilated = SkImageFilters::Dilate(2, 2, nullptr);
+        sk_sp<SkImageFilter> blended = SkImageFilters::Arithmetic(
+                0.f, 0.5f, 0.5f, 0.f, true, displaced, dilated);
+        return SkImageFilters::Merge(blended, SkImageFilters::Offset(5.f, 5.f, lit));
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    test_executor_matches_serial(reporter, makeFilter, executor.get());
+}
+
+// Branches that are themselves merges of per-pixel stages would split their work again if they
+// ran on the executor. With a pool whose waiting threads can't borrow work, that would leave
+// every thread waiting on queued work that none of them can run.
+DEF_TEST(ImageFilterMakeWithFilter_NestedExecutor, reporter) {
+    auto makeFilter = []() {
+        auto branch = [](float lightZ) {
+            sk_sp<SkImageFilter> lit = SkImageFilters::DistantLitDiffuse(
+                    {1.f, 1.f, lightZ}, SK_ColorWHITE, 2.f, 1.f, nullptr);
+            sk_sp<SkImageFilter> spec = SkImageFilters::DistantLitSpecular(
+                    {1.f, -1.f, lightZ}, SK_ColorWHITE, 1.f, 1.f, 4.f, nullptr);
+            return SkImageFilters::Merge(
+                    SkImageFilters::Arithmetic(0.f, 0.5f, 0.5f, 0.f, true, lit, spec),
+                    SkImageFilters::Blend(SkBlendMode::kScreen, spec, lit));
+        };
+        sk_sp<SkImageFilter> branches[] = {branch(1.f), branch(2.f), branch(3.f)};
+        return SkImageFilters::Merge(branches, std::size(branches));
+    };
+
+    for (int threads : {1, 2}) {
+        std::unique_ptr<SkExecutor> executor =
+                SkExecutor::MakeFIFOThreadPool(threads, /*allowBorrowing=*/false);
+        test_executor_matches_serial(reporter, makeFilter, executor.get());
+    }
+}
+
 #if defined(SK_GANESH)
 DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(ImageFilterMakeWithFilter_Ganesh,
                                        reporter,
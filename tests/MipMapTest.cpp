@@ -10,6 +10,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
@@ -27,6 +28,10 @@
 #include "tests/Test.h"
 #include "tools/DecodeUtils.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
 static void make_bitmap(SkBitmap* bm, int width, int height) {
     bm->allocN32Pixels(width, height);
     bm->eraseColor(SK_ColorWHITE);
@@ -235,6 +240,200 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+// Fills 'rect' of pm with random bytes, keeping F16 values finite and in [0, 1).
+static void randomize_pixels(const SkPixmap& pm, const SkIRect& rect, SkRandom* rand) {
+    const int bpp = pm.info().bytesPerPixel();
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        uint8_t* row = (uint8_t*)pm.writable_addr(rect.fLeft, y);
+        for (int i = 0; i < rect.width() * bpp; i += 2) {
+            uint16_t v = (uint16_t)rand->nextU();
+            if (pm.colorType() == kRGBA_F16_SkColorType) {
+                v &= 0x37FF;
+            }
+            memcpy(row + i, &v, std::min(2, rect.width() * bpp - i));
+        }
+    }
+}
+
+static bool levels_match(const SkMipmap& a, const SkMipmap& b, int index) {
+    SkMipmap::Level la, lb;
+    if (!a.getLevel(index, &la) || !b.getLevel(index, &lb) ||
+        la.fPixmap.dimensions() != lb.fPixmap.dimensions()) {
+        return false;
+    }
+    for (int y = 0; y < la.fPixmap.height(); ++y) {
+        if (memcmp(la.fPixmap.addr(0, y), lb.fPixmap.addr(0, y), la.fPixmap.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Building levels in bands of rows on an executor gives the same pixels as building them whole.
+DEF_TEST(MipMap_BuildInBands, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom rand;
+
+    for (SkColorType ct : {kRGBA_8888_SkColorType, kRGB_565_SkColorType, kAlpha_8_SkColorType,
+                           kRGBA_1010102_SkColorType, kR16G16_unorm_SkColorType,
+                           kRGBA_F16_SkColorType}) {
+        for (SkISize size : {SkISize{1024, 1024}, SkISize{1031, 777}, SkISize{2000, 3}}) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            randomize_pixels(bm.pixmap(), bm.bounds(), &rand);
+
+            sk_sp<SkMipmap> whole(SkMipmap::Build(bm, nullptr));
+            sk_sp<SkMipmap> banded(SkMipmap::Build(bm, nullptr, executor.get()));
+            REPORTER_ASSERT(reporter, whole && banded);
+            if (!whole || !banded) {
+                continue;
+            }
+            for (int i = 0; i < whole->countLevels(); ++i) {
+                REPORTER_ASSERT(reporter, levels_match(*whole, *banded, i),
+                                "ct %d size %dx%d level %d", ct, size.width(), size.height(), i);
+            }
+        }
+    }
+}
+
+// Rebuilding the footprint of a dirty rect gives the same levels as building from scratch.
+DEF_TEST(MipMap_RebuildRegion, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom rand;
+
+    for (SkColorType ct : {kRGBA_8888_SkColorType, kRGB_565_SkColorType, kAlpha_8_SkColorType,
+                           kRGBA_F16_SkColorType}) {
+        for (SkISize size : {SkISize{256, 256}, SkISize{257, 131}, SkISize{1, 77},
+                             SkISize{93, 1}, SkISize{1030, 1025}}) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            randomize_pixels(bm.pixmap(), bm.bounds(), &rand);
+            sk_sp<SkMipmap> mm(SkMipmap::Build(bm, nullptr));
+            REPORTER_ASSERT(reporter, mm);
+            if (!mm) {
+                continue;
+            }
+
+            const SkIRect dirtyRects[] = {
+                SkIRect::MakeXYWH(0, 0, 1, 1),
+                SkIRect::MakeXYWH(size.width() / 3, size.height() / 3, 5, 3),
+                SkIRect::MakeLTRB(size.width() - 1, size.height() - 1, size.width(), size.height()),
+                SkIRect::MakeXYWH(size.width() / 2, size.height() / 2, 1000, 1000),  // clipped
+                SkIRect::MakeWH(size.width(), size.height()),
+            };
+            for (const SkIRect& dirty : dirtyRects) {
+                SkIRect changed = dirty;
+                SkAssertResult(changed.intersect(bm.bounds()));
+                randomize_pixels(bm.pixmap(), changed, &rand);
+
+                // Alternate between building on this thread and in bands on the executor.
+                const bool parallel = rand.nextBool();
+                REPORTER_ASSERT(reporter,
+                                mm->rebuildRegion(bm.pixmap(), dirty,
+                                                  parallel ? executor.get() : nullptr));
+
+                sk_sp<SkMipmap> expected(SkMipmap::Build(bm, nullptr));
+                for (int i = 0; i < mm->countLevels(); ++i) {
+                    REPORTER_ASSERT(reporter, levels_match(*mm, *expected, i),
+                                    "ct %d size %dx%d dirty [%d %d %d %d] level %d", ct,
+                                    size.width(), size.height(), dirty.fLeft, dirty.fTop,
+                                    dirty.fRight, dirty.fBottom, i);
+                }
+            }
+        }
+    }
+
+    // The base must match the levels.
+    SkBitmap bm, other;
+    bm.allocN32Pixels(64, 64);
+    other.allocN32Pixels(64, 66);
+    bm.eraseColor(SK_ColorRED);
+    other.eraseColor(SK_ColorRED);
+    SkMipmapBuilder builder(bm.info());
+    REPORTER_ASSERT(reporter, builder.rebuildRegion(bm.pixmap(), SkIRect::MakeWH(8, 8)));
+    REPORTER_ASSERT(reporter, !builder.rebuildRegion(other.pixmap(), SkIRect::MakeWH(8, 8)));
+}
+
+// Checks the first level of 8888 mipmaps, whose filters are vectorized, against the definition:
+// a 2-tap box filter along even dimensions and a 1-2-1 triangle filter along odd ones.
+DEF_TEST(MipMap_8888MatchesReference, reporter) {
+    SkRandom rand;
+    for (SkISize size : {SkISize{64, 64}, SkISize{67, 64}, SkISize{64, 67}, SkISize{67, 67},
+                         SkISize{67, 1}, SkISize{66, 1}, SkISize{1, 67}, SkISize{1, 66}}) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(size, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+        for (int y = 0; y < size.height(); ++y) {
+            for (int x = 0; x < size.width(); ++x) {
+                *bm.getAddr32(x, y) = rand.nextU();
+            }
+        }
+        sk_sp<SkMipmap> mm(SkMipmap::Build(bm, nullptr));
+        SkMipmap::Level level;
+        REPORTER_ASSERT(reporter, mm && mm->getLevel(0, &level));
+        if (!mm) {
+            continue;
+        }
+
+        auto taps = [](int srcSize, const int** weights) {
+            static const int kOne[] = {1}, kBox[] = {1, 1}, kTriangle[] = {1, 2, 1};
+            if (srcSize == 1) {
+                *weights = kOne;
+                return 1;
+            }
+            *weights = srcSize & 1 ? kTriangle : kBox;
+            return srcSize & 1 ? 3 : 2;
+        };
+        const int *wx, *wy;
+        const int tapsX = taps(size.width(), &wx);
+        const int tapsY = taps(size.height(), &wy);
+        const int shift = (tapsX - 1) + (tapsY - 1);
+
+        bool matches = true;
+        for (int y = 0; y < level.fPixmap.height(); ++y) {
+            for (int x = 0; x < level.fPixmap.width(); ++x) {
+                uint32_t expected = 0;
+                for (int c = 0; c < 4; ++c) {
+                    int sum = 0;
+                    for (int j = 0; j < tapsY; ++j) {
+                        for (int i = 0; i < tapsX; ++i) {
+                            const int sx = size.width() == 1 ? 0 : 2 * x + i;
+                            const int sy = size.height() == 1 ? 0 : 2 * y + j;
+                            sum += wx[i] * wy[j] * ((*bm.getAddr32(sx, sy) >> (8 * c)) & 0xFF);
+                        }
+                    }
+                    expected |= (uint32_t)(sum >> shift) << (8 * c);
+                }
+                matches &= *level.fPixmap.addr32(x, y) == expected;
+            }
+        }
+        REPORTER_ASSERT(reporter, matches, "size %dx%d", size.width(), size.height());
+    }
+}
+
+// The green channel of R16G16 and the alpha of 1010102 survive the 3x3 filter.
+DEF_TEST(MipMap_WideChannels, reporter) {
+    auto first_pixel_of_level = [&](SkColorType ct, uint32_t pixel) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(3, 3, ct, kPremul_SkAlphaType));
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 3; ++x) {
+                *bm.getAddr32(x, y) = pixel;
+            }
+        }
+        sk_sp<SkMipmap> mm(SkMipmap::Build(bm, nullptr));
+        SkMipmap::Level level;
+        if (!mm || !mm->getLevel(0, &level)) {
+            return 0u;
+        }
+        return *level.fPixmap.addr32(0, 0);
+    };
+
+    REPORTER_ASSERT(reporter,
+                    first_pixel_of_level(kR16G16_unorm_SkColorType, 0x40008000) == 0x40008000);
+    REPORTER_ASSERT(reporter,
+                    first_pixel_of_level(kRGBA_1010102_SkColorType, 0xC0100401) == 0xC0100401);
+}
+
 static void fill_in_mips(SkMipmapBuilder* builder, sk_sp<SkImage> img) {
     int count = builder->countLevels();
     for (int i = 0; i < count; ++i) {
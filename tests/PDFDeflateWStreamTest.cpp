@@ -8,6 +8,7 @@
 #include "include/core/SkTypes.h"
 
 #ifdef SK_SUPPORT_PDF
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/private/SkDebug.h"
@@ -21,6 +22,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
 #include <zlib.h>
@@ -177,4 +179,50 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+// Whole-buffer compression must round trip at every level, including the empty and highly
+// compressible inputs that stress the output bound. SkPDF streams switch between it and
+// SkDeflateWStream by size, so both must decode to the same bytes at the same size.
+DEF_TEST(SkPDF_DeflateCompress, r) {
+    SkRandom random(654321);
+    for (int level : {-1, 1, 6, 9}) {
+        for (uint32_t size : {0u, 1u, 100u, 4096u, 4097u, 70000u, 1u << 20}) {
+            AutoTMalloc<uint8_t> buffer(size);
+            const bool compressible = random.nextBool();
+            for (uint32_t j = 0; j < size; ++j) {
+                buffer[j] = compressible ? (j / 64) & 0xff : random.nextU() & 0xff;
+            }
+            sk_sp<SkData> compressed = SkDeflateCompress(buffer.get(), size, level);
+            if (!compressed) {
+                ERRORF(r, "Compression failed: level %d, size %u.", level, size);
+                continue;
+            }
+            SkMemoryStream compressedStream(compressed);
+            std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, &compressedStream));
+            if (!decompressed || decompressed->getLength() != size) {
+                ERRORF(r, "Decompression failed: level %d, size %u.", level, size);
+                continue;
+            }
+            sk_sp<SkData> data = SkData::MakeFromStream(decompressed.get(), size);
+            REPORTER_ASSERT(r, data && (size == 0 || 0 == memcmp(data->data(), buffer.get(), size)),
+                            "level %d, size %u", level, size);
+
+            SkDynamicMemoryWStream streamed;
+            {
+                SkDeflateWStream deflateWStream(&streamed, level);
+                deflateWStream.write(buffer.get(), size);
+            }
+            std::unique_ptr<SkStreamAsset> streamedAsset = streamed.detachAsStream();
+            const size_t streamedSize = streamedAsset->getLength();
+            std::unique_ptr<SkStreamAsset> inflated(stream_inflate(r, streamedAsset.get()));
+            sk_sp<SkData> streamedData =
+                    inflated ? SkData::MakeFromStream(inflated.get(), inflated->getLength())
+                             : nullptr;
+            REPORTER_ASSERT(r, streamedData && data && streamedData->equals(data.get()),
+                            "level %d, size %u", level, size);
+            REPORTER_ASSERT(r, streamedSize == compressed->size(), "level %d, size %u: %zu vs %zu",
+                            level, size, streamedSize, compressed->size());
+        }
+    }
+}
+
 #endif
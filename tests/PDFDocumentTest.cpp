@@ -8,6 +8,7 @@
 
 #ifdef SK_SUPPORT_PDF
 
+#include "include/core/SkAnnotation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
@@ -17,19 +18,28 @@
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
 #include "include/core/SkPaint.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/docs/SkPDFJpegHelpers.h"
+#include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/utils/SkOSPath.h"
 #include "tests/Test.h"
+#include "tools/Resources.h"
 #include "tools/fonts/FontToolUtils.h"
 
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
@@ -277,4 +287,267 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+static int count(const SkData& data, const char* needle) {
+    const size_t len = strlen(needle);
+    int n = 0;
+    for (size_t i = 0; i + len <= data.size(); ++i) {
+        if (0 == memcmp(data.bytes() + i, needle, len)) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+// In low memory mode each page object is written when the page ends, so what the document holds
+// for ended pages stays flat as pages are added, and the page tree built at close must still hold
+// every page.
+DEF_TEST(SkPDF_low_memory, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_low_memory, r);
+    constexpr int kPageCount = 100;
+    constexpr int kCheckAfterPage = 20;
+    SkFont font = ToolUtils::DefaultFont();
+    for (bool lowMemory : {false, true}) {
+        SkPDF::Metadata metadata = SkPDF::JPEG::MetadataWithCallbacks();
+        metadata.fLowMemory = lowMemory;
+        SkDynamicMemoryWStream stream;
+        SkPDFDocument doc(&stream, metadata);
+        size_t checkedBytes = 0;
+        for (int i = 0; i < kPageCount; ++i) {
+            doc.beginPage(612, 792)->drawString(SkStringPrintf("page %d", i), 36, 36, font,
+                                                SkPaint());
+            doc.endPage();
+            if (i + 1 == kCheckAfterPage) {
+                sk_sp<SkData> partial = SkData::MakeUninitialized(stream.bytesWritten());
+                stream.copyTo(partial->writable_data());
+                const int pages = count(*partial, "/Type /Page\n");
+                REPORTER_ASSERT(r, pages == (lowMemory ? kCheckAfterPage : 0), "%d", pages);
+                checkedBytes = doc.retainedPageBytes();
+            }
+        }
+        // Only page and object offsets are kept per page in low memory mode, while the default
+        // mode holds on to every page object.
+        const size_t bytesPerPage = (doc.retainedPageBytes() - checkedBytes) /
+                                    (kPageCount - kCheckAfterPage);
+        if (lowMemory) {
+            REPORTER_ASSERT(r, bytesPerPage <= 32, "%zu", bytesPerPage);
+        } else {
+            REPORTER_ASSERT(r, bytesPerPage >= 100, "%zu", bytesPerPage);
+        }
+        doc.close();
+        sk_sp<SkData> data = stream.detachAsData();
+        REPORTER_ASSERT(r, count(*data, "/Type /Page\n") == kPageCount);
+        REPORTER_ASSERT(r, count(*data, "/Count 100\n") == 1);
+    }
+}
+
+// Cached font subsets must embed exactly what subsetting from scratch does.
+DEF_TEST(SkPDF_font_subset_cache, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_font_subset_cache, r);
+    sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkFont font(std::move(typeface), 12);
+    auto makePDF = [&](bool cache, const char* text) {
+        SkPDF::Metadata metadata = SkPDF::JPEG::MetadataWithCallbacks();
+        metadata.fCacheFontSubsets = cache;
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        doc->beginPage(612, 792)->drawString(text, 36, 36, font, SkPaint());
+        doc->close();
+        return stream.detachAsData();
+    };
+    for (const char* text : {"Hello, World!", "Sphinx of black quartz", "Hello, World!"}) {
+        sk_sp<SkData> uncached = makePDF(false, text);
+        // The first cached document fills the cache and the second one reads from it.
+        for (int i = 0; i < 2; ++i) {
+            sk_sp<SkData> cached = makePDF(true, text);
+            REPORTER_ASSERT(r, cached->equals(uncached.get()), "'%s' pass %d", text, i);
+        }
+    }
+}
+
+static int gDeflateCallbackCalls = 0;
+
+// Per-kind compression levels and a client compressor that declines every stream.
+DEF_TEST(SkPDF_compression_levels, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_compression_levels, r);
+    SkFont font = ToolUtils::DefaultFont();
+    auto makePDF = [&](const SkPDF::Metadata& metadata) {
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        for (int i = 0; i < 40; ++i) {
+            canvas->drawString("The same line of text, over and over.", 36, 36 + 16 * i, font,
+                               SkPaint());
+        }
+        doc->close();
+        return stream.detachAsData();
+    };
+    SkPDF::Metadata metadata = SkPDF::JPEG::MetadataWithCallbacks();
+    sk_sp<SkData> defaults = makePDF(metadata);
+
+    metadata.fContentCompressionLevel = SkPDF::Metadata::CompressionLevel::None;
+    sk_sp<SkData> uncompressedContent = makePDF(metadata);
+    REPORTER_ASSERT(r, uncompressedContent->size() > defaults->size());
+
+    metadata.fContentCompressionLevel = SkPDF::Metadata::CompressionLevel::Default;
+    metadata.deflate = [](SkWStream*, SkSpan<const uint8_t>, int) {
+        ++gDeflateCallbackCalls;
+        return false;
+    };
+    gDeflateCallbackCalls = 0;
+    sk_sp<SkData> declined = makePDF(metadata);
+    REPORTER_ASSERT(r, gDeflateCallbackCalls > 0);
+    REPORTER_ASSERT(r, declined->equals(defaults.get()));
+}
+
+// Images reloaded from the same encoded data, or copied into new bitmaps, are distinct SkImages
+// and are only embedded once when de-duplicating by content.
+DEF_TEST(SkPDF_image_content_dedup, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_image_content_dedup, r);
+    sk_sp<SkData> encoded = GetResourceAsData("images/mandrill_128.png");
+    if (!encoded) {
+        return;
+    }
+    constexpr int kPages = 5;
+    auto makePDF = [&](bool dedup, SkPDF::Stats* stats) {
+        SkDynamicMemoryWStream stream;
+        SkPDF::Metadata metadata = SkPDF::JPEG::MetadataWithCallbacks();
+        metadata.fDeduplicateImageContent = dedup;
+        sk_sp<SkDocument> doc = SkPDF::MakeDocument(&stream, metadata);
+        for (int i = 0; i < kPages; ++i) {
+            SkCanvas* canvas = doc->beginPage(300, 300);
+            sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(encoded);
+            SkBitmap copy;
+            copy.allocPixels(image->imageInfo().makeColorType(kN32_SkColorType));
+            image->readPixels(nullptr, copy.pixmap(), 0, 0);
+            sk_sp<SkImage> copyImage = copy.asImage();
+            canvas->drawImage(image, 10, 10);
+            canvas->drawImage(copyImage, 10, 150);
+            doc->endPage();
+            // Content keys are digests, so the document does not hold on to the images.
+            REPORTER_ASSERT(r, image->unique());
+            REPORTER_ASSERT(r, copyImage->unique());
+        }
+        *stats = SkPDF::GetStats(doc.get());
+        doc->close();
+        return stream.bytesWritten();
+    };
+    SkPDF::Stats stats;
+    const size_t size = makePDF(false, &stats);
+    REPORTER_ASSERT(r, stats.fImageCount == 2 * kPages, "%d", stats.fImageCount);
+    REPORTER_ASSERT(r, stats.fImageContentDuplicateCount == 0);
+
+    const size_t dedupSize = makePDF(true, &stats);
+    REPORTER_ASSERT(r, stats.fImageCount == 2, "%d", stats.fImageCount);
+    REPORTER_ASSERT(r, stats.fImageContentDuplicateCount == 2 * (kPages - 1),
+                    "%d", stats.fImageContentDuplicateCount);
+    REPORTER_ASSERT(r, dedupSize < size, "%zu >= %zu", dedupSize, size);
+}
+
+// Images are counted wherever they are written, not only when drawn with drawImage().
+DEF_TEST(SkPDF_image_stats, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_image_stats, r);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    bitmap.eraseColor(SK_ColorBLUE);
+    bitmap.erase(SK_ColorRED, SkIRect::MakeXYWH(8, 8, 16, 16));
+
+    SkDynamicMemoryWStream stream;
+    SkPDF::Metadata metadata = SkPDF::JPEG::MetadataWithCallbacks();
+    sk_sp<SkDocument> doc = SkPDF::MakeDocument(&stream, metadata);
+    SkCanvas* canvas = doc->beginPage(300, 300);
+    SkPaint paint;
+    paint.setShader(bitmap.asImage()->makeShader(SkSamplingOptions()));
+    canvas->drawRect(SkRect::MakeWH(100, 100), paint);
+    doc->endPage();
+    const int shaderImages = SkPDF::GetStats(doc.get()).fImageCount;
+    REPORTER_ASSERT(r, shaderImages == 1, "%d", shaderImages);
+
+    canvas = doc->beginPage(300, 300);
+    canvas->drawImageNine(bitmap.asImage().get(), SkIRect::MakeXYWH(8, 8, 16, 16),
+                          SkRect::MakeWH(200, 200), SkFilterMode::kNearest);
+    doc->endPage();
+    const int nineImages = SkPDF::GetStats(doc.get()).fImageCount - shaderImages;
+    REPORTER_ASSERT(r, nineImages > 0, "%d", nineImages);
+    REPORTER_ASSERT(r, SkPDF::GetStats(doc.get()).fImageContentDuplicateCount == 0);
+    doc->close();
+}
+
+// SkPDF::DrawPictures must produce exactly what drawing the pages one at a time does, whether or
+// not it draws pages concurrently on an executor.
+DEF_TEST(SkPDF_DrawPictures, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_DrawPictures, r);
+    sk_sp<SkData> encoded = GetResourceAsData("images/mandrill_128.png");
+    if (!encoded) {
+        return;
+    }
+    SkFont font = ToolUtils::DefaultFont();
+    sk_sp<SkImage> shared = SkImages::DeferredFromEncodedData(encoded);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(64, 64));
+    canvas->drawString("nested", 4, 32, font, SkPaint());
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    std::vector<sk_sp<SkPicture>> pictures;
+    for (int i = 0; i < 24; ++i) {
+        // Offset some cull rects to check that pages are positioned the same way.
+        const SkRect bounds = SkRect::MakeXYWH(i % 3 * 10, 0, 300, 400);
+        canvas = recorder.beginRecording(bounds);
+        canvas->translate(bounds.left(), 0);
+        // Some images are shared by every page and some are new on each page.
+        canvas->drawImage(i % 2 ? shared : SkImages::DeferredFromEncodedData(encoded), 10, 10);
+        canvas->drawString(SkStringPrintf("page %d", i), 10, 200, font, SkPaint());
+        // Graphic states that pages share, and ones that only later pages add.
+        SkPaint paint;
+        paint.setAlphaf(1.0f / (1 + i % 5));
+        paint.setStroke(i % 4 == 0);
+        paint.setStrokeWidth(i / 4);
+        canvas->drawRect(SkRect::MakeXYWH(150, 10, 100, 100), paint);
+        paint.setShader(SkShaders::Color(SK_ColorBLUE));
+        canvas->drawCircle(200, 300, 20 + i, paint);
+        SkAnnotateRectWithURL(canvas, SkRect::MakeXYWH(10, 150, 100, 20),
+                              SkData::MakeWithCString("https://skia.org/").get());
+        SkAnnotateNamedDestination(canvas, {10, 10},
+                                   SkData::MakeWithCString(SkStringPrintf("p%d", i).c_str()).get());
+        canvas->translate(10, 250);
+        canvas->drawPicture(nested);
+        pictures.push_back(recorder.finishRecordingAsPicture());
+    }
+    // An empty picture adds no page.
+    recorder.beginRecording(SkRect::MakeEmpty());
+    pictures.insert(pictures.begin() + 5, recorder.finishRecordingAsPicture());
+
+    SkDynamicMemoryWStream expected;
+    {
+        auto doc = SkPDF::MakeDocument(&expected, SkPDF::JPEG::MetadataWithCallbacks());
+        for (const sk_sp<SkPicture>& picture : pictures) {
+            const SkRect cull = picture->cullRect();
+            if ((canvas = doc->beginPage(cull.width(), cull.height()))) {
+                canvas->translate(-cull.left(), -cull.top());
+                canvas->drawPicture(picture);
+                doc->endPage();
+            }
+        }
+        doc->close();
+    }
+    sk_sp<SkData> expectedData = expected.detachAsData();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    // Draw in parallel more than once, since which thread draws which page varies.
+    for (SkExecutor* e : {(SkExecutor*)nullptr, executor.get(), executor.get(), executor.get()}) {
+        SkDynamicMemoryWStream actual;
+        auto doc = SkPDF::MakeDocument(&actual, SkPDF::JPEG::MetadataWithCallbacks());
+        SkPDF::DrawPictures(doc.get(), pictures, e);
+        doc->close();
+        sk_sp<SkData> actualData = actual.detachAsData();
+        if (!actualData->equals(expectedData.get())) {
+            ERRORF(r, "DrawPictures (%s executor) output differs from drawing each page.",
+                   e ? "with" : "without");
+        }
+    }
+}
+
 #endif // SK_SUPPORT_PDF
@@ -20,6 +20,7 @@
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/docs/SkPDFJpegHelpers.h"
 #include "include/private/SkEncodedInfo.h"
@@ -30,6 +31,7 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 static bool is_subset_of(SkData* smaller, SkData* larger) {
     SkASSERT(smaller && larger);
@@ -106,9 +108,9 @@ DEF_TEST(SkPDF_JpegEmbedTest, r) {
     sk_sp<SkData> pdfData = pdf.detachAsData();
     SkASSERT(pdfData);
 
-    // This JPEG uses a nonstandard colorspace - it can not be
-    // embedded into the PDF directly.
-    REPORTER_ASSERT(r, !is_subset_of(cmykData.get(), pdfData.get()));
+    // CMYK JPEGs are embedded as is, with a Decode array to undo Adobe's inversion.
+    REPORTER_ASSERT(r, is_subset_of(cmykData.get(), pdfData.get()));
+    REPORTER_ASSERT(r, is_subset_of(cmykICCData.get(), pdfData.get()));
 
     // Part of this JPEG was drawn with drawImageRect.
     // However, the original data is smaller than the subset data so the original should be present.
@@ -122,6 +124,96 @@ DEF_TEST(SkPDF_JpegEmbedTest, r) {
     }
 }
 
+/**
+ *  Test that JPEGs with an EXIF orientation, and subsets that are most of a JPEG, are embedded
+ *  without re-encoding.
+ */
+DEF_TEST(SkPDF_JpegEmbedOrientedAndSubset, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_JpegEmbedOrientedAndSubset, r);
+    const char test[] = "SkPDF_JpegEmbedOrientedAndSubset";
+    sk_sp<SkData> mandrillData(load_resource(r, test, "images/mandrill_512_q075.jpg"));
+    if (!mandrillData) {
+        return;
+    }
+    std::vector<sk_sp<SkData>> orientedData;
+    for (int origin = kTopLeft_SkEncodedOrigin; origin <= kLast_SkEncodedOrigin; ++origin) {
+        SkString path = SkStringPrintf("images/orientation/%d_420.jpg", origin);
+        if (sk_sp<SkData> data = load_resource(r, test, path.c_str())) {
+            orientedData.push_back(std::move(data));
+        }
+    }
+
+    SkDynamicMemoryWStream pdf;
+    auto document = SkPDF::MakeDocument(&pdf, SkPDF::JPEG::MetadataWithCallbacks());
+    SkCanvas* canvas = document->beginPage(612, 792);
+    sk_sp<SkImage> mandrill = SkImages::DeferredFromEncodedData(mandrillData);
+    canvas->drawImageRect(mandrill, SkRect::MakeLTRB(0, 0, 512, 320), SkRect::MakeWH(256, 160),
+                          SkSamplingOptions(), nullptr, SkCanvas::kFast_SrcRectConstraint);
+    document->endPage();
+    for (const sk_sp<SkData>& data : orientedData) {
+        canvas = document->beginPage(612, 792);
+        canvas->drawImage(SkImages::DeferredFromEncodedData(data), 0, 0);
+        document->endPage();
+    }
+    document->close();
+    sk_sp<SkData> pdfData = pdf.detachAsData();
+
+    REPORTER_ASSERT(r, is_subset_of(mandrillData.get(), pdfData.get()));
+    for (const sk_sp<SkData>& data : orientedData) {
+        REPORTER_ASSERT(r, is_subset_of(data.get(), pdfData.get()));
+    }
+}
+
+/**
+ *  Test that a JPEG embedded with a non-default EXIF orientation is drawn upright: the form
+ *  XObject wrapping it must map the JPEG's stored rows and columns onto the displayed ones.
+ */
+DEF_TEST(SkPDF_JpegEmbedOrientationTransform, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_JpegEmbedOrientationTransform, r);
+    const char test[] = "SkPDF_JpegEmbedOrientationTransform";
+    // The transform from the image's unit square to the form's, in PDF's y-up space, that puts
+    // the stored image the right way up. E.g. for kRightTop (rotate 90 degrees clockwise to
+    // display), the stored top row becomes the displayed right column.
+    static constexpr struct {
+        SkEncodedOrigin fOrigin;
+        const char*     fTransform;
+    } kOrientations[] = {
+        {kTopRight_SkEncodedOrigin,    "-1 0 0 1 1 0 cm\n/X"},
+        {kBottomRight_SkEncodedOrigin, "-1 0 0 -1 1 1 cm\n/X"},
+        {kBottomLeft_SkEncodedOrigin,  "1 0 0 -1 0 1 cm\n/X"},
+        {kLeftTop_SkEncodedOrigin,     "0 -1 -1 0 1 1 cm\n/X"},
+        {kRightTop_SkEncodedOrigin,    "0 -1 1 0 0 1 cm\n/X"},
+        {kRightBottom_SkEncodedOrigin, "0 1 1 0 0 0 cm\n/X"},
+        {kLeftBottom_SkEncodedOrigin,  "0 1 -1 0 1 0 cm\n/X"},
+    };
+
+    for (const auto& orientation : kOrientations) {
+        SkString path = SkStringPrintf("images/orientation/%d_420.jpg", orientation.fOrigin);
+        sk_sp<SkData> data = load_resource(r, test, path.c_str());
+        if (!data) {
+            continue;
+        }
+        sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(data);
+        if (!image) {
+            ERRORF(r, "Could not decode %s", path.c_str());
+            continue;
+        }
+
+        SkDynamicMemoryWStream pdf;
+        auto document = SkPDF::MakeDocument(&pdf, SkPDF::JPEG::MetadataWithCallbacks());
+        document->beginPage(image->width(), image->height())->drawImage(image, 0, 0);
+        document->endPage();
+        document->close();
+        sk_sp<SkData> pdfData = pdf.detachAsData();
+
+        REPORTER_ASSERT(r, is_subset_of(data.get(), pdfData.get()), "%s", path.c_str());
+        sk_sp<SkData> transform = SkData::MakeWithoutCopy(orientation.fTransform,
+                                                          strlen(orientation.fTransform));
+        REPORTER_ASSERT(r, is_subset_of(transform.get(), pdfData.get()),
+                        "%s: expected \"%s\"", path.c_str(), orientation.fTransform);
+    }
+}
+
 struct SkJFIFInfo {
     SkISize fSize;
     enum Type {
@@ -18,6 +18,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -30,15 +31,21 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/private/SkAlign.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkRandom.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
+#include "tools/Resources.h"
+#include "tools/ToolUtils.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 class SkRRect;
@@ -924,3 +931,234 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_mapped, r) {
+    sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(
+            GetResourceAsData("images/mandrill_128.png"));
+    if (!image) {
+        ERRORF(r, "missing resource images/mandrill_128.png");
+        return;
+    }
+
+    SkPictureRecorder leafRecorder;
+    SkCanvas* leafCanvas = leafRecorder.beginRecording({0, 0, 64, 64});
+    leafCanvas->drawCircle(32, 32, 24, SkPaint(SkColors::kBlue));
+    leafCanvas->drawImage(image, 8, 8);
+    sk_sp<SkPicture> leaf = leafRecorder.finishRecordingAsPicture();
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording({0, 0, 256, 256});
+    canvas->drawColor(SK_ColorWHITE);
+    canvas->drawImageRect(image, {16, 16, 240, 240}, SkSamplingOptions(SkFilterMode::kLinear));
+    SkPath path = SkPathBuilder().moveTo(10, 200).lineTo(128, 20).lineTo(246, 200).close()
+                                 .detach();
+    SkPaint stroke(SkColors::kRed);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(3);
+    canvas->drawPath(path, stroke);
+    canvas->drawString("mapped", 20, 240, ToolUtils::DefaultPortableFont(), SkPaint());
+    canvas->translate(128, 128);
+    canvas->drawPicture(leaf);
+    canvas->drawPicture(leaf, nullptr, nullptr);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    sk_sp<SkData> classic = picture->serialize();
+    sk_sp<SkData> mappable = picture->serializeForMapping();
+    REPORTER_ASSERT(r, classic && mappable);
+    REPORTER_ASSERT(r, SkIsAlign4(mappable->size()));
+
+    // Records whether encoded images are handed to the proc in place.
+    struct ImageCtx {
+        const SkData* fMapped;
+        int           fInPlace = 0;
+    };
+    auto deserial_procs = [](ImageCtx* ctx) {
+        SkDeserialProcs procs;
+        procs.fImageDataProc = [](sk_sp<SkData> data, std::optional<SkAlphaType>, void* ctx) {
+            auto imageCtx = static_cast<ImageCtx*>(ctx);
+            const uint8_t* mapped = imageCtx->fMapped->bytes();
+            if (data->bytes() >= mapped && data->bytes() < mapped + imageCtx->fMapped->size()) {
+                imageCtx->fInPlace++;
+            }
+            return SkImages::DeferredFromEncodedData(std::move(data));
+        };
+        procs.fImageCtx = ctx;
+        return procs;
+    };
+
+    auto draw = [](const SkPicture* pic) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(256, 256);
+        SkCanvas canvas(bitmap);
+        canvas.drawPicture(pic);
+        return bitmap;
+    };
+    const SkBitmap expected = draw(picture.get());
+
+    ImageCtx mappedCtx{mappable.get()};
+    SkDeserialProcs mappedProcs = deserial_procs(&mappedCtx);
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(mappable, &mappedProcs);
+    REPORTER_ASSERT(r, mapped);
+    REPORTER_ASSERT(r, mappedCtx.fInPlace > 0);
+    REPORTER_ASSERT(r, mapped->approximateOpCount() == picture->approximateOpCount());
+    REPORTER_ASSERT(r, mapped->approximateOpCount(true) == picture->approximateOpCount(true));
+    REPORTER_ASSERT(r, mapped->cullRect() == picture->cullRect());
+    // The sub-picture and paints are materialized, so they count even though the ops are mapped.
+    REPORTER_ASSERT(r, mapped->approximateBytesUsed() > leaf->approximateBytesUsed());
+
+    // Mappable data can be read the usual way, and classic data can be read as if it were mapped.
+    ImageCtx copiedCtx{mappable.get()};
+    SkDeserialProcs copiedProcs = deserial_procs(&copiedCtx);
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(mappable.get(), &copiedProcs);
+    REPORTER_ASSERT(r, copied);
+    REPORTER_ASSERT(r, copiedCtx.fInPlace == 0);
+
+    ImageCtx fallbackCtx{classic.get()};
+    SkDeserialProcs fallbackProcs = deserial_procs(&fallbackCtx);
+    sk_sp<SkPicture> fallback = SkPicture::MakeFromMappedData(classic, &fallbackProcs);
+    REPORTER_ASSERT(r, fallback);
+    REPORTER_ASSERT(r, fallbackCtx.fInPlace == 0);
+
+    for (const SkPicture* pic : {mapped.get(), copied.get(), fallback.get()}) {
+        if (!pic) {
+            continue;
+        }
+        const SkBitmap actual = draw(pic);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.pixmap(), actual.pixmap()));
+    }
+
+    // A mapped picture serializes like any other.
+    sk_sp<SkData> reserialized = mapped->serializeForMapping();
+    ImageCtx reserializedCtx{reserialized.get()};
+    SkDeserialProcs reserializedProcs = deserial_procs(&reserializedCtx);
+    sk_sp<SkPicture> remapped = SkPicture::MakeFromMappedData(reserialized, &reserializedProcs);
+    REPORTER_ASSERT(r, remapped);
+    if (remapped) {
+        const SkBitmap actual = draw(remapped.get());
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.pixmap(), actual.pixmap()));
+    }
+
+    // Truncated data never produces a picture that reads past the end.
+    for (size_t size : {mappable->size() / 2, mappable->size() - 4}) {
+        sk_sp<const SkData> truncated = mappable->shareSubset(0, size);
+        REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(truncated, &mappedProcs));
+    }
+}
+
+DEF_TEST(Picture_chunked, r) {
+    sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(
+            GetResourceAsData("images/mandrill_128.png"));
+    if (!image) {
+        ERRORF(r, "missing resource images/mandrill_128.png");
+        return;
+    }
+
+    // A 4x4 grid of 256x256 cells, each with an image that stays inside it, under a stroke
+    // that crosses them all.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording({0, 0, 1024, 1024});
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            SkRect cell = SkRect::MakeXYWH(x * 256, y * 256, 256, 256);
+            canvas->drawRect(cell.makeInset(8, 8), SkPaint(SkColor4f{x / 4.f, y / 4.f, 1, 1}));
+            canvas->drawImageRect(image, cell.makeInset(32, 32),
+                                  SkSamplingOptions(SkFilterMode::kLinear));
+        }
+    }
+    SkPaint stroke(SkColors::kRed);
+    stroke.setAntiAlias(true);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(5);
+    canvas->drawLine(0, 0, 1024, 1000, stroke);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    sk_sp<SkData> data = picture->serializeChunked(256);
+    REPORTER_ASSERT(r, data);
+
+    int decodedImages = 0;
+    SkDeserialProcs procs;
+    procs.fImageDataProc = [](sk_sp<SkData> data, std::optional<SkAlphaType>, void* ctx) {
+        (*static_cast<int*>(ctx))++;
+        return SkImages::DeferredFromEncodedData(std::move(data));
+    };
+    procs.fImageCtx = &decodedImages;
+
+    auto draw = [](const SkPicture* pic, const SkIRect& area) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(area.width(), area.height());
+        SkCanvas canvas(bitmap);
+        canvas.translate(-area.fLeft, -area.fTop);
+        canvas.drawPicture(pic);
+        return bitmap;
+    };
+
+    for (bool mapped : {true, false}) {
+        decodedImages = 0;
+        sk_sp<SkPicture> chunked = mapped ? SkPicture::MakeFromMappedData(data, &procs)
+                                          : SkPicture::MakeFromData(data.get(), &procs);
+        REPORTER_ASSERT(r, chunked);
+        if (!chunked) {
+            continue;
+        }
+        REPORTER_ASSERT(r, decodedImages == 0, "%d images decoded on load", decodedImages);
+        REPORTER_ASSERT(r, chunked->cullRect() == picture->cullRect());
+        REPORTER_ASSERT(r, chunked->approximateOpCount() == picture->approximateOpCount());
+
+        // A viewport inside one cell only decodes that cell's chunk.
+        const SkIRect viewport = SkIRect::MakeXYWH(300, 300, 200, 200);
+        SkBitmap expected = draw(picture.get(), viewport);
+        SkBitmap actual = draw(chunked.get(), viewport);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.pixmap(), actual.pixmap()));
+        REPORTER_ASSERT(r, decodedImages == 1, "%d images decoded", decodedImages);
+
+        // A viewport across cells matches too, and decodes each chunk once.
+        const SkIRect all = SkIRect::MakeWH(1024, 1024);
+        expected = draw(picture.get(), all);
+        actual = draw(chunked.get(), all);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.pixmap(), actual.pixmap()));
+        actual = draw(chunked.get(), all);
+        REPORTER_ASSERT(r, decodedImages == 16, "%d images decoded", decodedImages);
+    }
+
+    // Without a chunk size, there is one chunk.
+    sk_sp<SkData> single = picture->serializeChunked(0);
+    decodedImages = 0;
+    sk_sp<SkPicture> whole = SkPicture::MakeFromMappedData(single, &procs);
+    REPORTER_ASSERT(r, whole);
+    if (whole) {
+        const SkIRect viewport = SkIRect::MakeXYWH(0, 0, 16, 16);
+        SkBitmap expected = draw(picture.get(), viewport);
+        SkBitmap actual = draw(whole.get(), viewport);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.pixmap(), actual.pixmap()));
+        REPORTER_ASSERT(r, decodedImages == 16, "%d images decoded", decodedImages);
+    }
+
+    // Truncated data never produces a picture.
+    sk_sp<const SkData> truncated = data->shareSubset(0, data->size() - 4);
+    REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(truncated, &procs));
+
+    // Nor does a chunk that is not a picture, even though chunks are only decoded when drawn.
+    const uint8_t* magic = data->bytes();
+    const uint8_t* chunk = std::search(magic + 8, magic + data->size(), magic, magic + 8);
+    REPORTER_ASSERT(r, chunk != magic + data->size());
+    if (chunk != magic + data->size()) {
+        sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+        const size_t offset = chunk - magic;
+        static_cast<uint8_t*>(corrupt->writable_data())[offset] ^= 0xFF;
+        REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(corrupt, &procs));
+    }
+
+    // A chunk size far below the cull rect's precision is limited to 128 chunks a side.
+    SkPictureRecorder smallRecorder;
+    SkCanvas* smallCanvas = smallRecorder.beginRecording({1e6f, 0, 1e6f + 100, 100});
+    smallCanvas->drawRect({1e6f + 10, 10, 1e6f + 90, 90}, SkPaint(SkColors::kGreen));
+    sk_sp<SkPicture> small = smallRecorder.finishRecordingAsPicture();
+    sk_sp<SkPicture> tiny = SkPicture::MakeFromData(small->serializeChunked(1e-6f).get());
+    REPORTER_ASSERT(r, tiny);
+    if (tiny) {
+        const SkIRect area = SkIRect::MakeXYWH(1000000, 0, 100, 100);
+        SkBitmap expected = draw(small.get(), area);
+        SkBitmap actual = draw(tiny.get(), area);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.pixmap(), actual.pixmap()));
+    }
+}
@@ -6,12 +6,14 @@
  */
 
 #include "include/core/SkRect.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkRTree.h"
 #include "src/core/SkRandom.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <vector>
@@ -97,3 +99,64 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree_BulkLoad, reporter) {
+    SkRandom rand;
+    AutoTArray<SkRect> rects(NUM_RECTS);
+    for (auto bulkLoad : {SkRTree::BulkLoad::kSTR, SkRTree::BulkLoad::kHilbert}) {
+        for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+            for (int j = 0; j < NUM_RECTS; j++) {
+                rects[j] = random_rect(rand);
+            }
+
+            SkRTree rtree(bulkLoad);
+            rtree.insert(rects.data(), NUM_RECTS);
+
+            // Sorting the leaves must not change which rects are found, nor their order.
+            run_queries(reporter, rand, rects.data(), rtree);
+            REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+        }
+    }
+
+    // Rects that all share a center, which gives the Hilbert curve nothing to work with.
+    for (int j = 0; j < NUM_RECTS; j++) {
+        rects[j] = SkRect::MakeLTRB(-j - 1, -j - 1, j + 1, j + 1);
+    }
+    SkRTree rtree(SkRTree::BulkLoad::kHilbert);
+    rtree.insert(rects.data(), NUM_RECTS);
+    run_queries(reporter, rand, rects.data(), rtree);
+}
+
+DEF_TEST(RTree_SearchSpan, reporter) {
+    SkRandom rand;
+    AutoTArray<SkRect> rects(NUM_RECTS);
+    for (int j = 0; j < NUM_RECTS; j++) {
+        rects[j] = random_rect(rand);
+    }
+    for (auto bulkLoad : {SkRTree::BulkLoad::kInsertionOrder, SkRTree::BulkLoad::kSTR}) {
+        SkRTree rtree(bulkLoad);
+        rtree.insert(rects.data(), NUM_RECTS);
+
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            const SkRect query = random_rect(rand);
+            std::vector<int> expected;
+            rtree.search(query, &expected);
+
+            int storage[NUM_RECTS];
+            const size_t count = rtree.search(query, SkSpan(storage));
+            REPORTER_ASSERT(reporter, count == expected.size());
+            REPORTER_ASSERT(reporter, std::equal(expected.begin(), expected.end(), storage));
+
+            // A short span still reports how many hits there are, and never writes past its end.
+            if (count > 1) {
+                storage[count / 2] = -1;
+                REPORTER_ASSERT(reporter, rtree.search(query, SkSpan(storage, count / 2)) == count);
+                REPORTER_ASSERT(reporter, storage[count / 2] == -1);
+            }
+        }
+
+        // Empty queries hit nothing.
+        REPORTER_ASSERT(reporter, rtree.search(SkRect::MakeLTRB(500, 0, 500, 1000),
+                                               SkSpan<int>()) == 0);
+    }
+}
@@ -5,26 +5,36 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkAnnotation.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
+#include "src/core/SkCanvasPriv.h"
+#include "src/core/SkRandom.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordCanvas.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecords.h"
 #include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 #include <array>
 #include <cstddef>
@@ -426,3 +436,241 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+DEF_TEST(RecordOpts_CollapseClipRects, r) {
+    SkRecord record;
+    SkRecordCanvas recorder(&record, W, H);
+
+    recorder.clipRect(SkRect::MakeLTRB(0, 0, 100, 100));
+    recorder.clipRect(SkRect::MakeLTRB(50, 20, 150, 80));
+    recorder.clipRect(SkRect::MakeLTRB(60, 0, 200, 200));
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+    // Neither AA nor difference clips are folded.
+    recorder.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), true);
+    recorder.clipRect(SkRect::MakeLTRB(10, 10, 90, 90), true);
+    recorder.clipRect(SkRect::MakeLTRB(20, 20, 30, 30), SkClipOp::kDifference);
+    // Disjoint rects fold into an empty clip.
+    recorder.clipRect(SkRect::MakeLTRB(0, 0, 10, 10));
+    recorder.clipRect(SkRect::MakeLTRB(20, 20, 30, 30));
+
+    SkRecordCollapseClipRects(&record);
+
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    auto clip = assert_type<SkRecords::ClipRect>(r, record, 2);
+    REPORTER_ASSERT(r, clip->rect == SkRect::MakeLTRB(60, 20, 100, 80));
+    assert_type<SkRecords::ClipRect>(r, record, 4);
+    assert_type<SkRecords::ClipRect>(r, record, 5);
+    assert_type<SkRecords::ClipRect>(r, record, 6);
+    assert_type<SkRecords::NoOp>(r, record, 7);
+    clip = assert_type<SkRecords::ClipRect>(r, record, 8);
+    REPORTER_ASSERT(r, clip->rect.isEmpty());
+}
+
+DEF_TEST(RecordOpts_NoopOverwrittenMatrices, r) {
+    SkRecord record;
+    SkRecordCanvas recorder(&record, W, H);
+
+    recorder.translate(10, 10);
+    recorder.scale(2, 2);
+    recorder.setMatrix(SkMatrix::Translate(5, 5));
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+    recorder.translate(10, 10);
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+    recorder.setMatrix(SkMatrix::I());
+
+    SkRecordNoopOverwrittenMatrices(&record);
+
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::SetMatrix>(r, record, 2);
+    // The translate is used by the draw in between.
+    assert_type<SkRecords::Translate>(r, record, 4);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkPaint opaque;
+    opaque.setColor(SK_ColorBLUE);
+
+    {
+        SkRecord record;
+        SkRecordCanvas recorder(&record, W, H);
+
+        recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+        SkAnnotateRectWithURL(&recorder, SkRect::MakeWH(10, 10),
+                              SkData::MakeWithCString("https://skia.org").get());
+        recorder.save();
+            recorder.clipRect(SkRect::MakeWH(100, 100));
+            recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+        recorder.restore();
+        recorder.drawColor(SK_ColorWHITE);
+        recorder.drawPaint(opaque);
+        recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+
+        SkRecordNoopOccludedDraws(&record);
+
+        assert_type<SkRecords::NoOp>(r, record, 0);
+        assert_type<SkRecords::DrawAnnotation>(r, record, 1);
+        assert_type<SkRecords::NoOp>(r, record, 4);
+        assert_type<SkRecords::NoOp>(r, record, 6);
+        assert_type<SkRecords::DrawPaint>(r, record, 7);
+        assert_type<SkRecords::DrawRect>(r, record, 8);
+    }
+
+    // A DrawPaint that is clipped, inside a layer, or translucent doesn't occlude.
+    for (int variant = 0; variant < 3; variant++) {
+        SkRecord record;
+        SkRecordCanvas recorder(&record, W, H);
+
+        recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+        recorder.save();
+        switch (variant) {
+            case 0: recorder.clipRect(SkRect::MakeWH(100, 100));
+                    recorder.drawPaint(opaque);
+                    break;
+            case 1: recorder.saveLayer(nullptr, nullptr);
+                    recorder.drawPaint(opaque);
+                    recorder.restore();
+                    break;
+            case 2: recorder.drawColor(0x80FFFFFF);
+                    break;
+        }
+        recorder.restore();
+
+        SkRecordNoopOccludedDraws(&record);
+
+        assert_type<SkRecords::DrawRect>(r, record, 0);
+    }
+
+    // After ResetClip, draws can reach pixels outside the clip the picture is played back under,
+    // which a later DrawPaint doesn't cover.
+    {
+        SkRecord record;
+        SkRecordCanvas recorder(&record, W, H);
+
+        recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+        SkCanvasPriv::ResetClip(&recorder);
+        recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+        recorder.drawPaint(opaque);
+
+        SkRecordNoopOccludedDraws(&record);
+
+        assert_type<SkRecords::DrawRect>(r, record, 0);
+        assert_type<SkRecords::ResetClip>(r, record, 1);
+        assert_type<SkRecords::DrawRect>(r, record, 2);
+        assert_type<SkRecords::DrawPaint>(r, record, 3);
+    }
+}
+
+DEF_TEST(RecordOpts_MergeImageRects, r) {
+    sk_sp<SkImage> image = ToolUtils::create_checkerboard_image(32, 32, SK_ColorRED,
+                                                                SK_ColorGREEN, 4);
+    const SkSamplingOptions sampling(SkFilterMode::kLinear);
+    SkPaint aa;
+    aa.setAntiAlias(true);
+
+    SkRecord record;
+    SkRecordCanvas recorder(&record, W, H);
+
+    for (int i = 0; i < 3; i++) {
+        recorder.drawImageRect(image, SkRect::MakeWH(32, 32), SkRect::MakeXYWH(i * 32, 0, 32, 32),
+                               sampling, &aa, SkCanvas::kStrict_SrcRectConstraint);
+    }
+    // A different paint starts a new run, which is too short to merge.
+    recorder.drawImageRect(image, SkRect::MakeWH(32, 32), SkRect::MakeXYWH(0, 32, 32, 32),
+                           sampling, nullptr, SkCanvas::kStrict_SrcRectConstraint);
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+
+    SkRecordMergeImageRects(&record);
+
+    auto set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 0);
+    REPORTER_ASSERT(r, set->count == 3);
+    REPORTER_ASSERT(r, set->paint && *set->paint == aa);
+    REPORTER_ASSERT(r, set->sampling == sampling);
+    for (int i = 0; i < set->count; i++) {
+        REPORTER_ASSERT(r, set->set[i].fDstRect == SkRect::MakeXYWH(i * 32, 0, 32, 32));
+        REPORTER_ASSERT(r, set->set[i].fAAFlags == SkCanvas::kAll_QuadAAFlags);
+    }
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::DrawImageRect>(r, record, 3);
+}
+
+static SkBitmap draw_record(const SkRecord& record) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(256, 256);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bitmap);
+    SkRecordDraw(record, &canvas, nullptr, nullptr, 0, nullptr, nullptr);
+    return bitmap;
+}
+
+// The extended passes must not change what a record draws.
+DEF_TEST(RecordOpts_ExtendedPassesDrawIdentically, r) {
+    sk_sp<SkImage> image = ToolUtils::create_checkerboard_image(64, 64, SK_ColorRED,
+                                                                SK_ColorGREEN, 5);
+
+    auto scene = [&](SkCanvas* canvas, int variant) {
+        SkRandom rand(variant);
+        for (int i = 0; i < 20; i++) {
+            SkPaint paint;
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 200),
+                                              rand.nextRangeScalar(0, 200), 40, 40), paint);
+        }
+        if (variant & 1) {
+            canvas->drawColor(SK_ColorWHITE);
+        }
+
+        canvas->save();
+            canvas->scale(variant & 2 ? 1.25f : 1, 1);
+            canvas->clipRect(SkRect::MakeLTRB(10.3f, 5.5f, 240.6f, 230.4f));
+            canvas->clipRect(SkRect::MakeLTRB(0.7f, 20.5f, 220.2f, 250.5f));
+            canvas->translate(3, 3);
+            canvas->setMatrix(SkMatrix::Translate(rand.nextRangeScalar(0, 2), 1.5f));
+
+            SkPaint paint;
+            paint.setAntiAlias(variant & 4);
+            paint.setAlphaf(0.75f);
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    canvas->drawImageRect(image, SkRect::MakeXYWH(x * 10, y * 10, 30, 30),
+                                          SkRect::MakeXYWH(x * 50.5f, y * 50.5f, 50, 50),
+                                          SkSamplingOptions(SkFilterMode::kLinear), &paint,
+                                          SkCanvas::kStrict_SrcRectConstraint);
+                }
+            }
+        canvas->restore();
+    };
+
+    for (int variant = 0; variant < 8; variant++) {
+        SkRecord original, optimized;
+        SkRecordCanvas originalRecorder(&original, 256, 256),
+                       optimizedRecorder(&optimized, 256, 256);
+        scene(&originalRecorder, variant);
+        scene(&optimizedRecorder, variant);
+
+        SkRecordOptimize(&optimized, SkRecordExtendedOptimizationPasses());
+        REPORTER_ASSERT(r, optimized.count() < original.count());
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw_record(original),
+                                                   draw_record(optimized)),
+                        "variant %d", variant);
+    }
+}
+
+DEF_TEST(RecordOpts_RecorderExtendedOptimizations, r) {
+    auto record = [](SkPictureRecorder* recorder) {
+        SkCanvas* canvas = recorder->beginRecording(SkRect::MakeWH(W, H));
+        canvas->drawRect(SkRect::MakeWH(50, 50), SkPaint(SkColors::kRed));
+        canvas->drawColor(SK_ColorWHITE);
+        canvas->drawRect(SkRect::MakeWH(20, 20), SkPaint(SkColors::kBlue));
+        return recorder->finishRecordingAsPicture();
+    };
+
+    SkPictureRecorder recorder;
+    REPORTER_ASSERT(r, record(&recorder)->approximateOpCount() == 3);
+
+    // The occluded red rect is dropped, and the setting sticks across recordings.
+    recorder.setExtendedOptimizations(true);
+    REPORTER_ASSERT(r, record(&recorder)->approximateOpCount() == 2);
+    REPORTER_ASSERT(r, record(&recorder)->approximateOpCount() == 2);
+}
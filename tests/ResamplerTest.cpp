@@ -0,0 +1,211 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkTileMode.h"
+#include "include/core/SkTypes.h"
+#include "src/core/SkRandom.h"
+#include "src/core/SkResampler.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+static const SkResampler::Kernel kKernels[] = {
+    {SkResampler::Filter::kBox},
+    {SkResampler::Filter::kTriangle},
+    {SkResampler::Filter::kCubic, SkCubicResampler::Mitchell()},
+    {SkResampler::Filter::kCubic, SkCubicResampler::CatmullRom()},
+    {SkResampler::Filter::kLanczos3},
+};
+
+static SkBitmap make_noise(int w, int h, SkAlphaType at, uint32_t seed) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(w, h, kRGBA_8888_SkColorType, at));
+    SkRandom rand(seed);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const U8CPU a = at == kOpaque_SkAlphaType ? 0xFF : rand.nextULessThan(256);
+            U8CPU r = rand.nextULessThan(256),
+                  g = rand.nextULessThan(256),
+                  b = rand.nextULessThan(256);
+            if (at == kPremul_SkAlphaType) {
+                r = std::min(r, a);
+                g = std::min(g, a);
+                b = std::min(b, a);
+            }
+            *bm.getAddr32(x, y) = (a << 24) | (b << 16) | (g << 8) | r;
+        }
+    }
+    return bm;
+}
+
+static int max_channel_diff(const SkPixmap& a, const SkPixmap& b) {
+    int worst = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const uint32_t pa = *a.addr32(x, y),
+                           pb = *b.addr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                worst = std::max(worst, std::abs((int)((pa >> shift) & 0xFF) -
+                                                 (int)((pb >> shift) & 0xFF)));
+            }
+        }
+    }
+    return worst;
+}
+
+DEF_TEST(Resampler_FlatColor, r) {
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::Make(37, 23, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    src.eraseColor(SkColorSetARGB(0x80, 0x40, 0x20, 0x10));
+
+    for (const auto& kernel : kKernels) {
+        for (SkISize size : {SkISize{11, 7}, SkISize{100, 61}, SkISize{5, 40}}) {
+            SkBitmap dst;
+            dst.allocPixels(src.info().makeDimensions(size));
+            REPORTER_ASSERT(r, SkResampler::Scale(dst.pixmap(), src.pixmap(), kernel));
+            for (int y = 0; y < size.height(); ++y) {
+                for (int x = 0; x < size.width(); ++x) {
+                    REPORTER_ASSERT(r, *dst.getAddr32(x, y) == *src.getAddr32(0, 0),
+                                    "filter %d: %08x vs %08x", (int)kernel.fFilter,
+                                    *dst.getAddr32(x, y), *src.getAddr32(0, 0));
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Resampler_BoxAverages, r) {
+    SkBitmap src = make_noise(64, 48, kPremul_SkAlphaType, 1);
+    SkBitmap dst;
+    dst.allocPixels(src.info().makeWH(32, 24));
+    REPORTER_ASSERT(r, SkResampler::Scale(dst.pixmap(), src.pixmap(),
+                                          {SkResampler::Filter::kBox}));
+
+    for (int y = 0; y < dst.height(); ++y) {
+        for (int x = 0; x < dst.width(); ++x) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                int sum = 0;
+                for (int dy = 0; dy < 2; ++dy) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        sum += (*src.getAddr32(2*x + dx, 2*y + dy) >> shift) & 0xFF;
+                    }
+                }
+                const int got = (*dst.getAddr32(x, y) >> shift) & 0xFF;
+                REPORTER_ASSERT(r, std::abs(4*got - sum) <= 2, "(%d,%d) %d vs %d/4",
+                                x, y, got, sum);
+            }
+        }
+    }
+}
+
+DEF_TEST(Resampler_ExecutorMatchesSerial, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkBitmap src = make_noise(1031, 517, kPremul_SkAlphaType, 2);
+
+    for (const auto& kernel : kKernels) {
+        for (SkISize size : {SkISize{413, 389}, SkISize{1500, 700}}) {
+            SkBitmap serial, banded;
+            serial.allocPixels(src.info().makeDimensions(size));
+            banded.allocPixels(src.info().makeDimensions(size));
+            REPORTER_ASSERT(r, SkResampler::Scale(serial.pixmap(), src.pixmap(), kernel));
+            REPORTER_ASSERT(r, SkResampler::Scale(banded.pixmap(), src.pixmap(), kernel,
+                                                  executor.get()));
+            REPORTER_ASSERT(r, max_channel_diff(serial.pixmap(), banded.pixmap()) == 0);
+        }
+    }
+}
+
+// Premul results must stay premul, even though cubic and Lanczos filters ring.
+DEF_TEST(Resampler_PremulStaysValid, r) {
+    SkBitmap src = make_noise(97, 61, kPremul_SkAlphaType, 3);
+
+    for (const auto& kernel : kKernels) {
+        for (SkISize size : {SkISize{30, 20}, SkISize{250, 170}}) {
+            SkBitmap dst;
+            dst.allocPixels(src.info().makeDimensions(size));
+            REPORTER_ASSERT(r, SkResampler::Scale(dst.pixmap(), src.pixmap(), kernel));
+            for (int y = 0; y < size.height(); ++y) {
+                for (int x = 0; x < size.width(); ++x) {
+                    const uint32_t px = *dst.getAddr32(x, y);
+                    const uint32_t a = px >> 24;
+                    REPORTER_ASSERT(r, (px & 0xFF) <= a && ((px >> 8) & 0xFF) <= a &&
+                                       ((px >> 16) & 0xFF) <= a);
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Resampler_CanScale, r) {
+    auto pixmap = [](SkColorType ct, SkAlphaType at) {
+        return SkPixmap(SkImageInfo::Make(4, 4, ct, at), nullptr, 16);
+    };
+    const SkPixmap rgba     = pixmap(kRGBA_8888_SkColorType, kPremul_SkAlphaType),
+                   opaque   = pixmap(kRGBA_8888_SkColorType, kOpaque_SkAlphaType),
+                   unpremul = pixmap(kRGBA_8888_SkColorType, kUnpremul_SkAlphaType),
+                   bgra     = pixmap(kBGRA_8888_SkColorType, kPremul_SkAlphaType),
+                   f16      = pixmap(kRGBA_F16_SkColorType,  kPremul_SkAlphaType);
+
+    REPORTER_ASSERT(r,  SkResampler::CanScale(rgba, rgba));
+    REPORTER_ASSERT(r,  SkResampler::CanScale(bgra, bgra));
+    REPORTER_ASSERT(r,  SkResampler::CanScale(rgba, opaque));
+    REPORTER_ASSERT(r,  SkResampler::CanScale(unpremul, unpremul));
+    REPORTER_ASSERT(r, !SkResampler::CanScale(opaque, rgba));
+    REPORTER_ASSERT(r, !SkResampler::CanScale(rgba, unpremul));
+    REPORTER_ASSERT(r, !SkResampler::CanScale(bgra, rgba));
+    REPORTER_ASSERT(r, !SkResampler::CanScale(f16, f16));
+
+    REPORTER_ASSERT(r, !SkResampler::KernelFor(SkSamplingOptions()));
+    REPORTER_ASSERT(r, !SkResampler::KernelFor(SkSamplingOptions(SkFilterMode::kLinear)));
+    REPORTER_ASSERT(r, !SkResampler::KernelFor(SkSamplingOptions::Aniso(4)));
+    REPORTER_ASSERT(r,  SkResampler::KernelFor(SkSamplingOptions(SkFilterMode::kLinear,
+                                                                  SkMipmapMode::kNearest)));
+    REPORTER_ASSERT(r,  SkResampler::KernelFor(SkCubicResampler::Mitchell()));
+}
+
+// When upscaling, the resampler applies the same cubic as the image shader, so scalePixels()
+// should be nearly unchanged from when it always drew through the raster pipeline.
+DEF_TEST(Resampler_ScalePixelsMatchesShader, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkBitmap src = make_noise(40, 30, kPremul_SkAlphaType, 4);
+
+    for (SkCubicResampler cubic : {SkCubicResampler::Mitchell(), SkCubicResampler::CatmullRom()}) {
+        const SkSamplingOptions sampling(cubic);
+
+        SkBitmap scaled, drawn;
+        scaled.allocPixels(src.info().makeWH(120, 90));
+        drawn .allocPixels(src.info().makeWH(120, 90));
+        REPORTER_ASSERT(r, src.pixmap().scalePixels(scaled.pixmap(), sampling, executor.get()));
+
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+        const SkMatrix scale = SkMatrix::RectToRectOrIdentity(SkRect::Make(src.bounds()),
+                                                              SkRect::Make(drawn.bounds()));
+        paint.setShader(src.makeShader(SkTileMode::kClamp, SkTileMode::kClamp, sampling, scale));
+        SkCanvas(drawn).drawPaint(paint);
+
+        const int diff = max_channel_diff(scaled.pixmap(), drawn.pixmap());
+        REPORTER_ASSERT(r, diff <= 2, "B=%g C=%g: max diff %d", cubic.B, cubic.C, diff);
+    }
+}
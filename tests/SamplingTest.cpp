@@ -5,12 +5,19 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
 #include "src/core/SkRandom.h"
 #include "src/core/SkSamplingPriv.h"
@@ -18,6 +25,8 @@
 #include "tools/DecodeUtils.h"
 #include "tools/ToolUtils.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <initializer_list>
 
 // In general, sampling under identity matrix should not affect the pixels. However,
@@ -62,3 +71,69 @@ DEF_TEST(sampling_with_identity_matrix, r) {
         }
     }
 }
+
+// 8888 images are filtered by fused stages that tile integer texel coordinates themselves, in fixed
+// point when the rest of the pipeline is lowp. An F16 copy of the same image takes the generic
+// tiling and sampling stages, so the two should agree to within rounding for every tile mode.
+DEF_TEST(sampling_fused_8888_tiling, r) {
+    SkRandom rand;
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::MakeN32Premul(13, 10));
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    SkBitmap srcF16;
+    srcF16.allocPixels(src.info().makeColorType(kRGBA_F16_SkColorType));
+    SkAssertResult(src.readPixels(srcF16.pixmap()));
+    const sk_sp<SkImage> fused = src.asImage(),
+                         generic = srcF16.asImage();
+
+    auto surf = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(48, 48));
+    auto draw = [&](const sk_sp<SkImage>& img, SkTileMode tx, SkTileMode ty,
+                    const SkSamplingOptions& sampling) {
+        SkCanvas* canvas = surf->getCanvas();
+        canvas->clear(SK_ColorTRANSPARENT);
+        canvas->save();
+        canvas->translate(24, 24);
+        canvas->rotate(23);
+        canvas->scale(1.7f, 1.3f);
+        SkPaint paint;
+        paint.setShader(img->makeShader(tx, ty, sampling));
+        canvas->drawRect(SkRect::MakeLTRB(-20, -20, 20, 20), paint);
+        canvas->restore();
+
+        SkBitmap bm;
+        bm.allocPixels(surf->imageInfo());
+        SkAssertResult(surf->readPixels(bm.pixmap(), 0, 0));
+        return bm;
+    };
+
+    constexpr SkTileMode kModes[] = {SkTileMode::kClamp, SkTileMode::kRepeat,
+                                     SkTileMode::kMirror, SkTileMode::kDecal};
+    const SkSamplingOptions kSamplings[] = {SkSamplingOptions(SkFilterMode::kLinear),
+                                            SkSamplingOptions(SkCubicResampler::Mitchell()),
+                                            SkSamplingOptions(SkCubicResampler::CatmullRom())};
+    for (const SkSamplingOptions& sampling : kSamplings) {
+        for (SkTileMode tx : kModes) {
+            for (SkTileMode ty : kModes) {
+                SkBitmap a = draw(fused, tx, ty, sampling),
+                         b = draw(generic, tx, ty, sampling);
+                int maxDiff = 0;
+                for (int y = 0; y < a.height(); ++y) {
+                    for (int x = 0; x < a.width(); ++x) {
+                        uint32_t pa = *a.getAddr32(x, y),
+                                 pb = *b.getAddr32(x, y);
+                        for (int shift = 0; shift < 32; shift += 8) {
+                            maxDiff = std::max(maxDiff, std::abs((int)((pa >> shift) & 0xff) -
+                                                                 (int)((pb >> shift) & 0xff)));
+                        }
+                    }
+                }
+                REPORTER_ASSERT(r, maxDiff <= 2, "tile %d,%d cubic %d: max diff %d",
+                                (int)tx, (int)ty, sampling.useCubic, maxDiff);
+            }
+        }
+    }
+}
@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <memory>
 
 static void check_fill(skiatest::Reporter* r,
@@ -196,6 +197,44 @@ DEF_TEST(ReciprocalAlphaPortable, reporter) {
                           SK_OPTS_NS::reciprocal_alpha_portable);
 }
 
+DEF_TEST(SwizzleOpts16, r) {
+    // Odd counts exercise both the vectorized loops and the portable tails.
+    constexpr int kCount = 37;
+    uint8_t src[kCount * 8];
+    for (size_t i = 0; i < std::size(src); i++) {
+        src[i] = (uint8_t)(i * 53 + 7);
+    }
+
+    uint32_t dst[kCount], expected[kCount];
+    for (int count : {1, 4, 7, 8, 9, kCount}) {
+        SkOpts::RGB16_to_RGB1(dst, src, count);
+        SK_OPTS_NS::RGB16_to_RGB1_portable(expected, src, count);
+        REPORTER_ASSERT(r, !memcmp(dst, expected, count * sizeof(uint32_t)));
+
+        SkOpts::RGB16_to_BGR1(dst, src, count);
+        SK_OPTS_NS::RGB16_to_BGR1_portable(expected, src, count);
+        REPORTER_ASSERT(r, !memcmp(dst, expected, count * sizeof(uint32_t)));
+
+        SkOpts::RGBA16_to_RGBA(dst, src, count);
+        SK_OPTS_NS::RGBA16_to_RGBA_portable(expected, src, count);
+        REPORTER_ASSERT(r, !memcmp(dst, expected, count * sizeof(uint32_t)));
+
+        SkOpts::RGBA16_to_BGRA(dst, src, count);
+        SK_OPTS_NS::RGBA16_to_BGRA_portable(expected, src, count);
+        REPORTER_ASSERT(r, !memcmp(dst, expected, count * sizeof(uint32_t)));
+
+        SkOpts::RGBA16_to_rgbA(dst, src, count);
+        SK_OPTS_NS::RGBA16_to_RGBA_portable(expected, src, count);
+        SkOpts::RGBA_to_rgbA(expected, expected, count);
+        REPORTER_ASSERT(r, !memcmp(dst, expected, count * sizeof(uint32_t)));
+
+        SkOpts::RGBA16_to_bgrA(dst, src, count);
+        SK_OPTS_NS::RGBA16_to_RGBA_portable(expected, src, count);
+        SkOpts::RGBA_to_bgrA(expected, expected, count);
+        REPORTER_ASSERT(r, !memcmp(dst, expected, count * sizeof(uint32_t)));
+    }
+}
+
 // The stages of RasterPipeline unpremul calcExpected needs to simulate.
 // SI void from_8888(U32 _8888, F* r, F* g, F* b, F* a) {
 //     *r = cast((_8888      ) & 0xff) * (1/255.0f);
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradient.h"
+#include "include/utils/SkTiledPlayback.h"
+#include "src/core/SkRandom.h"
+#include "tests/Test.h"
+
+#include <cstring>
+#include <memory>
+
+static sk_sp<SkPicture> make_picture() {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(500, 400), &factory);
+    SkRandom random;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 200; ++i) {
+        const SkRect r = SkRect::MakeXYWH(random.nextRangeF(-20, 480), random.nextRangeF(-20, 380),
+                                          random.nextRangeF(5, 60), random.nextRangeF(5, 60));
+        paint.setColor(random.nextU() | 0xFF000000);
+        if (i % 3 == 0) {
+            canvas->drawOval(r, paint);
+        } else {
+            canvas->save();
+            canvas->rotate(random.nextRangeF(0, 90), r.centerX(), r.centerY());
+            canvas->drawRect(r, paint);
+            canvas->restore();
+        }
+    }
+    const SkPoint pts[] = {{0, 0}, {500, 400}};
+    const SkColor4f colors[] = {SkColors::kRed, SkColors::kBlue};
+    SkPaint gradient;
+    gradient.setShader(SkShaders::LinearGradient(pts, {{colors, {}, SkTileMode::kClamp}, {}}));
+    gradient.setAlphaf(0.5f);
+    canvas->drawCircle(250, 200, 150, gradient);
+    return recorder.finishRecordingAsPicture();
+}
+
+static bool equal_pixels(const SkPixmap& a, const SkPixmap& b) {
+    for (int y = 0; y < a.height(); ++y) {
+        if (0 != memcmp(a.addr(0, y), b.addr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tiled playback, serial or threaded, must match drawing the picture in one go.
+DEF_TEST(TiledPlayback, r) {
+    sk_sp<SkPicture> picture = make_picture();
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(500, 400);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (const SkMatrix& matrix : {SkMatrix::I(), SkMatrix::Scale(0.75f, 0.75f)}) {
+        sk_sp<SkSurface> expected = SkSurfaces::Raster(info);
+        expected->getCanvas()->clear(SK_ColorWHITE);
+        expected->getCanvas()->concat(matrix);
+        expected->getCanvas()->drawPicture(picture);
+        SkPixmap expectedPixels;
+        SkAssertResult(expected->peekPixels(&expectedPixels));
+
+        for (SkExecutor* exec : {(SkExecutor*)nullptr, executor.get()}) {
+            for (SkISize tileSize : {SkISize{64, 64}, SkISize{128, 32}, SkISize{512, 512}}) {
+                sk_sp<SkSurface> tiled = SkSurfaces::Raster(info);
+                tiled->getCanvas()->clear(SK_ColorWHITE);
+                SkTiledPlayback::Options options;
+                options.fTileSize = tileSize;
+                options.fExecutor = exec;
+                REPORTER_ASSERT(r, SkTiledPlayback::Draw(tiled.get(), picture.get(), matrix,
+                                                         options));
+                SkPixmap tiledPixels;
+                SkAssertResult(tiled->peekPixels(&tiledPixels));
+                REPORTER_ASSERT(r, equal_pixels(expectedPixels, tiledPixels),
+                                "tiles %dx%d, %s", tileSize.width(), tileSize.height(),
+                                exec ? "threaded" : "serial");
+            }
+        }
+    }
+}
+
+// Tiles must stay on the tile grid when the picture's bounds don't start on it, or dithering
+// would be out of phase with drawing the picture in one go.
+DEF_TEST(TiledPlayback_OffsetCullRect, r) {
+    const SkRect cull = SkRect::MakeXYWH(5, 3, 301, 203);
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(cull, &factory);
+    const SkPoint pts[] = {{cull.left(), 0}, {cull.right(), 0}};
+    const SkColor4f colors[] = {{0.2f, 0.3f, 0.4f, 1}, {0.25f, 0.32f, 0.45f, 1}};
+    SkPaint paint;
+    paint.setShader(SkShaders::LinearGradient(pts, {{colors, {}, SkTileMode::kClamp}, {}}));
+    paint.setDither(true);
+    canvas->drawRect(cull, paint);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(400, 300);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (const SkMatrix& matrix : {SkMatrix::I(), SkMatrix::Translate(9, 6)}) {
+        sk_sp<SkSurface> expected = SkSurfaces::Raster(info);
+        expected->getCanvas()->clear(SK_ColorWHITE);
+        expected->getCanvas()->drawPicture(picture, &matrix, nullptr);
+        SkPixmap expectedPixels;
+        SkAssertResult(expected->peekPixels(&expectedPixels));
+
+        for (SkExecutor* exec : {(SkExecutor*)nullptr, executor.get()}) {
+            for (SkISize tileSize : {SkISize{16, 16}, SkISize{64, 32}}) {
+                sk_sp<SkSurface> tiled = SkSurfaces::Raster(info);
+                tiled->getCanvas()->clear(SK_ColorWHITE);
+                SkTiledPlayback::Options options;
+                options.fTileSize = tileSize;
+                options.fExecutor = exec;
+                REPORTER_ASSERT(r, SkTiledPlayback::Draw(tiled.get(), picture.get(), matrix,
+                                                         options));
+                SkPixmap tiledPixels;
+                SkAssertResult(tiled->peekPixels(&tiledPixels));
+                REPORTER_ASSERT(r, equal_pixels(expectedPixels, tiledPixels),
+                                "tiles %dx%d, %s", tileSize.width(), tileSize.height(),
+                                exec ? "threaded" : "serial");
+            }
+        }
+    }
+}
+
+// Snapshots taken before a tiled draw must not see it.
+DEF_TEST(TiledPlayback_snapshot, r) {
+    sk_sp<SkPicture> picture = make_picture();
+    sk_sp<SkSurface> surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(500, 400));
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    sk_sp<SkImage> before = surface->makeImageSnapshot();
+    REPORTER_ASSERT(r, SkTiledPlayback::Draw(surface.get(), picture.get()));
+    SkPixmap pixels;
+    SkAssertResult(before->peekPixels(&pixels));
+    REPORTER_ASSERT(r, *pixels.addr32(250, 200) == SK_ColorWHITE);
+}
@@ -0,0 +1,322 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Generates thumbnails for a directory of images the way a thumbnailing service would: decode
+// with the largest SkAndroidCodec sample size that does not undershoot the target, scale the
+// rest of the way with SkPixmap::scalePixels, and encode. Files are processed in parallel while
+// keeping the memory in flight under a budget. Per-stage timings are written as JSON.
+
+#include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/encode/SkPngEncoder.h"
+#include "include/encode/SkWebpEncoder.h"
+#include "src/core/SkOSFile.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/core/SkTime.h"
+#include "src/utils/SkJSONWriter.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/flags/CommandLineFlags.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+static DEFINE_string2(src, s, "", "A directory of images, or a single image.");
+static DEFINE_string2(out, o, "", "Directory to write thumbnails to. If empty, they are "
+                                  "encoded but not written.");
+static DEFINE_string2(json, j, "", "Path to write per-file and total stage timings to as JSON. "
+                                   "If empty, only the totals are printed.");
+static DEFINE_string(format, "jpg", "Thumbnail format: jpg, png or webp.");
+static DEFINE_int(size, 256, "Maximum width and height of a thumbnail.");
+static DEFINE_int(quality, 80, "Quality for jpg and webp thumbnails.");
+static DEFINE_int(threads, 0, "Threads to process files on. 0 means one per core.");
+static DEFINE_int(memoryBudgetMB, 256,
+                  "Upper bound on encoded, decoded and scaled bytes held at once across all "
+                  "threads. A single file that needs more than this still runs, on its own.");
+static DEFINE_int(repeat, 1, "Process the whole input this many times, e.g. to warm caches.");
+
+namespace {
+
+enum Stage { kRead, kDecode, kScale, kEncode, kStageCount };
+
+constexpr const char* kStageNames[kStageCount] = { "read", "decode", "scale", "encode" };
+
+struct FileResult {
+    SkString fPath;
+    bool     fOk = false;
+    SkISize  fSrcSize = {0, 0};
+    SkISize  fDstSize = {0, 0};
+    int      fSampleSize = 1;
+    size_t   fEncodedBytes = 0;
+    double   fMs[kStageCount] = {};
+};
+
+// Blocks callers until the bytes they ask for fit in the budget. A request larger than the whole
+// budget is admitted once nothing else is in flight, so that no file is starved.
+class MemoryBudget {
+public:
+    explicit MemoryBudget(size_t bytes) : fBudget(bytes) {}
+
+    void acquire(size_t bytes) {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fCond.wait(lock, [&] { return fInUse == 0 || fInUse + bytes <= fBudget; });
+        fInUse += bytes;
+    }
+
+    void release(size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            SkASSERT(fInUse >= bytes);
+            fInUse -= bytes;
+        }
+        fCond.notify_all();
+    }
+
+private:
+    const size_t            fBudget;
+    size_t                  fInUse = 0;
+    std::mutex              fMutex;
+    std::condition_variable fCond;
+};
+
+// Fits src inside a size x size square, preserving its aspect ratio.
+SkISize thumbnail_size(SkISize src, int size) {
+    if (src.width() <= size && src.height() <= size) {
+        return src;
+    }
+    const double scale = std::min((double)size / src.width(), (double)size / src.height());
+    return {std::max(1, (int)(src.width() * scale + 0.5)),
+            std::max(1, (int)(src.height() * scale + 0.5))};
+}
+
+sk_sp<SkData> encode(const SkPixmap& pixmap) {
+    if (0 == strcmp(FLAGS_format[0], "png")) {
+        return SkPngEncoder::Encode(pixmap, {});
+    }
+    if (0 == strcmp(FLAGS_format[0], "webp")) {
+        SkWebpEncoder::Options options;
+        options.fQuality = FLAGS_quality;
+        return SkWebpEncoder::Encode(pixmap, options);
+    }
+    SkJpegEncoder::Options options;
+    options.fQuality = FLAGS_quality;
+    return SkJpegEncoder::Encode(pixmap, options);
+}
+
+void make_thumbnail(const SkString& path, bool write, MemoryBudget* budget, FileResult* result) {
+    result->fPath = path;
+
+    // Parse only the header to size this file's reservation, so that the encoded bytes are read
+    // after the budget admits them, along with the pixels they decode to.
+    double start = SkTime::GetMSecs();
+    auto header = std::make_unique<SkFILEStream>(path.c_str());
+    const size_t fileBytes = header->isValid() ? header->getLength() : 0;
+    std::unique_ptr<SkAndroidCodec> codec =
+            fileBytes ? SkAndroidCodec::MakeFromStream(std::move(header)) : nullptr;
+    double end = SkTime::GetMSecs();
+    result->fMs[kRead] = end - start;
+    if (!codec) {
+        return;
+    }
+
+    result->fSrcSize = codec->getInfo().dimensions();
+    result->fDstSize = thumbnail_size(result->fSrcSize, FLAGS_size);
+    SkISize sampledSize = result->fDstSize;
+    result->fSampleSize = codec->computeSampleSize(&sampledSize);
+
+    const SkImageInfo sampledInfo = codec->getInfo().makeDimensions(sampledSize)
+                                                    .makeColorType(kN32_SkColorType)
+                                                    .makeAlphaType(kPremul_SkAlphaType);
+    const SkImageInfo dstInfo = sampledInfo.makeDimensions(result->fDstSize);
+    const size_t bytes =
+            fileBytes + sampledInfo.computeMinByteSize() + dstInfo.computeMinByteSize();
+    codec = nullptr;
+    budget->acquire(bytes);
+
+    // Read the whole file into memory, rather than mapping it, so that the I/O is billed to this
+    // stage instead of to the page faults taken while decoding.
+    start = SkTime::GetMSecs();
+    sk_sp<SkData> data;
+    SkFILEStream stream(path.c_str());
+    if (stream.isValid() && stream.getLength() == fileBytes) {
+        data = SkData::MakeFromStream(&stream, fileBytes);
+    }
+    codec = data ? SkAndroidCodec::MakeFromData(data) : nullptr;
+    end = SkTime::GetMSecs();
+    result->fMs[kRead] += end - start;
+    if (!codec || codec->getInfo().dimensions() != result->fSrcSize) {
+        budget->release(bytes);
+        return;
+    }
+
+    start = end = SkTime::GetMSecs();
+    SkBitmap sampled;
+    if (sampled.tryAllocPixels(sampledInfo)) {
+        SkAndroidCodec::AndroidOptions options;
+        options.fSampleSize = result->fSampleSize;
+        const SkCodec::Result decodeResult = codec->getAndroidPixels(
+                sampledInfo, sampled.getPixels(), sampled.rowBytes(), &options);
+        end = SkTime::GetMSecs();
+        result->fMs[kDecode] = end - start;
+
+        if (decodeResult == SkCodec::kSuccess || decodeResult == SkCodec::kIncompleteInput) {
+            SkBitmap thumbnail;
+            bool scaled = true;
+            start = end;
+            if (sampledSize == result->fDstSize) {
+                thumbnail = sampled;
+            } else {
+                // Scale the pixmap directly: sampled.asImage() would copy the mutable bitmap,
+                // outside of the budget and inside of this stage's timing.
+                scaled = thumbnail.tryAllocPixels(dstInfo) &&
+                         sampled.pixmap().scalePixels(
+                                 thumbnail.pixmap(),
+                                 SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kLinear));
+            }
+            end = SkTime::GetMSecs();
+            result->fMs[kScale] = end - start;
+
+            if (scaled) {
+                start = end;
+                sk_sp<SkData> encoded = encode(thumbnail.pixmap());
+                end = SkTime::GetMSecs();
+                result->fMs[kEncode] = end - start;
+
+                if (encoded) {
+                    result->fEncodedBytes = encoded->size();
+                    result->fOk = true;
+                    if (write && !FLAGS_out.isEmpty()) {
+                        SkString name = SkOSPath::Basename(path.c_str());
+                        name.appendf(".%s", FLAGS_format[0]);
+                        SkString outPath = SkOSPath::Join(FLAGS_out[0], name.c_str());
+                        SkFILEWStream out(outPath.c_str());
+                        result->fOk = out.isValid() && out.write(encoded->data(), encoded->size());
+                    }
+                }
+            }
+        }
+    }
+
+    budget->release(bytes);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    CommandLineFlags::SetUsage(
+            "Usage: batch_thumbnails -s <dir of images> [-o <output dir>] [-j <timings.json>] "
+            "[--size 256] [--format jpg|png|webp] [--threads N] [--memoryBudgetMB 256]\n");
+    CommandLineFlags::Parse(argc, argv);
+
+    if (FLAGS_src.isEmpty() || FLAGS_size <= 0 || FLAGS_memoryBudgetMB <= 0 ||
+        (!FLAGS_out.isEmpty() && !sk_isdir(FLAGS_out[0]))) {
+        CommandLineFlags::PrintUsage();
+        return 1;
+    }
+
+    std::vector<SkString> paths;
+    const char* src = FLAGS_src[0];
+    if (sk_isdir(src)) {
+        SkOSFile::Iter iter(src);
+        for (SkString file; iter.next(&file); ) {
+            SkString path = SkOSPath::Join(src, file.c_str());
+            if (!sk_isdir(path.c_str())) {
+                paths.push_back(path);
+            }
+        }
+    } else {
+        paths.push_back(SkString(src));
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(FLAGS_threads);
+    MemoryBudget budget((size_t)FLAGS_memoryBudgetMB << 20);
+    std::vector<FileResult> results(paths.size() * std::max(1, FLAGS_repeat));
+
+    const double start = SkTime::GetMSecs();
+    {
+        SkTaskGroup group(*executor);
+        for (size_t i = 0; i < results.size(); i++) {
+            // Only the first pass writes, so repeats never race on the same output file.
+            group.add([&, i] {
+                make_thumbnail(paths[i % paths.size()], i < paths.size(), &budget, &results[i]);
+            });
+        }
+    }
+    const double wallMs = SkTime::GetMSecs() - start;
+
+    int failures = 0;
+    double totalMs[kStageCount] = {};
+    for (const FileResult& result : results) {
+        failures += result.fOk ? 0 : 1;
+        for (int stage = 0; stage < kStageCount; stage++) {
+            totalMs[stage] += result.fMs[stage];
+        }
+    }
+
+    SkDebugf("%zu files, %d failed, %.1fms wall clock", results.size(), failures, wallMs);
+    for (int stage = 0; stage < kStageCount; stage++) {
+        SkDebugf(", %s %.1fms", kStageNames[stage], totalMs[stage]);
+    }
+    SkDebugf("\n");
+
+    if (!FLAGS_json.isEmpty()) {
+        SkFILEWStream stream(FLAGS_json[0]);
+        if (!stream.isValid()) {
+            SkDebugf("Could not open %s for writing.\n", FLAGS_json[0]);
+            return 1;
+        }
+        SkJSONWriter writer(&stream, SkJSONWriter::Mode::kPretty);
+        writer.beginObject();
+        writer.appendCString("format", FLAGS_format[0]);
+        writer.appendS32("size", FLAGS_size);
+        writer.appendS32("threads", FLAGS_threads);
+        writer.appendS32("memory_budget_mb", FLAGS_memoryBudgetMB);
+        writer.appendDouble("wall_ms", wallMs);
+        writer.appendS32("failures", failures);
+        writer.beginObject("total_ms");
+        for (int stage = 0; stage < kStageCount; stage++) {
+            writer.appendDouble(kStageNames[stage], totalMs[stage]);
+        }
+        writer.endObject();
+        writer.beginArray("files");
+        for (const FileResult& result : results) {
+            writer.beginObject();
+            writer.appendString("path", result.fPath);
+            writer.appendBool("ok", result.fOk);
+            writer.appendS32("src_width", result.fSrcSize.width());
+            writer.appendS32("src_height", result.fSrcSize.height());
+            writer.appendS32("dst_width", result.fDstSize.width());
+            writer.appendS32("dst_height", result.fDstSize.height());
+            writer.appendS32("sample_size", result.fSampleSize);
+            writer.appendU64("encoded_bytes", (uint64_t)result.fEncodedBytes);
+            for (int stage = 0; stage < kStageCount; stage++) {
+                SkString name = SkStringPrintf("%s_ms", kStageNames[stage]);
+                writer.appendDouble(name.c_str(), result.fMs[stage]);
+            }
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+        writer.flush();
+    }
+
+    return failures ? 2 : 0;
+}
@@ -25,6 +25,7 @@
 static DEFINE_string2(skps, r, "", ".SKPs to dump.");
 static DEFINE_string(match, "", "The usual filters on file names to dump.");
 static DEFINE_bool2(optimize, O, false, "Run SkRecordOptimize before dumping.");
+static DEFINE_bool(extended, false, "With --optimize, also run the opt-in optimization passes.");
 static DEFINE_int(tile, 1000000000, "Simulated tile size.");
 static DEFINE_bool(timeWithCommand, false,
                    "If true, print time next to command, else in first column.");
@@ -169,7 +170,8 @@ int main(int argc, char** argv) {
         src->playback(&rec);
 
         if (FLAGS_optimize) {
-            SkRecordOptimize(&record);
+            SkRecordOptimize(&record, FLAGS_extended ? SkRecordExtendedOptimizationPasses()
+                                                     : SkRecordDefaultOptimizationPasses());
         }
 
         SkBitmap bitmap;
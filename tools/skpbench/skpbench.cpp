@@ -8,7 +8,9 @@
 #include "bench/BigPath.h"
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkJpegDecoder.h"
+#include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -20,6 +22,7 @@
 #include "include/gpu/ganesh/GrDirectContext.h"
 #include "include/gpu/ganesh/SkSurfaceGanesh.h"
 #include "include/private/chromium/GrDeferredDisplayList.h"
+#include "include/utils/SkTiledPlayback.h"
 #include "src/core/SkOSFile.h"
 #include "src/core/SkTaskGroup.h"
 #include "src/gpu/ganesh/GrCaps.h"
@@ -73,7 +76,9 @@
  * Well, maybe a little fanciness, MSKP's can be loaded and played. The animation is played as many
  * times as necessary to reach the target sample duration and FPS is reported.
  *
- * Currently, only GPU configs are supported.
+ * Currently, only GPU configs are supported. With --tiledPlayback the skp is instead drawn on the
+ * CPU with SkTiledPlayback, into a raster surface of the config's color type, so that comparing
+ * --tiledPlaybackThreads=1 against more threads measures the speedup from tile parallelism.
  */
 
 static DEFINE_bool(ddl, false, "record the skp into DDLs before rendering");
@@ -94,6 +99,11 @@ static DEFINE_int(verbosity, 4, "level of verbosity (0=none to 5=debug)");
 static DEFINE_bool(suppressHeader, false, "don't print a header row before the results");
 static DEFINE_double(scale, 1, "Scale the size of the canvas and the zoom level by this factor.");
 static DEFINE_bool(dumpSamples, false, "print the individual samples to stdout");
+static DEFINE_bool(tiledPlayback, false,
+                   "draw the skp on the CPU in tiles with SkTiledPlayback instead of on the GPU");
+static DEFINE_int(tiledPlaybackThreads, 0,
+                  "number of threads for --tiledPlayback (0=num_cores, 1=the main thread only)");
+static DEFINE_int(tiledPlaybackTileSize, 256, "tile width and height for --tiledPlayback");
 
 static const char header[] =
 "   accum    median       max       min   stddev  samples  sample_ms  clock  metric  config    bench";
@@ -147,6 +157,8 @@ static sk_sp<SkPicture> create_skp_from_svg(SkStream*, const char* filename);
 static bool mkdir_p(const SkString& name);
 static SkString         join(const CommandLineFlags::StringArray&);
 static void exitf(ExitErr, const char* format, ...);
+static void run_tiled_playback_benchmark(sk_sp<SkSurface>, const SkPicture*, const SkMatrix&,
+                                         std::vector<Sample>*);
 
 // An interface used by both static SKPs and animated SKPs
 class SkpProducer {
@@ -391,6 +403,55 @@ static void run_benchmark(GrDirectContext* context,
     context->submit(GrSyncCpu::kYes);
 }
 
+static void run_tiled_playback_benchmark(sk_sp<SkSurface> surface,
+                                         const SkPicture* skp,
+                                         const SkMatrix& matrix,
+                                         std::vector<Sample>* samples) {
+    using clock = std::chrono::high_resolution_clock;
+    const Sample::duration sampleDuration = std::chrono::milliseconds(FLAGS_sampleMs);
+    const clock::duration benchDuration = std::chrono::milliseconds(FLAGS_duration);
+
+    // Deserialized pictures have no bounding box hierarchy, so tiles could not cull.
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    skp->playback(recorder.beginRecording(skp->cullRect(), &factory));
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    std::unique_ptr<SkExecutor> executor;
+    if (FLAGS_tiledPlaybackThreads != 1) {
+        executor = SkExecutor::MakeFIFOThreadPool(FLAGS_tiledPlaybackThreads, false);
+    }
+    SkTiledPlayback::Options options;
+    options.fTileSize = {FLAGS_tiledPlaybackTileSize, FLAGS_tiledPlaybackTileSize};
+    options.fExecutor = executor.get();
+
+    auto draw = [&] {
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        if (!SkTiledPlayback::Draw(surface.get(), picture.get(), matrix, options)) {
+            exitf(ExitErr::kSoftware, "SkTiledPlayback::Draw failed");
+        }
+    };
+    for (int i = 0; i < kNumFlushesToPrimeCache; ++i) {
+        draw();
+    }
+
+    clock::time_point now = clock::now();
+    const clock::time_point endTime = now + benchDuration;
+
+    do {
+        clock::time_point sampleStart = now;
+        samples->emplace_back();
+        Sample& sample = samples->back();
+
+        do {
+            draw();
+            sample.fFrames++;
+            now = clock::now();
+            sample.fDuration = now - sampleStart;
+        } while (sample.fDuration < sampleDuration);
+    } while (now < endTime || 0 == samples->size() % 2);
+}
+
 static void run_gpu_time_benchmark(sk_gpu_test::GpuTimer* gpuTimer,
                                    GrDirectContext* context,
                                    sk_sp<SkSurface> surface,
@@ -582,6 +643,45 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (FLAGS_tiledPlayback) {
+        if (FLAGS_tiledPlaybackTileSize <= 0 || FLAGS_tiledPlaybackThreads < 0) {
+            exitf(ExitErr::kUsage, "invalid --tiledPlaybackTileSize or --tiledPlaybackThreads");
+        }
+        if (mskp) {
+            exitf(ExitErr::kUnavailable, "tiled playback: mskp files not supported");
+        }
+        SkImageInfo info = SkImageInfo::Make(width, height, config->getColorType(),
+                                             config->getAlphaType(), config->refColorSpace());
+        SkSurfaceProps props(config->getSurfaceFlags(), kRGB_H_SkPixelGeometry);
+        sk_sp<SkSurface> surface = SkSurfaces::Raster(info, &props);
+        if (!surface) {
+            exitf(ExitErr::kUnavailable, "failed to create %ix%i raster surface for config %s",
+                                         width, height, config->getTag().c_str());
+        }
+        SkMatrix matrix = SkMatrix::Scale(FLAGS_scale, FLAGS_scale);
+        matrix.preTranslate(-skp->cullRect().x(), -skp->cullRect().y());
+
+        std::vector<Sample> samples;
+        run_tiled_playback_benchmark(surface, skp.get(), matrix, &samples);
+        SkString tag = SkStringPrintf("tiled%d", FLAGS_tiledPlaybackThreads);
+        print_result(samples, tag.c_str(), srcname.c_str());
+
+        if (!FLAGS_png.isEmpty()) {
+            SkBitmap bmp;
+            bmp.allocPixels(info);
+            if (!surface->readPixels(bmp, 0, 0)) {
+                exitf(ExitErr::kUnavailable, "failed to read surface pixels for png");
+            }
+            if (!mkdir_p(SkOSPath::Dirname(FLAGS_png[0]))) {
+                exitf(ExitErr::kIO, "failed to create directory for png \"%s\"", FLAGS_png[0]);
+            }
+            if (!ToolUtils::EncodeImageToPngFile(FLAGS_png[0], bmp)) {
+                exitf(ExitErr::kIO, "failed to save png to \"%s\"", FLAGS_png[0]);
+            }
+        }
+        return 0;
+    }
+
     if (config->getSurfType() != SkCommandLineConfigGpu::SurfType::kDefault) {
         exitf(ExitErr::kUnavailable, "This tool only supports the default surface type. (%s)",
               config->getTag().c_str());
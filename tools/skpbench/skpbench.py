@@ -83,6 +83,14 @@ __argparse.add_argument('--ddlNumRecordingThreads',
   help="number of DDL recording threads (0=num_cores)")
 __argparse.add_argument('--ddlTilingWidthHeight',
   type=int, default=0, help="number of tiles along one edge when in DDL mode")
+__argparse.add_argument('--tiledPlayback',
+  action='store_true',
+  help="draw on the CPU in tiles with SkTiledPlayback instead of on the GPU")
+__argparse.add_argument('--tiledPlaybackThreads',
+  type=int, default=0,
+  help="number of tiled playback threads (0=num_cores, 1=main thread only)")
+__argparse.add_argument('--tiledPlaybackTileSize',
+  type=int, default=0, help="tile width and height when in tiled playback mode")
 __argparse.add_argument('--dontReduceOpsTaskSplitting',
   action='store_true', help="don't reorder GPU tasks to reduce render target swaps")
 __argparse.add_argument('--gpuThreads',
@@ -167,6 +175,14 @@ class SKPBench:
   if FLAGS.ddlTilingWidthHeight:
     ARGV.extend(['--ddlTilingWidthHeight', str(FLAGS.ddlTilingWidthHeight)])
 
+  # Tiled playback parameters
+  if FLAGS.tiledPlayback:
+    ARGV.extend(['--tiledPlayback', 'true'])
+  if FLAGS.tiledPlaybackThreads:
+    ARGV.extend(['--tiledPlaybackThreads', str(FLAGS.tiledPlaybackThreads)])
+  if FLAGS.tiledPlaybackTileSize:
+    ARGV.extend(['--tiledPlaybackTileSize', str(FLAGS.tiledPlaybackTileSize)])
+
   if FLAGS.dontReduceOpsTaskSplitting:
     ARGV.extend(['--dontReduceOpsTaskSplitting'])
 